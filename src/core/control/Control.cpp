@@ -21,6 +21,7 @@
 #include "control/ToolHandler.h"                                 // for Tool...
 #include "control/actions/ActionDatabase.h"                      // for Acti...
 #include "control/jobs/AutosaveJob.h"                            // for Auto...
+#include "control/jobs/AutosaveJournal.h"                        // for Auto...
 #include "control/jobs/BaseExportJob.h"                          // for Base...
 #include "control/jobs/CustomExportJob.h"                        // for Cust...
 #include "control/jobs/PdfExportJob.h"                           // for PdfE...
@@ -167,6 +168,7 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath, bool di
     this->changeTimout = g_timeout_add_seconds(5, xoj::util::wrap_v<checkChangedDocument>, this);
 
     this->pageBackgroundChangeController = std::make_unique<PageBackgroundChangeController>(this);
+    this->autosaveJournal = std::make_unique<AutosaveJournal>(this);
 
     this->layerController = new LayerController(this);
     this->layerController->registerListener(this);
@@ -242,6 +244,9 @@ void Control::deleteLastAutosaveFile() {
         if (fs::exists(this->lastAutosaveFilename)) {
             fs::remove(this->lastAutosaveFilename);
         }
+        if (!this->lastAutosaveFilename.empty()) {
+            fs::remove(AutosaveJournal::getJournalPath(this->lastAutosaveFilename));
+        }
     } catch (const fs::filesystem_error& e) {
         auto fmtstr = FS(_F("Could not remove old autosave file \"{1}\": {2}") % this->lastAutosaveFilename.u8string() %
                          e.what());
@@ -1132,6 +1137,10 @@ void Control::undoRedoChanged() {
 }
 
 void Control::undoRedoPageChanged(PageRef page) {
+    // The undo actions may modify layers without going through the page
+    page->markChanged();
+    this->autosaveJournal->pageContentChanged(page);
+
     if (std::find(begin(this->changedPages), end(this->changedPages), page) == end(this->changedPages)) {
         this->changedPages.emplace_back(std::move(page));
     }
@@ -1543,6 +1552,11 @@ void Control::replaceDocument(std::unique_ptr<Document> doc, int scrollToPage) {
 
 void Control::openXoppFile(fs::path filepath, int scrollToPage, std::function<void(bool)> callback) {
     LoadHandler loadHandler;
+    loadHandler.setLazyLoading(this->settings->isLoadPagesOnDemand());
+    loadHandler.setScheduler(this->scheduler);
+    loadHandler.setLazyLoadingErrorHandler([win = getGtkWindow()](const std::string& msg) {
+        Util::execInUiThread([win, msg]() { XojMsgBox::showErrorToUser(win, msg); });
+    });
     std::unique_ptr<Document> doc(loadHandler.loadDocument(filepath));
 
     if (!doc) {
@@ -1567,7 +1581,7 @@ void Control::openXoppFile(fs::path filepath, int scrollToPage, std::function<vo
         }
     };
 
-    if (loadHandler.getFileVersion() > FILE_FORMAT_VERSION) {
+    if (loadHandler.getFileVersion() > std::max(FILE_FORMAT_VERSION, BINARY_FILE_FORMAT_VERSION)) {
         enum { YES = 1, NO };
         std::vector<XojMsgBox::Button> buttons = {{_("Yes"), YES}, {_("No"), NO}};
         XojMsgBox::askQuestion(
@@ -2562,6 +2576,8 @@ auto Control::getPageBackgroundChangeController() const -> PageBackgroundChangeC
     return this->pageBackgroundChangeController.get();
 }
 
+auto Control::getAutosaveJournal() const -> AutosaveJournal* { return this->autosaveJournal.get(); }
+
 auto Control::getLayerController() const -> LayerController* { return this->layerController; }
 
 auto Control::getPluginController() const -> PluginController* { return this->pluginController; }
@@ -50,6 +50,7 @@ class ToolbarDragDropHandler;
 class MetadataEntry;
 class MetadataCallbackData;
 class PageBackgroundChangeController;
+class AutosaveJournal;
 class PageTypeHandler;
 class BaseExportJob;
 class LayerController;
@@ -293,6 +294,7 @@ public:
 
     void setLastAutosaveFile(fs::path newAutosaveFile);
     void deleteLastAutosaveFile();
+    AutosaveJournal* getAutosaveJournal() const;
     void setClipboardHandlerSelection(EditSelection* selection);
 
     void addChangedDocumentListener(DocumentListener* dl);
@@ -550,6 +552,8 @@ private:
 
     std::unique_ptr<PageBackgroundChangeController> pageBackgroundChangeController;
 
+    std::unique_ptr<AutosaveJournal> autosaveJournal;
+
     LayerController* layerController;
 
     std::unique_ptr<GeometryTool> geometryTool;
@@ -1,11 +1,14 @@
 #include "PdfCache.h"
 
-#include <algorithm>  // for max
-#include <cmath>      // for ceil, abs
-#include <cstdio>     // for size_t
-#include <memory>     // for shared_ptr, __shared_ptr_access
-#include <string>     // for string
-#include <utility>    // for move
+#include <algorithm>   // for max
+#include <cmath>       // for ceil, abs, floor, log
+#include <cstdio>      // for size_t
+#include <exception>   // for current_exception
+#include <functional>  // for hash
+#include <future>      // for promise, shared_future
+#include <memory>      // for shared_ptr, make_shared
+#include <string>      // for string
+#include <utility>     // for move
 
 #include <glib.h>  // for g_warning
 
@@ -13,7 +16,6 @@
 #include "pdf/base/XojPdfDocument.h"    // for XojPdfDocument
 #include "util/Range.h"                 // for Range
 #include "util/i18n.h"                  // for _
-#include "util/safe_casts.h"            // for as_unsigned
 #include "view/Mask.h"                  // for Mask
 
 class PdfCacheEntry {
@@ -29,14 +31,43 @@ public:
      * @param buffer is the result of rendering popplerPage
      */
     PdfCacheEntry(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer):
-            popplerPage(std::move(popplerPage)), buffer(std::forward<xoj::view::Mask>(buffer)) {}
+            popplerPage(std::move(popplerPage)), buffer(std::forward<xoj::view::Mask>(buffer)) {
+        cairo_surface_t* surface = cairo_get_target(this->buffer.get());
+        this->size = static_cast<size_t>(cairo_image_surface_get_stride(surface)) *
+                     static_cast<size_t>(cairo_image_surface_get_height(surface));
+    }
 
     ~PdfCacheEntry() = default;
 
     XojPdfPageSPtr popplerPage;
     xoj::view::Mask buffer;
+
+    /// The memory used by the buffer, in bytes
+    size_t size;
 };
 
+/// The zoom levels of the renderings of a page sharing a cache entry span this factor
+static constexpr double ZOOM_BUCKET_RATIO = 1.5;
+
+/// How many buckets away from the requested one a draft rendering is looked for
+static constexpr int MAX_DRAFT_BUCKET_DISTANCE = 8;
+
+namespace {
+/// Calls a function when going out of scope, in particular when an exception is thrown
+template <class F>
+class ScopeGuard {
+public:
+    explicit ScopeGuard(F f): f(std::move(f)) {}
+    ~ScopeGuard() { f(); }
+
+    ScopeGuard(const ScopeGuard&) = delete;
+    ScopeGuard& operator=(const ScopeGuard&) = delete;
+
+private:
+    F f;
+};
+}  // namespace
+
 PdfCache::PdfCache(const XojPdfDocument& doc, Settings* settings): pdfDocument(doc) { updateSettings(settings); }
 
 PdfCache::~PdfCache() = default;
@@ -44,48 +75,101 @@ PdfCache::~PdfCache() = default;
 void PdfCache::setRefreshThreshold(double threshold) { this->zoomRefreshThreshold = threshold; }
 
 void PdfCache::setMaxSize(size_t newSize) {
+    std::lock_guard<std::mutex> lock(this->renderMutex);
     this->maxSize = newSize;
-    if (this->data.size() > this->maxSize) {
-        this->data.resize(this->maxSize);
-    }
+    shrinkTo(this->maxSize);
+}
+
+auto PdfCache::getSize() const -> size_t {
+    std::lock_guard<std::mutex> lock(this->renderMutex);
+    return this->size;
+}
+
+auto PdfCache::getStatistics() const -> Statistics {
+    std::lock_guard<std::mutex> lock(this->renderMutex);
+    return this->statistics;
 }
 
 void PdfCache::updateSettings(Settings* settings) {
     if (settings) {
-        setMaxSize(as_unsigned(settings->getPdfPageCacheSize()));
+        setMaxSize(size_t{settings->getPdfCacheSize()} * 1024 * 1024);
         setRefreshThreshold(settings->getPDFPageRerenderThreshold());
     }
 }
 
-auto PdfCache::lookup(size_t pdfPageNo) const -> const PdfCacheEntry* {
-    for (auto& e: this->data) {
-        if (static_cast<size_t>(e->popplerPage->getPageId()) == pdfPageNo) {
-            return e.get();
-        }
+auto PdfCache::getZoomBucket(double zoom) -> int {
+    return static_cast<int>(std::floor(std::log(zoom) / std::log(ZOOM_BUCKET_RATIO)));
+}
+
+auto PdfCache::lookup(size_t pdfPageNo, int zoomBucket) -> std::shared_ptr<const PdfCacheEntry> {
+    auto it = this->index.find({pdfPageNo, zoomBucket});
+    if (it == this->index.end()) {
+        return nullptr;
     }
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return it->second->second;
+}
 
+auto PdfCache::lookupClosest(size_t pdfPageNo, int zoomBucket) -> std::shared_ptr<const PdfCacheEntry> {
+    for (int distance = 0; distance <= MAX_DRAFT_BUCKET_DISTANCE; distance++) {
+        // Prefer the sharper rendering
+        if (auto entry = lookup(pdfPageNo, zoomBucket + distance); entry) {
+            return entry;
+        }
+        if (auto entry = lookup(pdfPageNo, zoomBucket - distance); entry) {
+            return entry;
+        }
+    }
     return nullptr;
 }
 
-auto PdfCache::cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer) -> const PdfCacheEntry* {
-    if (this->data.size() > this->maxSize) {
-        this->data.resize(this->maxSize);
+auto PdfCache::cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer, int zoomBucket)
+        -> std::shared_ptr<const PdfCacheEntry> {
+    Key key{static_cast<size_t>(popplerPage->getPageId()), zoomBucket};
+    if (auto it = this->index.find(key); it != this->index.end()) {
+        this->size -= it->second->second->size;
+        this->entries.erase(it->second);
+        this->index.erase(it);
     }
 
-    this->data.emplace_front(
-            std::make_unique<PdfCacheEntry>(std::move(popplerPage), std::forward<xoj::view::Mask>(buffer)));
+    auto entry = std::make_shared<const PdfCacheEntry>(std::move(popplerPage), std::forward<xoj::view::Mask>(buffer));
+    // The budget may be exceeded by the last rendering added
+    shrinkTo(this->maxSize > entry->size ? this->maxSize - entry->size : 0);
 
-    return this->data.front().get();
+    this->size += entry->size;
+    this->entries.emplace_front(key, entry);
+    this->index.emplace(key, this->entries.begin());
+    return entry;
 }
 
-void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight) {
-    std::lock_guard<std::mutex> lock(this->renderMutex);
+void PdfCache::shrinkTo(size_t size) {
+    while (this->size > size && !this->entries.empty()) {
+        auto& [key, entry] = this->entries.back();
+        this->size -= entry->size;
+        this->index.erase(key);
+        this->entries.pop_back();
+        this->statistics.evictions++;
+    }
+}
+
+auto PdfCache::KeyHash::operator()(const Key& key) const -> size_t {
+    return std::hash<size_t>{}(key.pdfPageNo) * 31 + std::hash<int>{}(key.zoomBucket);
+}
 
-    const PdfCacheEntry* cacheResult = lookup(pdfPageNo);
+template <class CreateBuffer>
+auto PdfCache::getRendering(size_t pdfPageNo, double zoom, bool draft, CreateBuffer createBuffer)
+        -> std::shared_ptr<const PdfCacheEntry> {
+    std::unique_lock<std::mutex> lock(this->renderMutex);
+
+    double renderZoom = std::max(zoom, 1.0);
+    const int zoomBucket = getZoomBucket(renderZoom);
+
+    std::shared_ptr<const PdfCacheEntry> cacheResult =
+            draft ? lookupClosest(pdfPageNo, zoomBucket) : lookup(pdfPageNo, zoomBucket);
 
     bool needsRefresh = cacheResult == nullptr;
 
-    if (!needsRefresh) {
+    if (!needsRefresh && !draft) {
         double averagedZoom = (zoom + cacheResult->buffer.getZoom()) / 2.0;
         double percentZoomChange = std::abs(cacheResult->buffer.getZoom() - zoom) * 100.0 / averagedZoom;
 
@@ -94,26 +178,101 @@ void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWid
         needsRefresh = (zoom > 1.0 && percentZoomChange > this->zoomRefreshThreshold);
     }
 
-    if (needsRefresh) {
-        double renderZoom = std::max(zoom, 1.0);
+    if (!needsRefresh) {
+        this->statistics.hits++;
+        return cacheResult;
+    }
 
-        auto popplerPage = cacheResult ? cacheResult->popplerPage : pdfDocument.getPage(pdfPageNo);
+    const Key key{pdfPageNo, zoomBucket};
+    if (auto it = this->inFlight.find(key); it != this->inFlight.end()) {
+        // Someone else is rendering the page: wait for the result instead of rendering it too
+        auto result = it->second;
+        this->statistics.hits++;
+        lock.unlock();
+        try {
+            return result.get();
+        } catch (...) {
+            // The thread rendering the page has reported the error: the page is drawn as missing
+            return nullptr;
+        }
+    }
 
-        if (!popplerPage) {
-            g_warning("PdfCache::render Could not get the pdf page %zu from the document", pdfPageNo);
-            renderMissingPdfPage(cr, pageWidth, pageHeight);
-            return;
+    this->statistics.misses++;
+    std::promise<std::shared_ptr<const PdfCacheEntry>> promise;
+    this->inFlight.emplace(key, promise.get_future().share());
+    // Erases the entry whatever happens below, so that the page is rendered again by the next request
+    ScopeGuard eraseInFlight([this, &lock, &key]() {
+        if (!lock.owns_lock()) {
+            lock.lock();
         }
+        this->inFlight.erase(key);
+        lock.unlock();
+    });
+
+    try {
+        auto popplerPage = pdfDocument.getPage(pdfPageNo);
+        lock.unlock();
 
-        xoj::view::Mask buffer(cairo_get_target(cr), Range(0, 0, popplerPage->getWidth(), popplerPage->getHeight()),
-                               renderZoom, CAIRO_CONTENT_COLOR_ALPHA);
-        popplerPage->render(buffer.get());
-        cacheResult = cache(popplerPage, std::move(buffer));
+        // The cache is not locked while rendering: the other threads may use the cached renderings meanwhile. The
+        // renderings themselves are serialized by the PDF document, which is not thread-safe.
+        if (popplerPage) {
+            xoj::view::Mask buffer =
+                    createBuffer(Range(0, 0, popplerPage->getWidth(), popplerPage->getHeight()), renderZoom);
+            popplerPage->render(buffer.get());
+
+            lock.lock();
+            cacheResult = cache(std::move(popplerPage), std::move(buffer), zoomBucket);
+            lock.unlock();
+        } else {
+            cacheResult = nullptr;
+        }
+    } catch (...) {
+        g_warning("PdfCache: could not render the pdf page %zu", pdfPageNo);
+        // The threads waiting for the rendering get the exception too, instead of waiting forever
+        promise.set_exception(std::current_exception());
+        return nullptr;
     }
+    promise.set_value(cacheResult);
+    return cacheResult;
+}
 
+void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight, bool draft) {
+    cairo_surface_t* target = cairo_get_target(cr);
+    auto cacheResult = getRendering(pdfPageNo, zoom, draft, [target](const Range& extent, double z) {
+        return xoj::view::Mask(target, extent, z, CAIRO_CONTENT_COLOR_ALPHA);
+    });
+
+    if (!cacheResult) {
+        g_warning("PdfCache::render Could not get the pdf page %zu from the document", pdfPageNo);
+        renderMissingPdfPage(cr, pageWidth, pageHeight);
+        return;
+    }
     cacheResult->buffer.paintTo(cr);
 }
 
+auto PdfCache::prefetch(size_t pdfPageNo, double zoom, int DPIScaling) -> bool {
+    {
+        std::lock_guard<std::mutex> lock(this->renderMutex);
+        auto popplerPage = pdfDocument.getPage(pdfPageNo);
+        if (!popplerPage) {
+            return true;
+        }
+        // Only fill the free space: the renderings in use are not evicted
+        const double pixelsPerPageUnit = std::max(zoom, 1.0) * DPIScaling;
+        const auto estimatedSize = static_cast<size_t>(std::ceil(popplerPage->getWidth() * pixelsPerPageUnit) *
+                                                       std::ceil(popplerPage->getHeight() * pixelsPerPageUnit) * 4);
+        if (this->index.find({pdfPageNo, getZoomBucket(std::max(zoom, 1.0))}) == this->index.end() &&
+            this->size + estimatedSize > this->maxSize) {
+            return false;
+        }
+    }
+
+    getRendering(pdfPageNo, zoom, false, [DPIScaling](const Range& extent, double z) {
+        return xoj::view::Mask(DPIScaling, extent, z, CAIRO_CONTENT_COLOR_ALPHA);
+    });
+    return true;
+}
+
 void PdfCache::renderMissingPdfPage(cairo_t* cr, double pageWidth, double pageHeight) {
     cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
     cairo_set_font_size(cr, 26);
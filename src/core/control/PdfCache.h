@@ -11,9 +11,14 @@
 
 #pragma once
 
-#include <cstddef>  // for size_t
-#include <deque>    // for deque
-#include <mutex>    // for mutex
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t
+#include <future>         // for shared_future
+#include <list>           // for list
+#include <memory>         // for shared_ptr
+#include <mutex>          // for mutex
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
 
 #include <cairo.h>  // for cairo_t, cairo_surface_t
 
@@ -27,7 +32,24 @@ class Mask;
 class PdfCacheEntry;
 class Settings;
 
+/**
+ * Keeps the rendered pdf pages, as long as their total size fits in the budget. The least recently used renderings
+ * are evicted first.
+ *
+ * A page may be cached at several zoom levels (e.g. a thumbnail and a full-size rendering): the renderings are
+ * identified by the page and a zoom bucket, each bucket spanning a factor ZOOM_BUCKET_RATIO of zoom levels.
+ */
 class PdfCache {
+public:
+    struct Statistics {
+        /// A cached rendering was used
+        uint64_t hits = 0;
+        /// The page was rendered
+        uint64_t misses = 0;
+        /// A rendering was dropped to fit in the budget
+        uint64_t evictions = 0;
+    };
+
 public:
     PdfCache(const XojPdfDocument& doc, Settings* settings);
     virtual ~PdfCache();
@@ -43,8 +65,17 @@ public:
      * @param pdfPageNo The page number (in the pdf document)
      * @param zoom The current zoom level
      * @param pageWidth/pageHeight Xournal++ page dimensions
+     * @param draft If true, any cached version of the page is used, whatever the zoom level it was rendered at
      */
-    void render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight);
+    void render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight, bool draft = false);
+
+    /**
+     * @brief Render the page with number pdfPageNo of the pdf document ahead of time, unless it is cached already
+     * @param zoom The zoom level the page will be painted at
+     * @param DPIScaling The scaling of the surfaces the page will be painted on
+     * @return false if the rendering would not fit in the free part of the budget, in which case nothing is done
+     */
+    bool prefetch(size_t pdfPageNo, double zoom, int DPIScaling);
 
 public:
     /**
@@ -56,8 +87,18 @@ public:
      */
     void setRefreshThreshold(double percentDifference);
 
+    /**
+     * @param newSize The budget in bytes
+     */
     void setMaxSize(size_t newSize);
 
+    /**
+     * @return The size of the cached renderings in bytes
+     */
+    size_t getSize() const;
+
+    Statistics getStatistics() const;
+
     void updateSettings(Settings* settings);
 
     /**
@@ -66,22 +107,68 @@ public:
     static void renderMissingPdfPage(cairo_t* cr, double pageWidth, double pageHeight);
 
 private:
+    struct Key {
+        size_t pdfPageNo = 0;
+        int zoomBucket = 0;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    static int getZoomBucket(double zoom);
+
+    /**
+     * @brief Get the rendering of the page from the cache, or render it (only once if several threads need it)
+     * @param createBuffer Creates the mask the page is rendered to, from the extent of the page and the zoom level
+     * @return The rendering, or nullptr if the page cannot be rendered
+     */
+    template <class CreateBuffer>
+    std::shared_ptr<const PdfCacheEntry> getRendering(size_t pdfPageNo, double zoom, bool draft,
+                                                      CreateBuffer createBuffer);
+
     /**
-     * @brief Look up for a cache entry for the page with number pdfPgeNo in the PDF.
+     * @brief Look up for a cache entry for the page with number pdfPgeNo in the PDF, rendered at a zoom level in the
+     * given bucket. The entry becomes the most recently used one.
      */
-    const PdfCacheEntry* lookup(size_t pdfPageNo) const;
+    std::shared_ptr<const PdfCacheEntry> lookup(size_t pdfPageNo, int zoomBucket);
+
+    /**
+     * @brief Look up for a cache entry for the page, rendered at the zoom level closest to the bucket
+     */
+    std::shared_ptr<const PdfCacheEntry> lookupClosest(size_t pdfPageNo, int zoomBucket);
+
     /**
-     * @brief Push a cache entry
+     * @brief Push a cache entry, replacing the one with the same key if any
      */
-    const PdfCacheEntry* cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer);
+    std::shared_ptr<const PdfCacheEntry> cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer, int zoomBucket);
+
+    /**
+     * @brief Evict the least recently used entries until the cache fits in the given size
+     */
+    void shrinkTo(size_t size);
 
 private:
     XojPdfDocument pdfDocument;
 
-    std::mutex renderMutex;
+    /// Protects the entries, not the renderings: the pages are rendered and painted without holding it
+    mutable std::mutex renderMutex;
+
+    using Entry = std::pair<Key, std::shared_ptr<const PdfCacheEntry>>;
+
+    /// Most recently used first
+    std::list<Entry> entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+    /// The renderings in progress, for the other requests of the same page and zoom bucket to wait for
+    std::unordered_map<Key, std::shared_future<std::shared_ptr<const PdfCacheEntry>>, KeyHash> inFlight;
+
+    size_t size = 0;
+    size_t maxSize = 0;
 
-    std::deque<std::unique_ptr<PdfCacheEntry>> data;
-    decltype(data)::size_type maxSize = 0;
+    Statistics statistics;
 
-    double zoomRefreshThreshold;
+    double zoomRefreshThreshold = 0.0;
 };
@@ -457,7 +457,7 @@ void on_startup(GApplication* application, XMPtr app_data) {
     app_data->control->openFileWithoutSavingTheCurrentDocument(
             std::move(p), app_data->attachMode, app_data->openAtPageNumber - 1,
             [ctrl = app_data->control.get(), app = GTK_APPLICATION(application)](bool) {
-                ctrl->getScheduler()->start();
+                ctrl->getScheduler()->start(ctrl->getSettings()->getRenderThreads());
 
                 checkForEmergencySave(ctrl);
 
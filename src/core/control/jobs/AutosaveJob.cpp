@@ -2,14 +2,17 @@
 
 #include <glib.h>  // for g_message, g_warning
 
-#include "control/Control.h"              // for Control
-#include "control/jobs/Job.h"             // for JOB_TYPE_AUTOSAVE, JobType
-#include "control/xojfile/SaveHandler.h"  // for SaveHandler
-#include "model/Document.h"               // for Document
-#include "undo/UndoRedoHandler.h"         // for UndoRedoHandler
-#include "util/PathUtil.h"                // for clearExtensions, getAutosav...
-#include "util/XojMsgBox.h"               // for XojMsgBox
-#include "util/i18n.h"                    // for FS, _F
+#include "control/Control.h"               // for Control
+#include "control/jobs/AutosaveJournal.h"  // for AutosaveJournal
+#include "control/jobs/Job.h"              // for JOB_TYPE_AUTOSAVE, JobType
+#include "control/settings/Settings.h"     // for Settings
+#include "control/xojfile/SaveHandler.h"   // for SaveHandler
+#include "model/Document.h"                // for Document
+#include "model/DocumentHandler.h"         // for DocumentHandler
+#include "undo/UndoRedoHandler.h"          // for UndoRedoHandler
+#include "util/PathUtil.h"                 // for clearExtensions, getAutosav...
+#include "util/XojMsgBox.h"                // for XojMsgBox
+#include "util/i18n.h"                     // for FS, _F
 
 #include "filesystem.h"  // for path
 
@@ -24,10 +27,12 @@ void AutosaveJob::afterRun() {
 
 void AutosaveJob::run() {
     SaveHandler handler;
+    handler.setBinaryStrokes(control->getSettings()->isSaveBinaryStrokes());
 
     control->getUndoRedoHandler()->documentAutosaved();
 
     Document* doc = control->getDocument();
+    AutosaveJournal* journal = control->getAutosaveJournal();
 
     doc->lock();
     auto filepath = doc->getFilepath();
@@ -40,17 +45,37 @@ void AutosaveJob::run() {
     Util::clearExtensions(filepath);
     filepath += ".autosave.xopp";
 
-    handler.prepareSave(doc, filepath);
-    doc->unlock();
+    // Only append the changed pages to the journal, if possible
+    std::string record;
+    if (journal->writeRecord(doc, filepath, record)) {
+        doc->unlock();
+
+        auto journalPath = AutosaveJournal::getJournalPath(filepath);
+        g_message("%s", FS(_F("Autosaving changed pages to {1}") % journalPath.string()).c_str());
+        this->error = journal->appendRecord(filepath, record);
+        if (!this->error.empty()) {
+            callAfterRun();
+        }
+        return;
+    }
 
     g_message("%s", FS(_F("Autosaving to {1}") % filepath.string()).c_str());
 
     fs::path tempfile = filepath;
     tempfile += u8"~";
+
+    // Serialize a snapshot, so that the document is not locked while writing
+    DocumentHandler snapshotHandler;
+    auto snapshot = doc->createSnapshot(&snapshotHandler);
+    journal->documentSaved(doc, filepath);
+    doc->unlock();
+
+    handler.prepareSave(snapshot.get(), filepath);
     handler.saveTo(tempfile);
 
     this->error = handler.getErrorMessage();
     if (!this->error.empty()) {
+        journal->invalidate();
         callAfterRun();
     } else {
         try {
@@ -64,8 +89,10 @@ void AutosaveJob::run() {
             } else {
                 Util::safeRenameFile(tempfile, filepath);
             }
+            journal->autosaveFileReplaced(filepath);
             control->setLastAutosaveFile(filepath);
         } catch (const fs::filesystem_error& e) {
+            journal->invalidate();
             auto fmtstr = _F("Could not rename autosave file from \"{1}\" to \"{2}\": {3}");
             this->error = FS(fmtstr % tempfile.u8string() % filepath.u8string() % e.what());
         }
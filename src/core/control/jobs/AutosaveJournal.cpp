@@ -0,0 +1,188 @@
+#include "AutosaveJournal.h"
+
+#include <algorithm>     // for find, sort, unique
+#include <system_error>  // for error_code
+
+#include "control/Control.h"              // for Control
+#include "control/xojfile/SaveHandler.h"  // for SaveHandler
+#include "model/Document.h"               // for Document
+#include "model/Layer.h"                  // for Layer
+#include "model/XojPage.h"                // for XojPage
+#include "util/OutputStream.h"            // for GzOutputStream, StringOutputStream
+#include "util/Util.h"                    // for npos
+
+AutosaveJournal::PageHeader::PageHeader(const XojPage& page):
+        width(page.getWidth()),
+        height(page.getHeight()),
+        type(page.getBackgroundType()),
+        pdfPage(page.getPdfPageNr()),
+        color(page.getBackgroundColor()),
+        image(page.getBackgroundImage()),
+        name(page.backgroundHasName() ? page.getBackgroundName() : std::string()) {}
+
+AutosaveJournal::LayerNames::LayerNames(const XojPage& page): revision(page.getRevision()) {
+    if (!page.isLoaded()) {
+        return;
+    }
+    names.emplace();
+    for (const Layer* l: page.getLayersView()) {
+        names->push_back(l->hasName() ? l->getName() : std::string());
+    }
+}
+
+AutosaveJournal::AutosaveJournal(Control* control): control(control) { registerListener(control); }
+
+AutosaveJournal::~AutosaveJournal() = default;
+
+void AutosaveJournal::pageContentChanged(const PageRef& page) {
+    std::lock_guard lock(this->mutex);
+    if (std::find(this->changedPages.begin(), this->changedPages.end(), page) == this->changedPages.end()) {
+        this->changedPages.push_back(page);
+    }
+}
+
+auto AutosaveJournal::writeRecord(Document* doc, const fs::path& autosaveFile, std::string& record) -> bool {
+    std::lock_guard lock(this->mutex);
+    std::vector<PageRef> pages = std::move(this->changedPages);
+    this->changedPages.clear();
+
+    // Changes which cannot be attributed to a page also need the whole document
+    if (this->fullSaveNeeded || autosaveFile != this->autosaveFile || this->baseId.empty() ||
+        doc->getPageCount() != this->pageHeaders.size()) {
+        return false;
+    }
+
+    // The autosave file was replaced or removed meanwhile
+    if (getBaseId(autosaveFile) != this->baseId) {
+        return false;
+    }
+
+    // Fold the journal back in once it gets too large
+    std::error_code ec;
+    auto journalSize = fs::file_size(getJournalPath(autosaveFile), ec);
+    if (!ec && journalSize > this->autosaveFileSize / 2) {
+        return false;
+    }
+
+    std::vector<size_t> pageIds;
+    pageIds.reserve(pages.size());
+    for (const PageRef& page: pages) {
+        size_t id = doc->indexOf(page);
+        if (id == npos) {
+            return false;
+        }
+        pageIds.push_back(id);
+    }
+
+    // Catch the edits which were not reported, e.g. renaming a layer
+    for (size_t id = 0; id < this->pageHeaders.size(); id++) {
+        ConstPageRef page = doc->getPage(id);
+        if (!(PageHeader(*page) == this->pageHeaders[id])) {
+            return false;
+        }
+        // The pages which were not edited, in particular those which are not loaded, are not parsed for this
+        if (page->getRevision() != this->layerNames[id].revision &&
+            LayerNames(*page).names != this->layerNames[id].names) {
+            pageIds.push_back(id);
+        }
+    }
+    if (pageIds.empty()) {
+        return false;
+    }
+    std::sort(pageIds.begin(), pageIds.end());
+    pageIds.erase(std::unique(pageIds.begin(), pageIds.end()), pageIds.end());
+
+    SaveHandler handler;
+    StringOutputStream out;
+    handler.writeJournalRecord(&out, doc, pageIds, this->baseId);
+    record = out.getString();
+
+    for (size_t id: pageIds) {
+        this->layerNames[id] = LayerNames(*doc->getPage(id));
+    }
+    return true;
+}
+
+auto AutosaveJournal::appendRecord(const fs::path& autosaveFile, const std::string& record) -> std::string {
+    GzOutputStream out(getJournalPath(autosaveFile), true);
+    if (out.getLastError().empty()) {
+        out.write(record);
+        out.close();
+    }
+
+    if (!out.getLastError().empty()) {
+        // The journal may end with a partial record now
+        invalidate();
+    }
+    return out.getLastError();
+}
+
+void AutosaveJournal::documentSaved(const Document* doc, const fs::path& autosaveFile) {
+    std::lock_guard lock(this->mutex);
+    this->changedPages.clear();
+    this->fullSaveNeeded = false;
+    this->autosaveFile = autosaveFile;
+    this->baseId.clear();
+
+    this->pageHeaders.clear();
+    this->layerNames.clear();
+    size_t pageCount = doc->getPageCount();
+    this->pageHeaders.reserve(pageCount);
+    this->layerNames.reserve(pageCount);
+    for (size_t i = 0; i < pageCount; i++) {
+        this->pageHeaders.emplace_back(*doc->getPage(i));
+        this->layerNames.emplace_back(*doc->getPage(i));
+    }
+}
+
+void AutosaveJournal::autosaveFileReplaced(const fs::path& autosaveFile) {
+    // A crash before the journal is removed leaves records for the previous file, which are ignored as their base
+    // differs
+    std::error_code ec;
+    fs::remove(getJournalPath(autosaveFile), ec);
+
+    std::lock_guard lock(this->mutex);
+    if (autosaveFile == this->autosaveFile) {
+        this->baseId = getBaseId(autosaveFile);
+        this->autosaveFileSize = fs::file_size(autosaveFile, ec);
+    }
+    if (ec || this->baseId.empty()) {
+        this->fullSaveNeeded = true;
+    }
+}
+
+void AutosaveJournal::invalidate() {
+    std::lock_guard lock(this->mutex);
+    this->fullSaveNeeded = true;
+}
+
+auto AutosaveJournal::getJournalPath(const fs::path& autosaveFile) -> fs::path {
+    return fs::path(autosaveFile) += ".journal";
+}
+
+auto AutosaveJournal::getBaseId(const fs::path& autosaveFile) -> std::string {
+    std::error_code ec;
+    auto size = fs::file_size(autosaveFile, ec);
+    if (ec) {
+        return {};
+    }
+    auto time = fs::last_write_time(autosaveFile, ec);
+    if (ec) {
+        return {};
+    }
+    return std::to_string(size) + "-" + std::to_string(time.time_since_epoch().count());
+}
+
+void AutosaveJournal::documentChanged(DocumentChangeType type) { invalidate(); }
+
+void AutosaveJournal::pageSizeChanged(size_t page) { invalidate(); }
+
+void AutosaveJournal::pageChanged(size_t page) {
+    if (PageRef p = this->control->getDocument()->getPage(page)) {
+        pageContentChanged(p);
+    }
+}
+
+void AutosaveJournal::pageInserted(size_t page) { invalidate(); }
+
+void AutosaveJournal::pageDeleted(size_t page) { invalidate(); }
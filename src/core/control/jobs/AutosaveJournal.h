@@ -0,0 +1,140 @@
+/*
+ * Xournal++
+ *
+ * Tracks the changes to write to the autosave journal
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>   // for size_t
+#include <cstdint>   // for uintmax_t
+#include <mutex>     // for mutex
+#include <optional>  // for optional
+#include <string>    // for string
+#include <vector>    // for vector
+
+#include "model/BackgroundImage.h"     // for BackgroundImage
+#include "model/DocumentChangeType.h"  // for DocumentChangeType
+#include "model/DocumentListener.h"    // for DocumentListener
+#include "model/PageRef.h"             // for PageRef
+#include "model/PageType.h"            // for PageType
+#include "util/Color.h"                // for Color
+
+#include "filesystem.h"  // for path
+
+class Control;
+class Document;
+class XojPage;
+
+/**
+ * The autosave file is only rewritten completely when needed. Otherwise, the layers of the pages changed since the
+ * last autosave are appended as a record to a journal next to it, which is replayed when the autosave file is loaded
+ * (see SaveHandler::writeJournalRecord() and LoadHandler).
+ *
+ * The whole document is saved again, folding the journal back in, when pages were inserted, deleted or had their
+ * size or background changed, or when the journal grows larger than half of the autosave file.
+ *
+ * Edits without an undo action are not reported to pageContentChanged(): the attributes of all pages are compared
+ * with the ones last written before each record, so that such edits are still saved.
+ */
+class AutosaveJournal: public DocumentListener {
+public:
+    explicit AutosaveJournal(Control* control);
+    ~AutosaveJournal() override;
+
+public:
+    /**
+     * Called on each page of the undo actions, when they are added, undone or redone
+     */
+    void pageContentChanged(const PageRef& page);
+
+    /**
+     * Write the changed pages as a journal record. The document must be locked.
+     *
+     * @return false if the whole document has to be saved instead
+     */
+    bool writeRecord(Document* doc, const fs::path& autosaveFile, std::string& record);
+
+    /**
+     * Append the record to the journal of `autosaveFile`
+     *
+     * @return An error message, empty on success
+     */
+    std::string appendRecord(const fs::path& autosaveFile, const std::string& record);
+
+    /**
+     * Called when the whole document is saved to `autosaveFile`, before the document is unlocked
+     */
+    void documentSaved(const Document* doc, const fs::path& autosaveFile);
+
+    /**
+     * Called once the file written since documentSaved() replaced `autosaveFile`. Removes the journal.
+     */
+    void autosaveFileReplaced(const fs::path& autosaveFile);
+
+    /**
+     * Saving failed: the next autosave writes the whole document
+     */
+    void invalidate();
+
+    static fs::path getJournalPath(const fs::path& autosaveFile);
+
+    /**
+     * Identifies the version of the autosave file a journal record applies to
+     */
+    static std::string getBaseId(const fs::path& autosaveFile);
+
+    // DocumentListener
+public:
+    void documentChanged(DocumentChangeType type) override;
+    void pageSizeChanged(size_t page) override;
+    void pageChanged(size_t page) override;
+    void pageInserted(size_t page) override;
+    void pageDeleted(size_t page) override;
+
+private:
+    /**
+     * The attributes of a page that are not written to the journal
+     */
+    struct PageHeader {
+        explicit PageHeader(const XojPage& page);
+        bool operator==(const PageHeader& other) const = default;
+
+        double width;
+        double height;
+        PageType type;
+        size_t pdfPage;
+        Color color;
+        BackgroundImage image;
+        std::string name;
+    };
+
+    /**
+     * The names of the layers of a page, which are written to the journal. The layer names of a page which is not
+     * loaded are those of the loaded file: they are left unknown rather than parsing the page.
+     */
+    struct LayerNames {
+        explicit LayerNames(const XojPage& page);
+        /// Renaming a layer changes the revision of the page, see XojPage::getRevision()
+        size_t revision;
+        std::optional<std::vector<std::string>> names;
+    };
+
+    Control* control = nullptr;
+
+    std::mutex mutex;
+    std::vector<PageRef> changedPages;
+    bool fullSaveNeeded = true;
+
+    fs::path autosaveFile;
+    std::string baseId;
+    std::vector<PageHeader> pageHeaders;
+    std::vector<LayerNames> layerNames;
+    /// Size of the autosave file, which the journal may not exceed by half
+    uintmax_t autosaveFileSize = 0;
+};
@@ -11,6 +11,7 @@
 #include "gui/MainWindow.h"                    // for MainWindow
 #include "gui/dialog/ExportDialog.h"           // for ExportDialog
 #include "model/Document.h"                    // for Document
+#include "model/DocumentHandler.h"             // for DocumentHandler
 #include "pdf/base/XojPdfExport.h"             // for XojPdfExport
 #include "pdf/base/XojPdfExportFactory.h"      // for XojPdfExportFactory
 #include "util/PathUtil.h"                     // for clearExtensions
@@ -123,11 +124,14 @@ void CustomExportJob::run() {
         Document* doc = this->control->getDocument();
 
         XojExportHandler h;
+        DocumentHandler snapshotHandler;
         doc->lock();
-        h.prepareSave(doc, filepath);
-        h.saveTo(filepath, this->control);
+        auto snapshot = doc->createSnapshot(&snapshotHandler);
         doc->unlock();
 
+        h.prepareSave(snapshot.get(), filepath);
+        h.saveTo(filepath, this->control);
+
         if (!h.getErrorMessage().empty()) {
             this->lastError = FS(_F("Save file error: {1}") % h.getErrorMessage());
 
@@ -0,0 +1,27 @@
+#include "PdfPrefetchJob.h"
+
+#include <utility>  // for move
+
+#include "control/PdfCache.h"  // for PdfCache
+#include "gui/XournalView.h"   // for XournalView
+
+PdfPrefetchJob::PdfPrefetchJob(XournalView* view, std::vector<size_t> pdfPageNos, double zoom, int DPIScaling,
+                               xoj::view::RenderGeneration generation):
+        view(view), pdfPageNos(std::move(pdfPageNos)), zoom(zoom), DPIScaling(DPIScaling), generation(generation) {}
+
+auto PdfPrefetchJob::getType() -> JobType { return JOB_TYPE_PDF_PREFETCH; }
+
+auto PdfPrefetchJob::getSource() -> void* { return this->view; }
+
+void PdfPrefetchJob::run() {
+    PdfCache* cache = this->view->getCache();
+    if (!cache) {
+        return;
+    }
+    for (size_t pdfPageNo: this->pdfPageNos) {
+        if (this->generation.isCancelled() || !cache->prefetch(pdfPageNo, this->zoom, this->DPIScaling)) {
+            // The user scrolled elsewhere, or the cache is full
+            return;
+        }
+    }
+}
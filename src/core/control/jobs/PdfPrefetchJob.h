@@ -0,0 +1,52 @@
+/*
+ * Xournal++
+ *
+ * A job which renders PDF pages ahead of time
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "view/View.h"  // for RenderGeneration
+
+#include "Job.h"  // for Job, JobType
+
+class XournalView;
+
+/**
+ * @brief A Job which renders the PDF pages the user is scrolling towards into the PDF cache, so that they are ready
+ * when the pages become visible
+ */
+class PdfPrefetchJob: public Job {
+public:
+    /**
+     * @param pdfPageNos The pages (in the pdf document) to render, the most urgent first
+     * @param generation The job stops once the generation is outdated
+     */
+    PdfPrefetchJob(XournalView* view, std::vector<size_t> pdfPageNos, double zoom, int DPIScaling,
+                   xoj::view::RenderGeneration generation);
+
+protected:
+    ~PdfPrefetchJob() override = default;
+
+public:
+    JobType getType() override;
+
+    void* getSource() override;
+
+    void run() override;
+
+private:
+    XournalView* view;
+    std::vector<size_t> pdfPageNos;
+    double zoom;
+    int DPIScaling;
+    xoj::view::RenderGeneration generation;
+};
@@ -66,43 +66,46 @@ void PreviewJob::drawPage() {
         layer = (dynamic_cast<SidebarPreviewLayerEntry*>(this->sidebarPreview))->getLayer();
     }
 
+    auto flags = xoj::view::BACKGROUND_SHOW_ALL;
+    if (type == RENDER_TYPE_PAGE_LAYER && layer != 0) {
+        flags = xoj::view::BACKGROUND_FORCE_PAINT_BACKGROUND_COLOR_ONLY;
+    } else if (type != RENDER_TYPE_PAGE_PREVIEW) {
+        flags.forceVisible = xoj::view::FORCE_VISIBLE;
+    }
+    auto background = view.createBackgroundView(page, flags);
+
+    // The background, e.g. the PDF page, is drawn without blocking the other jobs on the document
+    doc->unlock();
+    if (background) {
+        background->draw(cr.get());
+    }
+    doc->lock();
+
     auto context = xoj::view::Context::createDefault(cr.get());
 
     switch (type) {
         case RENDER_TYPE_PAGE_PREVIEW:
             // render all layers
-            view.drawPage(page, cr.get(), true);
+            view.drawPageWithoutBackground(page, cr.get(), true);
             break;
 
         case RENDER_TYPE_PAGE_LAYER:
             // render single layer
-            view.initDrawing(page, cr.get(), true);
-            if (layer == 0) {
-                auto flags = xoj::view::BACKGROUND_SHOW_ALL;
-                flags.forceVisible = xoj::view::FORCE_VISIBLE;
-                view.drawBackground(flags);
-            } else {
-                view.drawBackground(xoj::view::BACKGROUND_FORCE_PAINT_BACKGROUND_COLOR_ONLY);
+            if (layer != 0) {
                 const Layer* drawLayer = page->getLayersView()[layer - 1];
                 xoj::view::LayerView layerView(drawLayer);
                 layerView.draw(context);
             }
-            view.finializeDrawing();
             break;
 
         case RENDER_TYPE_PAGE_LAYERSTACK: {
             // render all layers up to layer
-            view.initDrawing(page, cr.get(), true);
-            auto flags = xoj::view::BACKGROUND_SHOW_ALL;
-            flags.forceVisible = xoj::view::FORCE_VISIBLE;
-            view.drawBackground(flags);
             const auto layers = page->getLayersView();
             for (Layer::Index i = 0; i < layer; i++) {
                 const Layer* drawLayer = layers[i];
                 xoj::view::LayerView layerView(drawLayer);
                 layerView.draw(context);
             }
-            view.finializeDrawing();
             break;
         }
         default:
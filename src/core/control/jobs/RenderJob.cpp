@@ -1,41 +1,52 @@
 #include "RenderJob.h"
 
-#include <mutex>    // for mutex
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <algorithm>  // for min, sort, unique, remove_if, copy_if
+#include <iterator>   // for back_inserter
+#include <memory>     // for make_shared, shared_ptr, unique_ptr
+#include <mutex>      // for mutex, lock_guard
+#include <tuple>      // for tuple
+#include <utility>    // for move
+#include <vector>     // for vector
 
 #include <cairo.h>  // for cairo_create, cairo_destroy, cairo_...
 
-#include "control/Control.h"            // for Control
-#include "control/ToolEnums.h"          // for TOOL_PLAY_OBJECT
-#include "control/ToolHandler.h"        // for ToolHandler
-#include "control/jobs/Job.h"           // for JOB_TYPE_RENDER, JobType
-#include "gui/PageView.h"               // for XojPageView
-#include "gui/XournalView.h"            // for XournalView
-#include "gui/widgets/XournalWidget.h"  // for gtk_xournal_repaint_area
-#include "model/Document.h"             // for Document
-#include "model/XojPage.h"              // for Page
-#include "util/Assert.h"                // for xoj_assert
-#include "util/Rectangle.h"             // for Rectangle
-#include "util/Util.h"                  // for execInUiThread
-#include "util/raii/CairoWrappers.h"    // for CairoSurfaceSPtr, CairoSPtr
-#include "util/safe_casts.h"            // for strict_cast, as_signed, as_si...
-#include "view/DocumentView.h"          // for DocumentView
-#include "view/Mask.h"                  // for Mask
-
-#if defined(__has_cpp_attribute) && __has_cpp_attribute(likely)
-#define XOJ_CPP20_UNLIKELY [[unlikely]]
-#else
-#define XOJ_CPP20_UNLIKELY
-#endif
+#include "control/Control.h"                 // for Control
+#include "control/ToolEnums.h"               // for TOOL_PLAY_OBJECT
+#include "control/ToolHandler.h"             // for ToolHandler
+#include "control/jobs/Job.h"                // for JOB_TYPE_RENDER, JobType
+#include "gui/PageView.h"                    // for XojPageView
+#include "gui/XournalView.h"                 // for XournalView
+#include "gui/widgets/XournalWidget.h"       // for gtk_xournal_repaint_area
+#include "model/Document.h"                  // for Document
+#include "model/XojPage.h"                   // for Page
+#include "util/Assert.h"                     // for xoj_assert
+#include "util/Rectangle.h"                  // for Rectangle
+#include "util/Util.h"                       // for execInUiThread
+#include "util/raii/CairoWrappers.h"         // for CairoSurfaceSPtr, CairoSPtr
+#include "util/safe_casts.h"                 // for strict_cast, as_signed, as_si...
+#include "view/DocumentView.h"               // for DocumentView
+#include "view/Mask.h"                       // for Mask
+#include "view/TileCache.h"                  // for TileCache, Tile
+#include "view/background/BackgroundView.h"  // for BackgroundView
 
 using xoj::util::Rectangle;
+using xoj::view::Tile;
+using xoj::view::TileCache;
+
+/// When preloading a page which has not been painted yet, the height rendered (in device pixels)
+constexpr int PRELOAD_HEIGHT = 4 * TileCache::TILE_SIZE;
+
+/// The draft tiles are rendered at the zoom level divided by DRAFT_SCALE
+constexpr double DRAFT_SCALE = 4.0;
+
+/// A draft of the page is rendered first if at least this many tiles have never been rendered (e.g. after zooming)
+constexpr size_t DRAFT_MIN_TILES = 4;
 
 RenderJob::RenderJob(XojPageView* view): view(view) {}
 
 auto RenderJob::getSource() -> void* { return this->view; }
 
-void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
+void RenderJob::rerenderRectangle(Rectangle<double> const& rect, double zoom) {
     /**
      * Padding seems to be necessary to prevent artefacts of most strokes.
      * These artefacts are most pronounced when using the stroke deletion
@@ -46,59 +57,194 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
 
     Range maskRange(rect);
     maskRange.addPadding(RENDER_PADDING);
-    xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(), maskRange, view->xournal->getZoom(),
-                            CAIRO_CONTENT_COLOR_ALPHA);
 
-    renderToBuffer(newMask.get());
+    const int dpiScaling = view->xournal->getDpiScaleFactor();
+    std::vector<std::shared_ptr<Tile>> tiles;
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        for (auto& [key, tile]: TileCache::instance().getTiles(this->view)) {
+            if (!tile->getExtent().intersect(maskRange).isValid()) {
+                continue;
+            }
+            if (key.zoom == zoom && key.dpiScaling == dpiScaling && !tile->stale) {
+                tiles.push_back(std::move(tile));
+            } else {
+                // Rendered again entirely if needed
+                tile->stale = true;
+            }
+        }
+    }
+    if (tiles.empty()) {
+        return;
+    }
+
+    xoj::view::Mask newMask(dpiScaling, maskRange, zoom, CAIRO_CONTENT_COLOR_ALPHA);
+
+    if (!this->generation.isCancelled()) {
+        renderToBuffer(newMask.get());
+    }
 
     std::lock_guard lock(this->view->drawingMutex);
-    if (!view->buffer.isInitialized()) {
-        // Todo: the buffer must not be uninitializable here, either by moving it into the job or by locking it at job
-        // creation a shared prt may also be suffice.
-        XOJ_CPP20_UNLIKELY return;
+    for (const auto& tile: tiles) {
+        if (this->generation.isCancelled()) {
+            // The mask is incomplete: the tiles are outdated
+            tile->stale = true;
+        } else {
+            newMask.paintTo(tile->get());
+        }
+    }
+}
+
+void RenderJob::renderTiles(std::vector<TileCache::Key> keys, const Range& paintedArea, double zoom) {
+    // The tiles closest to the center of the visible area first
+    const double centerX = paintedArea.isValid() ? (paintedArea.minX + paintedArea.maxX) / 2 : 0.0;
+    const double centerY = paintedArea.isValid() ? (paintedArea.minY + paintedArea.maxY) / 2 : 0.0;
+    auto priority = [&](const TileCache::Key& key) {
+        Range extent = TileCache::getTileExtent(key.x, key.y, zoom);
+        double dx = (extent.minX + extent.maxX) / 2 - centerX;
+        double dy = (extent.minY + extent.maxY) / 2 - centerY;
+        return std::tuple(dx * dx + dy * dy, key.y, key.x);
+    };
+    const int dpiScaling = view->xournal->getDpiScaleFactor();
+    keys.erase(std::remove_if(keys.begin(), keys.end(),
+                              [&](const auto& key) { return key.zoom != zoom || key.dpiScaling != dpiScaling; }),
+               keys.end());
+    std::sort(keys.begin(), keys.end(), [&](const auto& a, const auto& b) { return priority(a) < priority(b); });
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    auto& cache = TileCache::instance();
+
+    std::vector<TileCache::Key> uncoveredKeys;
+    std::copy_if(keys.begin(), keys.end(), std::back_inserter(uncoveredKeys),
+                 [&cache](const auto& key) { return cache.lookup(key) == nullptr; });
+    if (uncoveredKeys.size() >= DRAFT_MIN_TILES) {
+        renderDraftTiles(uncoveredKeys, zoom);
+    }
+
+    for (const auto& key: keys) {
+        if (this->generation.isCancelled() || view->xournal->getZoom() != zoom) {
+            // The tiles at the new zoom level will be requested when painting
+            return;
+        }
+        if (auto tile = cache.lookup(key); tile) {
+            std::lock_guard lock(this->view->drawingMutex);
+            if (!tile->stale && !tile->draft) {
+                // Rendered since it was requested
+                continue;
+            }
+        }
+
+        auto tile = std::make_shared<Tile>(dpiScaling, key.x, key.y, zoom);
+        renderToBuffer(tile->get());
+        if (this->generation.isCancelled()) {
+            return;
+        }
+        Range extent = tile->getExtent();
+        {
+            std::lock_guard lock(this->view->drawingMutex);
+            cache.cache(key, std::move(tile));
+        }
+        repaintPageArea(extent.minX, extent.minY, extent.maxX, extent.maxY);
+    }
+}
+
+void RenderJob::renderDraftTiles(const std::vector<TileCache::Key>& keys, double zoom) {
+    Range area;
+    for (const auto& key: keys) {
+        area = area.unite(TileCache::getTileExtent(key.x, key.y, zoom));
+    }
+    area = area.intersect(Range(0, 0, view->page->getWidth(), view->page->getHeight()));
+
+    const double draftZoom = zoom / DRAFT_SCALE;
+    const int dpiScaling = view->xournal->getDpiScaleFactor();
+    const auto range = TileCache::getTileRange(area, draftZoom);
+    auto& cache = TileCache::instance();
+    for (int y = range.minY; y <= range.maxY; y++) {
+        for (int x = range.minX; x <= range.maxX; x++) {
+            if (this->generation.isCancelled() || view->xournal->getZoom() != zoom) {
+                return;
+            }
+            TileCache::Key key{this->view, draftZoom, dpiScaling, x, y};
+            if (auto tile = cache.lookup(key); tile) {
+                std::lock_guard lock(this->view->drawingMutex);
+                if (!tile->stale) {
+                    continue;
+                }
+            }
+
+            auto tile = std::make_shared<Tile>(dpiScaling, x, y, draftZoom);
+            tile->draft = true;
+            renderToBuffer(tile->get(), true);
+            if (this->generation.isCancelled()) {
+                return;
+            }
+            Range extent = tile->getExtent();
+            {
+                std::lock_guard lock(this->view->drawingMutex);
+                cache.cache(key, std::move(tile));
+            }
+            repaintPageArea(extent.minX, extent.minY, extent.maxX, extent.maxY);
+        }
     }
-    newMask.paintTo(view->buffer.get());
 }
 
 void RenderJob::run() {
+    this->generation = {&this->view->renderGeneration, this->view->renderGeneration.load()};
+
     this->view->repaintRectMutex.lock();
 
     bool rerenderComplete = std::exchange(this->view->rerenderComplete, false);
     bool sizeChanged = std::exchange(this->view->sizeChanged, false);
     auto rerenderRects = std::move(this->view->rerenderRects);
+    auto neededTiles = std::move(this->view->neededTiles);
+    Range paintedArea = this->view->paintedArea;
 
     this->view->repaintRectMutex.unlock();
 
-    if (rerenderComplete) {
-        xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(),
-                                Range(0, 0, view->page->getWidth(), view->page->getHeight()), view->xournal->getZoom(),
-                                CAIRO_CONTENT_COLOR_ALPHA);
+    const double zoom = view->xournal->getZoom();
 
-        renderToBuffer(newMask.get());
+    if (rerenderComplete) {
         {
             std::lock_guard lock(this->view->drawingMutex);
-            std::swap(this->view->buffer, newMask);
+            for (auto& [key, tile]: TileCache::instance().getTiles(this->view)) {
+                tile->stale = true;
+            }
+        }
+        // Render the part of the page painted last first, or the top of the page if it has not been painted yet
+        Range area = paintedArea.isValid() ? paintedArea :
+                                             Range(0, 0, view->page->getWidth(),
+                                                   std::min(view->page->getHeight(), PRELOAD_HEIGHT / zoom));
+        const auto range = TileCache::getTileRange(area, zoom);
+        const int dpiScaling = view->xournal->getDpiScaleFactor();
+        for (int y = range.minY; y <= range.maxY; y++) {
+            for (int x = range.minX; x <= range.maxX; x++) {
+                neededTiles.push_back({this->view, zoom, dpiScaling, x, y});
+            }
         }
         if (sizeChanged) {
             // We do not have any control on what portion of the widget needs to be redrawn. Redraw it all.
             Util::execInUiThread([w = view->xournal->getWidget()]() { gtk_widget_queue_draw(w); });
-        } else {
-            repaintPage();
         }
     } else {
         for (Rectangle<double> const& rect: rerenderRects) {
-            rerenderRectangle(rect);
+            rerenderRectangle(rect, zoom);
             repaintPageArea(rect.x, rect.y, rect.x + rect.width, rect.y + rect.height);
         }
     }
+
+    renderTiles(std::move(neededTiles), paintedArea, zoom);
+
+    if (rerenderComplete && !sizeChanged && !this->generation.isCancelled()) {
+        // The painted area may only be a part of the visible area: painting the whole page requests the other visible
+        // tiles, which are stale
+        repaintPageArea(0, 0, view->page->getWidth(), view->page->getHeight());
+    }
 }
 
 static void repaintWidgetArea(GtkWidget* widget, int x1, int y1, int x2, int y2) {
     Util::execInUiThread([=]() { gtk_xournal_repaint_area(widget, x1, y1, x2, y2); });
 }
 
-void RenderJob::repaintPage() const { repaintPageArea(0, 0, view->getWidth(), view->getHeight()); }
-
 void RenderJob::repaintPageArea(double x1, double y1, double x2, double y2) const {
     double zoom = view->xournal->getZoom();
     int x = view->getX();
@@ -107,14 +253,27 @@ void RenderJob::repaintPageArea(double x1, double y1, double x2, double y2) cons
                       x + ceil_cast<int>(zoom * x2), y + ceil_cast<int>(zoom * y2));
 }
 
-void RenderJob::renderToBuffer(cairo_t* cr) const {
+void RenderJob::renderToBuffer(cairo_t* cr, bool draft) const {
     DocumentView localView;
+    localView.setDraftQuality(draft);
+    localView.setRenderGeneration(this->generation);
     localView.setMarkAudioStroke(this->view->getXournal()->getControl()->getToolHandler()->getToolType() ==
                                  TOOL_PLAY_OBJECT);
     localView.setPdfCache(this->view->xournal->getCache());
 
-    std::lock_guard<Document> lock(*this->view->xournal->getDocument());
-    localView.drawPage(this->view->page, cr, false);
+    Document* doc = this->view->xournal->getDocument();
+    std::unique_ptr<xoj::view::BackgroundView> background;
+    {
+        std::lock_guard<Document> lock(*doc);
+        background = localView.createBackgroundView(this->view->page, xoj::view::BACKGROUND_SHOW_ALL);
+    }
+    // Rasterising the PDF page does not need the document: the other pages may be drawn meanwhile
+    if (background) {
+        background->draw(cr);
+    }
+
+    std::lock_guard<Document> lock(*doc);
+    localView.drawPageWithoutBackground(this->view->page, cr, false);
 }
 
 auto RenderJob::getType() -> JobType { return JOB_TYPE_RENDER; }
@@ -11,11 +11,17 @@
 
 #pragma once
 
+#include <vector>  // for vector
+
 #include <cairo.h>    // for cairo_surface_t
 #include <gtk/gtk.h>  // for GtkWidget
 
+#include "view/TileCache.h"  // for TileCache
+#include "view/View.h"       // for RenderGeneration
+
 #include "Job.h"  // for Job, JobType
 
+class Range;
 class XojPageView;
 namespace xoj::util {
 template <class T>
@@ -37,14 +43,32 @@ public:
     void run() override;
 
 private:
-    void repaintPage() const;
-
     void repaintPageArea(double x1, double y1, double x2, double y2) const;
 
-    void rerenderRectangle(xoj::util::Rectangle<double> const& rect);
+    /**
+     * Renders the rectangle (in page coordinates) onto the tiles of the page at the given zoom level
+     */
+    void rerenderRectangle(xoj::util::Rectangle<double> const& rect, double zoom);
 
-    void renderToBuffer(cairo_t* cr) const;
+    /**
+     * Renders the tiles which are missing or outdated, the closest to the painted area first
+     */
+    void renderTiles(std::vector<xoj::view::TileCache::Key> keys, const Range& paintedArea, double zoom);
+
+    /**
+     * Quickly renders a rough version of the area covered by the tiles, at a fraction of the zoom level. It is shown
+     * until the tiles themselves are rendered.
+     */
+    void renderDraftTiles(const std::vector<xoj::view::TileCache::Key>& keys, double zoom);
+
+    /**
+     * @param draft Trade accuracy for speed (see DocumentView::setDraftQuality)
+     */
+    void renderToBuffer(cairo_t* cr, bool draft = false) const;
 
 private:
     XojPageView* view;
+
+    /// The rendering is abandoned once the page's generation moves past this one
+    xoj::view::RenderGeneration generation;
 };
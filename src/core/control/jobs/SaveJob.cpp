@@ -7,8 +7,10 @@
 
 #include "control/Control.h"              // for Control
 #include "control/jobs/BlockingJob.h"     // for BlockingJob
+#include "control/settings/Settings.h"    // for Settings
 #include "control/xojfile/SaveHandler.h"  // for SaveHandler
 #include "model/Document.h"               // for Document
+#include "model/DocumentHandler.h"        // for DocumentHandler
 #include "model/PageRef.h"                // for PageRef
 #include "model/PageType.h"               // for PageType
 #include "model/XojPage.h"                // for XojPage
@@ -104,14 +106,19 @@ auto SaveJob::save() -> bool {
     updatePreview(control);
     Document* doc = this->control->getDocument();
     SaveHandler h;
+    h.setBinaryStrokes(this->control->getSettings()->isSaveBinaryStrokes());
 
+    // Serialize a snapshot, so that the document is not locked while writing
+    DocumentHandler snapshotHandler;
     doc->lock();
     fs::path target = doc->getFilepath();
     Util::safeReplaceExtension(target, "xopp");
 
-    h.prepareSave(doc, target);
+    auto snapshot = doc->createSnapshot(&snapshotHandler);
     doc->unlock();
 
+    h.prepareSave(snapshot.get(), target);
+
     auto const createBackup = doc->shouldCreateBackupOnSave();
 
     if (createBackup) {
@@ -129,8 +136,8 @@ auto SaveJob::save() -> bool {
         }
     }
 
-    doc->lock();
     h.saveTo(target, this->control);
+    doc->lock();
     doc->setFilepath(target);
     doc->unlock();
 
@@ -1,7 +1,10 @@
 #include "Scheduler.h"
 
+#include <algorithm>  // for clamp, none_of, find, find_if
 #include <cinttypes>  // for PRId64
 #include <cstdint>    // for uint64_t
+#include <string>     // for to_string
+#include <thread>     // for thread
 
 #include "control/jobs/Job.h"  // for Job, JOB_TYPE_RENDER
 #include "util/Assert.h"       // for xoj_assert
@@ -40,25 +43,38 @@ Scheduler::~Scheduler() {
     }
 }
 
-void Scheduler::start() {
+void Scheduler::start(unsigned int workerCount) {
     SDEBUG("Starting scheduler");
-    g_return_if_fail(this->thread == nullptr);
+    g_return_if_fail(this->threads.empty());
 
-    this->thread = g_thread_new(name.c_str(), reinterpret_cast<GThreadFunc>(jobThreadCallback), this);
+    if (workerCount == 0) {
+        workerCount = std::clamp(std::thread::hardware_concurrency() / 2, 1U, 4U);
+    }
+    for (unsigned int i = 0; i < workerCount; i++) {
+        std::string threadName = name + " " + std::to_string(i);
+        this->threads.push_back(
+                g_thread_new(threadName.c_str(), reinterpret_cast<GThreadFunc>(jobThreadCallback), this));
+    }
 }
 
+auto Scheduler::getWorkerCount() const -> size_t { return this->threads.size(); }
+
 void Scheduler::stop() {
     SDEBUG("Stopping scheduler");
 
-    if (!this->threadRunning) {
-        return;
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        if (!this->threadRunning) {
+            return;
+        }
+        this->threadRunning = false;
     }
-    this->threadRunning = false;
     this->jobQueueCond.notify_all();
 
-    if (this->thread) {
-        g_thread_join(this->thread);
+    for (GThread* thread: this->threads) {
+        g_thread_join(thread);
     }
+    this->threads.clear();
 }
 
 void Scheduler::addJob(Job* job, JobPriority priority) {
@@ -75,30 +91,45 @@ void Scheduler::addJob(Job* job, JobPriority priority) {
     this->jobQueueCond.notify_all();
 }
 
-auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> Job* {
-    Job* job = nullptr;
+auto Scheduler::getSerializationKey(Job* job) -> void* {
+    switch (job->getType()) {
+        case JOB_TYPE_RENDER:
+        case JOB_TYPE_PREVIEW:
+        case JOB_TYPE_PDF_PREFETCH:
+        case JOB_TYPE_TASK:
+            return job->getSource();
+        default:
+            return nullptr;
+    }
+}
+
+auto Scheduler::isRunnableUnlocked(Job* job) const -> bool {
+    void* key = getSerializationKey(job);
+    return std::none_of(this->runningJobs.begin(), this->runningJobs.end(),
+                        [key](const RunningJob& r) { return r.serializationKey == key; });
+}
 
+auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> Job* {
     for (size_t i = JOB_PRIORITY_URGENT; i < JOB_N_PRIORITIES; i++) {
         std::deque<Job*>& queue = *this->jobQueue[i];
 
-        if (onlyNotRender) {
-            for (auto it = queue.begin(); it != queue.end(); ++it) {
-                job = *it;
-
-                if (job->getType() != JOB_TYPE_RENDER) {
-                    queue.erase(it);
-                    return job;
-                }
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            Job* job = *it;
+            xoj_assert(job != nullptr);
 
+            if (onlyNotRender && (job->getType() == JOB_TYPE_RENDER || job->getType() == JOB_TYPE_PDF_PREFETCH)) {
                 if (hasRenderJobs != nullptr) {
                     *hasRenderJobs = true;
                 }
+                continue;
             }
-        } else if (!queue.empty()) {
-            job = queue.front();
-            queue.pop_front();
-            xoj_assert(job != nullptr);
 
+            if (!isRunnableUnlocked(job)) {
+                // Another job of the same source is running: it will be taken once that one is finished
+                continue;
+            }
+
+            queue.erase(it);
             return job;
         }
     }
@@ -106,15 +137,47 @@ auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> J
     return nullptr;
 }
 
+void Scheduler::waitForRunningJobs(void* source) {
+    std::unique_lock lock{this->jobQueueMutex};
+
+    std::vector<uint64_t> awaitedJobs;
+    for (const RunningJob& r: this->runningJobs) {
+        // A job waiting for itself would never return
+        if ((source == nullptr || r.source == source) && r.thread != g_thread_self()) {
+            awaitedJobs.push_back(r.id);
+        }
+    }
+
+    this->jobFinishedCond.wait(lock, [&]() {
+        return std::none_of(this->runningJobs.begin(), this->runningJobs.end(), [&](const RunningJob& r) {
+            return std::find(awaitedJobs.begin(), awaitedJobs.end(), r.id) != awaitedJobs.end();
+        });
+    });
+}
+
 /**
  * Locks the complete scheduler
  */
-void Scheduler::lock() { this->schedulerMutex.lock(); }
+void Scheduler::lock() {
+    this->schedulerMutex.lock();
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        this->paused = true;
+    }
+    waitForRunningJobs();
+}
 
 /**
  * Unlocks the complete scheduler
  */
-void Scheduler::unlock() { this->schedulerMutex.unlock(); }
+void Scheduler::unlock() {
+    {
+        std::lock_guard lock{this->jobQueueMutex};
+        this->paused = false;
+    }
+    this->jobQueueCond.notify_all();
+    this->schedulerMutex.unlock();
+}
 
 #define ZOOM_WAIT_US_TIMEOUT 300000  // 0.3s
 
@@ -144,17 +207,13 @@ auto Scheduler::jobRenderThreadTimer(Scheduler* scheduler) -> bool {
 }
 
 auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
-    while (scheduler->threadRunning) {
-        // lock the whole scheduler
-        std::unique_lock schedulerLock{scheduler->schedulerMutex};
-        SDEBUG("Job Thread: Blocked scheduler.");
-
+    while (true) {
         bool onlyNonRenderJobs = false;
         gint64 diff = 1000;
-        if (scheduler->blockRenderZoomTime) {
+        if (gint64 blockTime = scheduler->blockRenderZoomTime; blockTime) {
             SDEBUG("Zoom re-render blocking.");
 
-            diff = (scheduler->blockRenderZoomTime - g_get_monotonic_time()) / 1000;
+            diff = (blockTime - g_get_monotonic_time()) / 1000;
             if (diff <= 0) {
                 scheduler->blockRenderZoomTime = 0;
                 SDEBUG("Ended zoom re-render blocking.");
@@ -164,14 +223,21 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
             }
         }
 
-        Job* job;
+        Job* job = nullptr;
+        uint64_t jobId = 0;
 
         {
             std::unique_lock jobLock{scheduler->jobQueueMutex};
             SDEBUG("Job Thread: Locked job queue.");
 
+            if (!scheduler->threadRunning) {
+                break;
+            }
+
             bool hasOnlyRenderJobs = false;
-            job = scheduler->getNextJobUnlocked(onlyNonRenderJobs, &hasOnlyRenderJobs);
+            if (!scheduler->paused) {
+                job = scheduler->getNextJobUnlocked(onlyNonRenderJobs, &hasOnlyRenderJobs);
+            }
             if (job != nullptr) {
                 hasOnlyRenderJobs = false;
             }
@@ -179,9 +245,6 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
             SDEBUG("get job: %" PRId64, (uint64_t)job);
 
             if (job == nullptr) {
-                // unlock the whole scheduler
-                schedulerLock.unlock();
-
                 if (hasOnlyRenderJobs) {
                     if (auto id = scheduler->jobRenderThreadTimerId.exchange(g_timeout_add(
                                 static_cast<guint>(diff), xoj::util::wrap_for_once_v<jobRenderThreadTimer>, scheduler));
@@ -193,15 +256,25 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
                 scheduler->jobQueueCond.wait(jobLock);
                 continue;
             }
+
+            jobId = ++scheduler->lastJobId;
+            scheduler->runningJobs.push_back({jobId, getSerializationKey(job), job->getSource(), g_thread_self()});
         }
 
         // Run the job.
+        SDEBUG("do job: %" PRId64, (uint64_t)job);
+        job->execute();
+        job->unref();
+
         {
-            std::lock_guard lock{scheduler->jobRunningMutex};
-            SDEBUG("do job: %" PRId64, (uint64_t)job);
-            job->execute();
-            job->unref();
+            std::lock_guard jobLock{scheduler->jobQueueMutex};
+            auto& running = scheduler->runningJobs;
+            running.erase(std::find_if(running.begin(), running.end(),
+                                       [jobId](const RunningJob& r) { return r.id == jobId; }));
         }
+        // Jobs of the same source may have been waiting for this one
+        scheduler->jobQueueCond.notify_all();
+        scheduler->jobFinishedCond.notify_all();
 
         SDEBUG("next");
     }
@@ -16,9 +16,12 @@
 #include <array>               // for array
 #include <atomic>              // for atomic
 #include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for uint64_t
 #include <deque>               // for deque
 #include <mutex>               // for mutex
 #include <string>              // for string
+#include <vector>              // for vector
 
 #include <glib.h>  // for GThread, GTimeVal, gpointer
 
@@ -80,11 +83,21 @@ public:
      */
     void addJob(Job* job, JobPriority priority);
 
-    void start();
+    /**
+     * Starts the worker threads
+     *
+     * @param workerCount The number of jobs which may run in parallel, or 0 to choose it from the number of processors
+     */
+    void start(unsigned int workerCount = 1);
     void stop();
 
     /**
-     * Locks the complete scheduler
+     * @return The number of worker threads, 0 if the scheduler is not started
+     */
+    size_t getWorkerCount() const;
+
+    /**
+     * Locks the complete scheduler: waits for the running jobs to finish, and starts no new job until unlock()
      */
     void lock();
 
@@ -103,26 +116,55 @@ public:
      */
     void unblockRerenderZoom();
 
+protected:
+    /**
+     * Blocks until the jobs running when called have finished. This is needed to be sure that no job is using a
+     * source (e.g. a page) which is going to be deleted.
+     *
+     * @param source Only wait for the jobs of this source, or for all the jobs if nullptr
+     */
+    void waitForRunningJobs(void* source = nullptr);
+
 private:
     static auto jobThreadCallback(Scheduler* scheduler) -> gpointer;
     auto getNextJobUnlocked(bool onlyNotRender = false, bool* hasRenderJobs = nullptr) -> Job*;
 
+    /**
+     * Jobs with the same key never run in parallel. Render and preview jobs only use their source, task jobs nothing
+     * but their own state. The other jobs may use the whole document and run one at a time.
+     */
+    static auto getSerializationKey(Job* job) -> void*;
+    bool isRunnableUnlocked(Job* job) const;
+
     static auto jobRenderThreadTimer(Scheduler* scheduler) -> bool;
 
 protected:
+    /// Guarded by jobQueueMutex
     bool threadRunning = true;
 
-    GThread* thread = nullptr;
+    std::vector<GThread*> threads;
 
     std::condition_variable jobQueueCond{};
     std::mutex jobQueueMutex{};
+
+    /// Held between lock() and unlock()
     std::mutex schedulerMutex{};
+    /// No new job is started while the scheduler is locked. Guarded by jobQueueMutex
+    bool paused = false;
+
+    struct RunningJob {
+        uint64_t id;
+        void* serializationKey;
+        void* source;
+        GThread* thread;
+    };
 
     /**
-     * This is need to be sure there is no job running if we delete a page.
-     * If a job is, we may access deleted memory.
+     * The jobs being run, guarded by jobQueueMutex
      */
-    std::mutex jobRunningMutex{};
+    std::vector<RunningJob> runningJobs;
+    uint64_t lastJobId = 0;
+    std::condition_variable jobFinishedCond{};
 
     /**
      * Jobs of each priority. New jobs
@@ -0,0 +1,11 @@
+#include "TaskJob.h"
+
+#include <utility>  // for move
+
+TaskJob::TaskJob(std::function<void()> task): task(std::move(task)) {}
+
+auto TaskJob::getType() -> JobType { return JOB_TYPE_TASK; }
+
+auto TaskJob::getSource() -> void* { return this; }
+
+void TaskJob::run() { this->task(); }
@@ -0,0 +1,38 @@
+/*
+ * Xournal++
+ *
+ * A job which runs a part of a computation shared among the workers
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <functional>  // for function
+
+#include "Job.h"  // for Job, JobType
+
+/**
+ * @brief A Job running a function, so that a computation split in parts (e.g. parsing the pages of a document) uses
+ * the workers of the scheduler instead of threads of its own. Task jobs may run in parallel with any other job.
+ */
+class TaskJob: public Job {
+public:
+    explicit TaskJob(std::function<void()> task);
+
+protected:
+    ~TaskJob() override = default;
+
+public:
+    JobType getType() override;
+
+    void* getSource() override;
+
+    void run() override;
+
+private:
+    std::function<void()> task;
+};
@@ -7,11 +7,13 @@
 
 #include "control/jobs/Scheduler.h"  // for JOB_PRIORITY_URGENT, JOB_PRIORIT...
 
-#include "PreviewJob.h"  // for PreviewJob
-#include "RenderJob.h"   // for RenderJob
+#include "PdfPrefetchJob.h"  // for PdfPrefetchJob
+#include "PreviewJob.h"      // for PreviewJob
+#include "RenderJob.h"       // for RenderJob
 
 class SidebarPreviewBaseEntry;
 class XojPageView;
+class XournalView;
 
 XournalScheduler::XournalScheduler() { this->name = "XournalScheduler"; }
 
@@ -26,6 +28,10 @@ void XournalScheduler::removeSidebar(SidebarPreviewBaseEntry* preview) {
 
 void XournalScheduler::removePage(XojPageView* view) { removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT); }
 
+void XournalScheduler::removePdfPrefetch(XournalView* view) {
+    removeSource(view, JOB_TYPE_PDF_PREFETCH, JOB_PRIORITY_LOW);
+}
+
 void XournalScheduler::removeAllJobs() {
     std::lock_guard lock{this->jobQueueMutex};
 
@@ -36,10 +42,10 @@ void XournalScheduler::removeAllJobs() {
         while (it != queue.end()) {
             Job* job = *it;
 
-            // Only remove PREVIEW and RENDER jobs; we aren't
+            // Only remove PREVIEW, RENDER and PDF_PREFETCH jobs; we aren't
             // responsible for other types of jobs.
             JobType type = job->getType();
-            if (type == JOB_TYPE_PREVIEW || type == JOB_TYPE_RENDER) {
+            if (type == JOB_TYPE_PREVIEW || type == JOB_TYPE_RENDER || type == JOB_TYPE_PDF_PREFETCH) {
                 job->deleteJob();
 
                 it = queue.erase(it);
@@ -53,7 +59,7 @@ void XournalScheduler::removeAllJobs() {
     }
 }
 
-void XournalScheduler::finishTask() { std::lock_guard lock{this->jobRunningMutex}; }
+void XournalScheduler::finishTask() { waitForRunningJobs(); }
 
 void XournalScheduler::removeSource(void* source, JobType type, JobPriority priority, bool awaitFinishTask) {
     {
@@ -77,10 +83,10 @@ void XournalScheduler::removeSource(void* source, JobType type, JobPriority prio
         }
     }
 
-    // wait until the last job is done
+    // wait until the running jobs of this source are done
     // we can be sure we don't access "source"
     if (awaitFinishTask) {
-        finishTask();
+        waitForRunningJobs(source);
     }
 }
 
@@ -108,6 +114,8 @@ void XournalScheduler::addRepaintSidebar(SidebarPreviewBaseEntry* preview) {
     job->unref();
 }
 
+void XournalScheduler::addPdfPrefetch(PdfPrefetchJob* job) { addJob(job, JOB_PRIORITY_LOW); }
+
 void XournalScheduler::addRerenderPage(XojPageView* view) {
     if (existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT)) {
         return;
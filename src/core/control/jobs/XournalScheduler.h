@@ -17,8 +17,10 @@
 
 #include "Scheduler.h"  // for JobPriority, Scheduler
 
+class PdfPrefetchJob;
 class SidebarPreviewBaseEntry;
 class XojPageView;
+class XournalView;
 
 class XournalScheduler: public Scheduler {
 public:
@@ -32,6 +34,7 @@ public:
      */
     void removeSidebar(SidebarPreviewBaseEntry* preview);
     void removePage(XojPageView* view);
+    void removePdfPrefetch(XournalView* view);
 
     /**
      * Removes all PreviewJob%s / RenderJob%s scheduled to be run
@@ -41,6 +44,11 @@ public:
     void addRepaintSidebar(SidebarPreviewBaseEntry* preview);
     void addRerenderPage(XojPageView* view);
 
+    /**
+     * Schedules the job with a low priority: the pages being displayed are rendered first
+     */
+    void addPdfPrefetch(PdfPrefetchJob* job);
+
     /**
      * Blocks until all currently running Job%s have been executed
      */
@@ -6,6 +6,7 @@
 
 #include "control/Control.h"                 // for Control
 #include "control/actions/ActionDatabase.h"  // for ActionDatabase
+#include "control/jobs/AutosaveJournal.h"    // for AutosaveJournal
 #include "gui/MainWindow.h"                  // for MainWindow
 #include "gui/XournalView.h"                 // for XournalView
 #include "model/Document.h"                 // for Document
@@ -364,6 +365,8 @@ void LayerController::setCurrentLayerName(const std::string& newName) {
     } else {  // Any other layer
         page->getSelectedLayer()->setName(newName);
     }
+    // There is no undo action to report the change
+    control->getAutosaveJournal()->pageContentChanged(page);
 
     fireRebuildLayerMenu();
 }
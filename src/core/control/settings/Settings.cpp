@@ -186,10 +186,15 @@ void Settings::loadDefault() {
     this->touchZoomStartThreshold = 0.0;
 
     this->pageRerenderThreshold = 5.0;
-    this->pdfPageCacheSize = 10;
+    this->pdfCacheSize = 128U;
     this->preloadPagesBefore = 3U;
     this->preloadPagesAfter = 5U;
     this->eagerPageCleanup = true;
+    this->loadPagesOnDemand = false;
+    this->saveBinaryStrokes = false;
+    this->imageCacheSize = 256U;
+    this->strokeContourCacheSize = 64U;
+    this->renderThreads = 0U;
 
     this->selectionBorderColor = Colors::red;
     this->selectionMarkerColor = Colors::xopp_cornflowerblue;
@@ -527,14 +532,24 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->touchZoomStartThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pageRerenderThreshold")) == 0) {
         this->pageRerenderThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfPageCacheSize")) == 0) {
-        this->pdfPageCacheSize = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfCacheSize")) == 0) {
+        this->pdfCacheSize = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesBefore")) == 0) {
         this->preloadPagesBefore = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesAfter")) == 0) {
         this->preloadPagesAfter = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("eagerPageCleanup")) == 0) {
         this->eagerPageCleanup = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("loadPagesOnDemand")) == 0) {
+        this->loadPagesOnDemand = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("saveBinaryStrokes")) == 0) {
+        this->saveBinaryStrokes = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("imageCacheSize")) == 0) {
+        this->imageCacheSize = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokeContourCacheSize")) == 0) {
+        this->strokeContourCacheSize = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("renderThreads")) == 0) {
+        this->renderThreads = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionBorderColor")) == 0) {
         this->selectionBorderColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionMarkerColor")) == 0) {
@@ -1136,11 +1151,19 @@ void Settings::save() {
     SAVE_DOUBLE_PROP(touchZoomStartThreshold);
     SAVE_DOUBLE_PROP(pageRerenderThreshold);
 
-    SAVE_INT_PROP(pdfPageCacheSize);
-    ATTACH_COMMENT("The count of rendered PDF pages which will be cached.");
+    SAVE_UINT_PROP(pdfCacheSize);
+    ATTACH_COMMENT("The memory for rendered PDF pages, in MiB.");
     SAVE_UINT_PROP(preloadPagesBefore);
     SAVE_UINT_PROP(preloadPagesAfter);
     SAVE_BOOL_PROP(eagerPageCleanup);
+    SAVE_BOOL_PROP(loadPagesOnDemand);
+    SAVE_BOOL_PROP(saveBinaryStrokes);
+    SAVE_UINT_PROP(imageCacheSize);
+    ATTACH_COMMENT("The memory for decoded images, in MiB.");
+    SAVE_UINT_PROP(strokeContourCacheSize);
+    ATTACH_COMMENT("The memory for the contours of strokes with pressure, in MiB.");
+    SAVE_UINT_PROP(renderThreads);
+    ATTACH_COMMENT("The number of threads rendering the pages, 0 to choose it from the number of processors.");
 
     SAVE_STRING_PROP(pageTemplate);
     ATTACH_COMMENT("Config for new pages");
@@ -2104,13 +2127,13 @@ void Settings::setPDFPageRerenderThreshold(double threshold) {
     save();
 }
 
-auto Settings::getPdfPageCacheSize() const -> int { return this->pdfPageCacheSize; }
+auto Settings::getPdfCacheSize() const -> unsigned int { return this->pdfCacheSize; }
 
-void Settings::setPdfPageCacheSize(int size) {
-    if (this->pdfPageCacheSize == size) {
+void Settings::setPdfCacheSize(unsigned int size) {
+    if (this->pdfCacheSize == size) {
         return;
     }
-    this->pdfPageCacheSize = size;
+    this->pdfCacheSize = size;
     save();
 }
 
@@ -2144,6 +2167,56 @@ void Settings::setEagerPageCleanup(bool b) {
     save();
 }
 
+auto Settings::isLoadPagesOnDemand() const -> bool { return this->loadPagesOnDemand; }
+
+void Settings::setLoadPagesOnDemand(bool b) {
+    if (this->loadPagesOnDemand == b) {
+        return;
+    }
+    this->loadPagesOnDemand = b;
+    save();
+}
+
+auto Settings::isSaveBinaryStrokes() const -> bool { return this->saveBinaryStrokes; }
+
+void Settings::setSaveBinaryStrokes(bool b) {
+    if (this->saveBinaryStrokes == b) {
+        return;
+    }
+    this->saveBinaryStrokes = b;
+    save();
+}
+
+auto Settings::getImageCacheSize() const -> unsigned int { return this->imageCacheSize; }
+
+void Settings::setImageCacheSize(unsigned int size) {
+    if (this->imageCacheSize == size) {
+        return;
+    }
+    this->imageCacheSize = size;
+    save();
+}
+
+auto Settings::getStrokeContourCacheSize() const -> unsigned int { return this->strokeContourCacheSize; }
+
+void Settings::setStrokeContourCacheSize(unsigned int size) {
+    if (this->strokeContourCacheSize == size) {
+        return;
+    }
+    this->strokeContourCacheSize = size;
+    save();
+}
+
+auto Settings::getRenderThreads() const -> unsigned int { return this->renderThreads; }
+
+void Settings::setRenderThreads(unsigned int threads) {
+    if (this->renderThreads == threads) {
+        return;
+    }
+    this->renderThreads = threads;
+    save();
+}
+
 auto Settings::getBorderColor() const -> Color { return this->selectionBorderColor; }
 
 void Settings::setBorderColor(Color color) {
@@ -396,8 +396,8 @@ public:
     double getTouchZoomStartThreshold() const;
     void setTouchZoomStartThreshold(double threshold);
 
-    int getPdfPageCacheSize() const;
-    [[maybe_unused]] void setPdfPageCacheSize(int size);
+    unsigned int getPdfCacheSize() const;
+    [[maybe_unused]] void setPdfCacheSize(unsigned int size);
 
     unsigned int getPreloadPagesBefore() const;
     void setPreloadPagesBefore(unsigned int n);
@@ -408,6 +408,21 @@ public:
     bool isEagerPageCleanup() const;
     void setEagerPageCleanup(bool b);
 
+    bool isLoadPagesOnDemand() const;
+    void setLoadPagesOnDemand(bool b);
+
+    bool isSaveBinaryStrokes() const;
+    void setSaveBinaryStrokes(bool b);
+
+    unsigned int getImageCacheSize() const;
+    void setImageCacheSize(unsigned int size);
+
+    unsigned int getStrokeContourCacheSize() const;
+    [[maybe_unused]] void setStrokeContourCacheSize(unsigned int size);
+
+    unsigned int getRenderThreads() const;
+    void setRenderThreads(unsigned int threads);
+
     std::string const& getPageTemplate() const;
     void setPageTemplate(const std::string& pageTemplate);
 
@@ -968,9 +983,9 @@ private:
     std::vector<ViewMode> viewModes;
 
     /**
-     *  The count of pages which will be cached
+     * The memory for the rendered PDF pages, in MiB
      */
-    int pdfPageCacheSize{};
+    unsigned int pdfCacheSize{};
 
     /**
      *  Percentage by which the page's zoom must change
@@ -1158,6 +1173,31 @@ private:
      */
     bool eagerPageCleanup{};
 
+    /**
+     * Whether to parse the contents of the pages only when they are displayed, and to free them on low memory.
+     */
+    bool loadPagesOnDemand{};
+
+    /**
+     * Whether to save the points of the strokes in binary form. Such files cannot be read by older versions.
+     */
+    bool saveBinaryStrokes{};
+
+    /**
+     * The memory for the decoded images, in MiB. The least recently used images are decoded again when needed.
+     */
+    unsigned int imageCacheSize{};
+
+    /**
+     * The memory for the contours of the strokes with pressure, in MiB
+     */
+    unsigned int strokeContourCacheSize{};
+
+    /**
+     * The number of threads rendering the pages in the background, 0 to choose it from the number of processors
+     */
+    unsigned int renderThreads{};
+
     /**
      * Stabilizer related settings
      */
@@ -48,9 +48,9 @@ auto CircleRecognizer::scoreCircle(Stroke* s, Inertia& inertia) -> double {
     double x0 = inertia.centerX();
     double y0 = inertia.centerY();
 
-    auto const& pv = s->getPointVector();
-    for (auto pt_1st = begin(pv), pt_2nd = std::next(pt_1st), p_end_i = end(pv); pt_1st != p_end_i && pt_2nd != p_end_i;
-         ++pt_2nd, ++pt_1st) {
+    auto pv = s->getPoints();
+    for (auto pt_1st = pv.begin(), pt_2nd = std::next(pt_1st), p_end_i = pv.end();
+         pt_1st != p_end_i && pt_2nd != p_end_i; ++pt_2nd, ++pt_1st) {
         double dm = hypot(pt_2nd->x - pt_1st->x, pt_2nd->y - pt_1st->y);
         double deltar = hypot(pt_1st->x - x0, pt_1st->y - y0) - r0;
         sum += dm * fabs(deltar);
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include "model/PointView.h"  // for PointView
+
 class Point;
 
 class Inertia {
@@ -34,7 +36,7 @@ public:
     double getMass() const;
 
     void increase(Point p1, Point p2, int coef);
-    void calc(const Point* pt, int start, int end);
+    void calc(PointView pt, int start, int end);
 
 private:
     double mass{};
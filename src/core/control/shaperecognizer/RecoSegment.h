@@ -11,6 +11,7 @@
 #pragma once
 
 #include "model/Point.h"
+#include "model/PointView.h"
 
 class Stroke;
 class Inertia;
@@ -21,7 +22,7 @@ struct RecoSegment final {
     /**
      * Find the geometry of a recognized segment
      */
-    void calcSegmentGeometry(const Point* pt, int start, int end, Inertia* s);
+    void calcSegmentGeometry(PointView pt, int start, int end, Inertia* s);
 
     Stroke* stroke{nullptr};
     int startpt{0};
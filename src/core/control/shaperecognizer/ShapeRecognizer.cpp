@@ -176,7 +176,7 @@ auto ShapeRecognizer::tryRectangle() -> std::unique_ptr<Stroke> {
 /*
  * check if something is a polygonal line with at most nsides sides
  */
-auto ShapeRecognizer::findPolygonal(const Point* pt, int start, int end, int nsides, int* breaks, Inertia* ss) -> int {
+auto ShapeRecognizer::findPolygonal(PointView pt, int start, int end, int nsides, int* breaks, Inertia* ss) -> int {
     Inertia s;
     int i1 = 0, i2 = 0, n1 = 0, n2 = 0;
 
@@ -268,7 +268,7 @@ auto ShapeRecognizer::findPolygonal(const Point* pt, int start, int end, int nsi
 /**
  * Improve on the polygon found by find_polygonal()
  */
-void ShapeRecognizer::optimizePolygonal(const Point* pt, int nsides, int* breaks, Inertia* ss) {
+void ShapeRecognizer::optimizePolygonal(PointView pt, int nsides, int* breaks, Inertia* ss) {
     for (int i = 1; i < nsides; i++) {
         // optimize break between sides i and i+1
         double cost = ss[i - 1].det() * ss[i - 1].det() + ss[i].det() * ss[i].det();
@@ -342,8 +342,8 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke, double strokeMinSize) ->
     int brk[5] = {0};
 
     // first see if it's a polygon
-    int n = findPolygonal(stroke->getPoints(), 0, static_cast<int>(stroke->getPointCount()) - 1, MAX_POLYGON_SIDES, brk,
-                          ss);
+    int n = findPolygonal(stroke->getPoints(), 0, static_cast<int>(stroke->getPointCount()) - 1,
+                          MAX_POLYGON_SIDES, brk, ss);
     if (n > 0) {
         optimizePolygonal(stroke->getPoints(), n, brk, ss);
 #ifdef DEBUG_RECOGNIZER
@@ -411,7 +411,7 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke, double strokeMinSize) ->
                 const Point P(rs->x1, rs->y1);
                 const Point Q(rs->x2, rs->y2);
 
-                const auto& points = stroke->getPointVector();
+                auto points = stroke->getPoints();
                 const Point& last = points.back();
 
                 const double dx = Q.x - P.x;
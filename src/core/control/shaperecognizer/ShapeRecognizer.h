@@ -14,6 +14,8 @@
 #include <array>  // for array
 #include <memory>
 
+#include "model/PointView.h"  // for PointView
+
 #include "RecoSegment.h"
 #include "ShapeRecognizerConfig.h"  // for MAX_POLYGON_SIDES
 
@@ -36,9 +38,9 @@ private:
 
     // function Stroke* tryArrow(); removed after commit a3f7a251282dcfea8b4de695f28ce52bf2035da2
 
-    static void optimizePolygonal(const Point* pt, int nsides, int* breaks, Inertia* ss);
+    static void optimizePolygonal(PointView pt, int nsides, int* breaks, Inertia* ss);
 
-    int findPolygonal(const Point* pt, int start, int end, int nsides, int* breaks, Inertia* ss);
+    int findPolygonal(PointView pt, int start, int end, int nsides, int* breaks, Inertia* ss);
 
     static bool isStrokeLargeEnough(Stroke* stroke, double strokeMinSize);
 
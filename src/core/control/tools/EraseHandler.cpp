@@ -21,6 +21,7 @@
 #include "undo/EraseUndoAction.h"         // for EraseUndoAction
 #include "undo/UndoRedoHandler.h"         // for UndoRedoHandler
 #include "util/Range.h"                   // for Range
+#include "util/Rectangle.h"               // for Rectangle
 #include "util/SmallVector.h"             // for SmallVector
 
 EraseHandler::EraseHandler(UndoRedoHandler* undo, Document* doc, const PageRef& page, ToolHandler* handler,
@@ -52,7 +53,10 @@ void EraseHandler::erase(double x, double y) {
 
     Layer* l = page->getSelectedLayer();
 
-    for (Element* e: xoj::refElementContainer(l->getElements())) {
+    // The eraser rectangle is rounded to integers: look one unit further for candidates
+    const xoj::util::Rectangle<double> candidateArea(x - halfEraserSize - 1, y - halfEraserSize - 1,
+                                                     2 * halfEraserSize + 2, 2 * halfEraserSize + 2);
+    for (Element* e: l->getElementsInArea(candidateArea)) {
         if (e->getType() == ELEMENT_STROKE && e->intersectsArea(&eraserRect)) {
             eraseStroke(l, dynamic_cast<Stroke*>(e), x, y, range);
         }
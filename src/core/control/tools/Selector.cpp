@@ -10,6 +10,7 @@
 #include "model/Document.h"        // for Document
 #include "model/Layer.h"           // for Layer
 #include "model/XojPage.h"         // for XojPage
+#include "util/Rectangle.h"        // for Rectangle
 #include "util/safe_casts.h"       // for as_unsigned
 
 Selector::Selector(bool multiLayer):
@@ -21,6 +22,28 @@ auto Selector::finalize(PageRef page, bool disableMultilayer, Document* doc) ->
     this->page = page;
     size_t layerId = 0;
 
+    // Only the elements overlapping the bounding box of the selection can be in the selection
+    auto selectOnLayer = [&](const Layer* l) {
+        auto candidates = l->getElementsInArea(xoj::util::Rectangle<double>(this->bbox));
+        auto candidate = candidates.begin();
+        bool selectionOnLayer = false;
+        Element::Index pos = 0;
+        for (const auto& e: l->getElementsView()) {
+            if (candidate == candidates.end()) {
+                break;
+            }
+            if (e == *candidate) {
+                if (e->isInSelection(this)) {
+                    this->selectedElements.emplace_back(e, pos);
+                    selectionOnLayer = true;
+                }
+                ++candidate;
+            }
+            pos++;
+        }
+        return selectionOnLayer;
+    };
+
     if (multiLayer && !disableMultilayer) {
         std::lock_guard lock(*doc);
         const auto layers = page->getLayersView();
@@ -29,16 +52,7 @@ auto Selector::finalize(PageRef page, bool disableMultilayer, Document* doc) ->
             if (!l->isVisible()) {
                 continue;
             }
-            bool selectionOnLayer = false;
-            Element::Index pos = 0;
-            for (const auto& e: l->getElementsView()) {
-                if (e->isInSelection(this)) {
-                    this->selectedElements.emplace_back(e, pos);
-                    selectionOnLayer = true;
-                }
-                pos++;
-            }
-            if (selectionOnLayer) {
+            if (selectOnLayer(l)) {
                 layerId = layers.size() - as_unsigned(std::distance(layers.rbegin(), it));
                 break;
             }
@@ -46,13 +60,8 @@ auto Selector::finalize(PageRef page, bool disableMultilayer, Document* doc) ->
     } else {
         std::lock_guard lock(*doc);
         const Layer* l = page->getSelectedLayer();
-        Element::Index pos = 0;
-        for (const auto& e: l->getElementsView()) {
-            if (e->isInSelection(this)) {
-                this->selectedElements.emplace_back(e, pos);
-                layerId = page->getSelectedLayerId();
-            }
-            pos++;
+        if (selectOnLayer(l)) {
+            layerId = page->getSelectedLayerId();
         }
     }
 
@@ -23,6 +23,7 @@
 #include "util/Assert.h"
 #include "util/DispatchPool.h"
 #include "util/Range.h"
+#include "util/Rectangle.h"
 #include "util/glib_casts.h"  // for wrap_for_once_v
 #include "util/gtk4_helper.h"
 #include "util/raii/CStringWrapper.h"
@@ -1062,11 +1063,12 @@ void TextEditor::initializeEditionAt(double x, double y) {
     Text* text = nullptr;
 
     // Should we reverse this loop to select the most recent text rather than the oldest?
-    for (auto&& e: this->page->getSelectedLayer()->getElements()) {
+    const xoj::util::Rectangle<double> area(x - 1, y - 1, 2, 2);
+    for (Element* e: this->page->getSelectedLayer()->getElementsInArea(area)) {
         if (e->getType() == ELEMENT_TEXT) {
             GdkRectangle matchRect = {gint(x), gint(y), 1, 1};
             if (e->intersectsArea(&matchRect)) {
-                text = dynamic_cast<Text*>(e.get());
+                text = dynamic_cast<Text*>(e);
                 break;
             }
         }
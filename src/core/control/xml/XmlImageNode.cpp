@@ -22,6 +22,15 @@ void XmlImageNode::setImage(cairo_surface_t* img) {
         cairo_surface_destroy(this->img);
     }
     this->img = cairo_surface_reference(img);
+    this->pngData = {};
+}
+
+void XmlImageNode::setPngData(std::string_view data) {
+    if (this->img) {
+        cairo_surface_destroy(this->img);
+        this->img = nullptr;
+    }
+    this->pngData = data;
 }
 
 auto XmlImageNode::pngWriteFunction(XmlImageNode* image, const unsigned char* data, unsigned int length)
@@ -46,12 +55,18 @@ void XmlImageNode::writeOut(OutputStream* out) {
 
     out->write(">");
 
-    if (this->img == nullptr) {
+    if (this->img == nullptr && this->pngData.empty()) {
         g_error("XmlImageNode::writeOut(); this->img == nullptr");
     } else {
         this->out = out;
         this->pos = 0;
-        cairo_surface_write_to_png_stream(this->img, reinterpret_cast<cairo_write_func_t>(&pngWriteFunction), this);
+        if (this->img) {
+            cairo_surface_write_to_png_stream(this->img, reinterpret_cast<cairo_write_func_t>(&pngWriteFunction),
+                                              this);
+        } else {
+            pngWriteFunction(this, reinterpret_cast<const unsigned char*>(this->pngData.data()),
+                             static_cast<unsigned int>(this->pngData.size()));
+        }
         gchar* base64_str = g_base64_encode(this->buffer, this->pos);
         out->write(base64_str);
         g_free(base64_str);
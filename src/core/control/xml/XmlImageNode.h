@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <string_view>  // for string_view
+
 #include <cairo.h>  // for cairo_surface_t, cairo_status_t
 
 #include "XmlNode.h"  // for XmlNode
@@ -25,12 +27,19 @@ public:
 public:
     void setImage(cairo_surface_t* img);
 
+    /**
+     * Writes already encoded PNG data instead of encoding a surface. The data is not copied: it must stay valid until
+     * the node is written.
+     */
+    void setPngData(std::string_view data);
+
     static cairo_status_t pngWriteFunction(XmlImageNode* image, const unsigned char* data, unsigned int length);
 
     void writeOut(OutputStream* out) override;
 
 private:
     cairo_surface_t* img;
+    std::string_view pngData;
 
     OutputStream* out;
     unsigned int pos;
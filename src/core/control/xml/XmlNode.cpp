@@ -71,6 +71,23 @@ void XmlNode::writeOut(OutputStream* out, ProgressListener* listener) {
     }
 }
 
+void XmlNode::writeOpeningTag(OutputStream* out) {
+    out->write("<");
+    out->write(tag);
+    writeAttributes(out);
+    out->write(">\n");
+
+    for (auto& node: children) {
+        node->writeOut(out);
+    }
+}
+
+void XmlNode::writeClosingTag(OutputStream* out) {
+    out->write("</");
+    out->write(tag);
+    out->write(">\n");
+}
+
 void XmlNode::addChild(XmlNode* node) { children.emplace_back(node); }
 
 void XmlNode::putAttrib(XMLAttribute* a) {
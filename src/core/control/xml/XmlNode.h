@@ -38,6 +38,13 @@ public:
 
     virtual void writeOut(OutputStream* out) { writeOut(out, nullptr); }
 
+    /**
+     * Streaming output: writes the start tag and the children added so far, but leaves the element open
+     * so that further content can be written directly to the stream. Finish with writeClosingTag().
+     */
+    void writeOpeningTag(OutputStream* out);
+    void writeClosingTag(OutputStream* out);
+
     void addChild(XmlNode* node);
 
 protected:
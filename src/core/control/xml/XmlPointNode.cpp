@@ -1,15 +1,14 @@
 #include "XmlPointNode.h"
 
-#include <algorithm>  // for max
-#include <utility>    // for move
+#include <string>  // for string
 
 #include "control/xml/XmlAudioNode.h"  // for XmlAudioNode
 #include "util/OutputStream.h"         // for OutputStream
-#include "util/Util.h"                 // for writeCoordinateString
+#include "util/Util.h"                 // for appendDoubleString
 
 XmlPointNode::XmlPointNode(const char* tag): XmlAudioNode(tag) {}
 
-void XmlPointNode::setPoints(std::vector<Point> pts) { this->points = std::move(pts); }
+void XmlPointNode::setPoints(PointView pts) { this->points = pts; }
 
 void XmlPointNode::writeOut(OutputStream* out) {
     /** Write stroke and its attributes */
@@ -19,13 +18,18 @@ void XmlPointNode::writeOut(OutputStream* out) {
 
     out->write(">");
 
-    auto pointIter = points.begin();
-    Util::writeCoordinateString(out, pointIter->x, pointIter->y);
-    ++pointIter;
-    for (; pointIter != points.end(); ++pointIter) {
-        out->write(" ");
-
-        Util::writeCoordinateString(out, pointIter->x, pointIter->y);
+    if (!points.empty()) {
+        // Format the whole stroke into one buffer and write it at once
+        std::string coords;
+        coords.reserve(points.size() * 24);
+        for (const Point& p: points) {
+            Util::appendDoubleString(coords, p.x);
+            coords += ' ';
+            Util::appendDoubleString(coords, p.y);
+            coords += ' ';
+        }
+        coords.pop_back();
+        out->write(coords);
     }
 
     out->write("</");
@@ -11,9 +11,8 @@
 
 #pragma once
 
-#include <vector>  // for vector
-
-#include "model/Point.h"  // for Point
+#include "model/Point.h"      // for Point
+#include "model/PointView.h"  // for PointView
 
 #include "XmlAudioNode.h"  // for XmlAudioNode
 
@@ -24,9 +23,12 @@ public:
     XmlPointNode(const char* tag);
 
 public:
-    void setPoints(std::vector<Point> points);
+    /**
+     * The points are not copied: the points must outlive the call to writeOut()
+     */
+    void setPoints(PointView points);
     void writeOut(OutputStream* out) override;
 
 private:
-    std::vector<Point> points{};
+    PointView points;
 };
@@ -1,18 +1,26 @@
 #include "LoadHandler.h"
 
-#include <algorithm>    // for copy
-#include <cmath>        // for isnan
-#include <cstdlib>      // for atoi, size_t
-#include <cstring>      // for strcmp, strlen
-#include <iterator>     // for back_inserter
-#include <memory>       // for __shared_ptr_access
-#include <regex>        // for regex_search, smatch
-#include <type_traits>  // for remove_reference<>::type
-#include <utility>      // for move
+#include <algorithm>           // for copy, all_of, min
+#include <atomic>              // for atomic_flag
+#include <charconv>            // for from_chars
+#include <cmath>               // for isnan
+#include <condition_variable>  // for condition_variable
+#include <cstdlib>             // for atoi, size_t
+#include <cstring>             // for strcmp, strlen
+#include <iterator>            // for back_inserter
+#include <memory>              // for __shared_ptr_access
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <regex>               // for regex_search, smatch
+#include <type_traits>         // for remove_reference<>::type
+#include <utility>             // for move, exchange
+#include <vector>              // for vector
 
 #include <gio/gio.h>      // for g_file_get_path, g_fil...
 #include <glib-object.h>  // for g_object_unref
 
+#include "control/jobs/AutosaveJournal.h"      // for AutosaveJournal
+#include "control/jobs/Scheduler.h"            // for Scheduler, JOB_PRIORITY_URGENT
+#include "control/jobs/TaskJob.h"              // for TaskJob
 #include "control/pagetype/PageTypeHandler.h"  // for PageTypeHandler
 #include "model/BackgroundImage.h"             // for BackgroundImage
 #include "model/Font.h"                        // for XojFont
@@ -30,6 +38,7 @@
 #include "util/LoopUtil.h"
 #include "util/PlaceholderString.h"  // for PlaceholderString
 #include "util/StringUtils.h"        // for char_cast
+#include "util/Util.h"               // for parseDouble, countTokens
 #include "util/i18n.h"               // for _F, FC, FS, _
 #include "util/raii/GObjectSPtr.h"
 #include "util/safe_casts.h"  // for as_signed, as_unsigned
@@ -52,6 +61,74 @@ using std::string;
 namespace {
 constexpr size_t MAX_VERSION_LENGTH = 50;
 constexpr size_t MAX_MIMETYPE_LENGTH = 25;
+
+/**
+ * Find the next opening tag `<tag ...>` in the document content.
+ * Special characters are always escaped in text and attributes, so a plain search for the tag is enough.
+ */
+size_t findOpeningTag(std::string_view content, std::string_view tag, size_t pos) {
+    auto isTagNameEnd = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '>' || c == '/'; };
+
+    size_t start = content.find(tag, pos);
+    while (start != std::string_view::npos &&
+           (start + tag.size() >= content.size() || !isTagNameEnd(content[start + tag.size()]))) {
+        start = content.find(tag, start + 1);
+    }
+    return start;
+}
+
+/**
+ * Get the value of the attribute `name` of an opening tag written by SaveHandler, which does not need unescaping
+ */
+std::string_view getTagAttribute(std::string_view tag, std::string_view name) {
+    size_t start = tag.find(" " + std::string(name) + "=\"");
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    start += name.size() + 3;
+    size_t end = tag.find('"', start);
+    if (end == std::string_view::npos) {
+        return {};
+    }
+    return tag.substr(start, end - start);
+}
+
+/**
+ * Find the top-level <page> elements of the document content.
+ * @param prefixEnd Set to the start of the first page
+ * @param suffixStart Set to the end of the last page
+ * @return false if there are no pages, or if something other than whitespace lies between two pages
+ */
+bool findPageChunks(std::string_view content, std::vector<std::string_view>& chunks, size_t& prefixEnd,
+                    size_t& suffixStart) {
+    constexpr std::string_view closeTag = "</page>";
+    auto isSpace = [](char c) { return g_ascii_isspace(c) != 0; };
+
+    size_t pos = 0;
+    for (;;) {
+        size_t start = findOpeningTag(content, "<page", pos);
+        if (start == std::string_view::npos) {
+            break;
+        }
+
+        if (chunks.empty()) {
+            prefixEnd = start;
+        } else if (!std::all_of(content.begin() + as_signed(pos), content.begin() + as_signed(start), isSpace)) {
+            return false;
+        }
+
+        size_t end = content.find(closeTag, start);
+        if (end == std::string_view::npos) {
+            return false;
+        }
+        end += closeTag.size();
+        chunks.emplace_back(content.substr(start, end - start));
+        pos = end;
+    }
+    suffixStart = pos;
+
+    return !chunks.empty();
+}
 }  // namespace
 
 LoadHandler::LoadHandler():
@@ -77,6 +154,21 @@ LoadHandler::LoadHandler():
     initAttributes();
 }
 
+LoadHandler::LoadHandler(LoadHandler* parent): LoadHandler() {
+    this->parent = parent;
+    this->filepath = parent->filepath;
+    this->xournalFilepath = parent->xournalFilepath;
+    this->fileVersion = parent->fileVersion;
+    this->minimalFileVersion = parent->minimalFileVersion;
+    this->isGzFile = parent->isGzFile;
+    this->zipFp = parent->zipFp;
+    this->pos = PARSER_POS_STARTED;
+    this->deferBackgrounds = true;
+
+    g_hash_table_unref(this->audioFiles);
+    this->audioFiles = g_hash_table_ref(parent->audioFiles);
+}
+
 LoadHandler::~LoadHandler() {
     if (this->audioFiles) {
         g_hash_table_unref(this->audioFiles);
@@ -138,7 +230,7 @@ auto LoadHandler::openFile(fs::path const& filepath) -> bool {
         char mimetype[MAX_MIMETYPE_LENGTH + 1] = {};
         // read the mimetype and a few more bytes to make sure we do not only read a subset
         zip_fread(mimetypeFp, mimetype, MAX_MIMETYPE_LENGTH);
-        if (!strcmp(mimetype, "application/xournal++")) {
+        if (std::string_view(mimetype).find("application/xournal++") == std::string_view::npos) {
             zip_fclose(mimetypeFp);
             this->lastError = FS(_F("The file is no valid .xopp file (Mimetype wrong): \"{1}\"") % filepath.u8string());
             return false;
@@ -213,6 +305,332 @@ auto LoadHandler::readContentFile(char* buffer, zip_uint64_t len) -> zip_int64_t
     return -1;
 }
 
+auto LoadHandler::readContent() -> std::string {
+    std::string content;
+
+    // The size of content.xml is known: inflate it into the buffer directly
+    zip_stat_t stat;
+    if (!this->isGzFile && zip_stat(this->zipFp, "content.xml", 0, &stat) == 0 && (stat.valid & ZIP_STAT_SIZE)) {
+        content.resize(stat.size);
+        zip_uint64_t readBytes = 0;
+        zip_int64_t len = 0;
+        while (readBytes < stat.size &&
+               (len = readContentFile(content.data() + readBytes, stat.size - readBytes)) > 0) {
+            readBytes += static_cast<zip_uint64_t>(len);
+        }
+        content.resize(readBytes);
+        return content;
+    }
+
+    // Otherwise read into the buffer directly, growing it as needed
+    constexpr size_t MAX_READ_LENGTH = 1 << 30;
+    size_t size = 0;
+    content.resize(1 << 16);
+    zip_int64_t len = 0;
+    while ((len = readContentFile(content.data() + size, std::min(content.size() - size, MAX_READ_LENGTH))) > 0) {
+        size += static_cast<size_t>(len);
+        if (size == content.size()) {
+            content.resize(2 * size);
+        }
+    }
+    content.resize(size);
+    return content;
+}
+
+auto LoadHandler::parseXmlChunk(GMarkupParseContext* context, const char* data, size_t len) -> bool {
+    if (len == 0) {
+        return true;
+    }
+
+    gboolean valid = g_markup_parse_context_parse(context, data, static_cast<gssize>(len), &error);
+    if (error) {
+        if (!this->parent) {
+            g_warning("LoadHandler::parseXml: %s\n", error->message);
+        }
+        return false;
+    }
+    return valid;
+}
+
+auto LoadHandler::parsePagesParallel(const std::vector<std::string_view>& chunks)
+        -> std::vector<std::unique_ptr<LoadHandler>> {
+    /*
+     * The calling thread parses the pages, helped by the workers of the scheduler as they become free. The helpers
+     * starting once all the pages are taken return right away: they only access the shared state, which outlives
+     * this call.
+     */
+    struct State {
+        explicit State(size_t count): count(count) {}
+
+        const size_t count;
+        std::mutex mutex;
+        std::condition_variable idle;
+        size_t next = 0;
+        /// The number of pages being parsed
+        size_t active = 0;
+        bool failed = false;
+    };
+    auto state = std::make_shared<State>(chunks.size());
+    std::vector<std::unique_ptr<LoadHandler>> workers(chunks.size());
+
+    auto work = [state, this, &chunks, &workers]() {
+        const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
+                                      LoadHandler::parserText, nullptr, nullptr};
+        while (true) {
+            size_t i = 0;
+            {
+                std::lock_guard lock(state->mutex);
+                if (state->next == state->count || state->failed) {
+                    return;
+                }
+                i = state->next++;
+                state->active++;
+            }
+
+            std::unique_ptr<LoadHandler> worker(new LoadHandler(this));
+
+            GMarkupParseContext* context =
+                    g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), worker.get(), nullptr);
+            bool valid = worker->parseXmlChunk(context, chunks[i].data(), chunks[i].size()) &&
+                         g_markup_parse_context_end_parse(context, &worker->error);
+            g_markup_parse_context_free(context);
+
+            if (!valid || worker->error) {
+                g_clear_error(&worker->error);
+                valid = false;
+            } else {
+                workers[i] = std::move(worker);
+            }
+
+            {
+                std::lock_guard lock(state->mutex);
+                state->failed = state->failed || !valid;
+                state->active--;
+            }
+            state->idle.notify_all();
+        }
+    };
+
+    // The scheduler bounds the number of helpers running at once, the pages are shared among those which start
+    size_t helperCount = std::min(this->scheduler->getWorkerCount(), chunks.size() - 1);
+    for (size_t i = 0; i < helperCount; i++) {
+        auto* job = new TaskJob(work);
+        this->scheduler->addJob(job, JOB_PRIORITY_URGENT);
+        job->unref();
+    }
+    work();
+
+    std::unique_lock lock(state->mutex);
+    state->idle.wait(lock, [&state]() { return state->active == 0; });
+
+    if (state->failed) {
+        return {};
+    }
+    return workers;
+}
+
+void LoadHandler::addParsedPages(std::vector<std::unique_ptr<LoadHandler>> workers) {
+    for (auto& worker: workers) {
+        for (size_t i = 0; i < worker->pages.size(); i++) {
+            this->page = worker->pages[i];
+            this->pages.push_back(this->page);
+
+            // Replay the <background> elements as if the page had been parsed here
+            this->pos = PARSER_POS_IN_PAGE;
+            for (const AttributeList& attributes: worker->deferredBackgrounds[i]) {
+                std::vector<const gchar*> names;
+                std::vector<const gchar*> values;
+                for (const auto& [name, value]: attributes) {
+                    names.emplace_back(name.c_str());
+                    values.emplace_back(value.c_str());
+                }
+                names.emplace_back(nullptr);
+                values.emplace_back(nullptr);
+
+                this->attributeNames = names.data();
+                this->attributeValues = values.data();
+                this->elementName = "background";
+                parsePage();
+                this->attributeNames = nullptr;
+                this->attributeValues = nullptr;
+                this->elementName = nullptr;
+
+                if (this->error) {
+                    return;
+                }
+            }
+            this->pos = PARSER_POS_STARTED;
+            this->page = nullptr;
+        }
+    }
+}
+
+LoadHandler::PageSource::~PageSource() {
+    if (this->audioFiles) {
+        g_hash_table_unref(this->audioFiles);
+    }
+}
+
+auto LoadHandler::parsePagesLazily(GMarkupParseContext* context, const std::shared_ptr<PageSource>& source,
+                                   const std::vector<std::string_view>& chunks) -> bool {
+    source->filepath = this->filepath;
+    source->xournalFilepath = this->xournalFilepath;
+    source->fileVersion = this->fileVersion;
+    source->isGzFile = this->isGzFile;
+    source->audioFiles = g_hash_table_ref(this->audioFiles);
+    source->reportError = this->lazyLoadingErrorHandler;
+
+    constexpr std::string_view pageEnd = "</page>";
+    for (std::string_view chunk: chunks) {
+        // The page header (size and backgrounds) is parsed now, since it may load the PDF or refer to previous pages.
+        // Pages reading from the archive are parsed completely.
+        size_t headerEnd = findOpeningTag(chunk, "<layer", 0);
+        if (headerEnd == std::string_view::npos || chunk.find("<attachment") != std::string_view::npos ||
+            chunk.find(" pointdata=") != std::string_view::npos) {
+            if (!parseXmlChunk(context, chunk.data(), chunk.size())) {
+                return false;
+            }
+            continue;
+        }
+
+        if (!parseXmlChunk(context, chunk.data(), headerEnd) ||
+            !parseXmlChunk(context, pageEnd.data(), pageEnd.size())) {
+            return false;
+        }
+
+        size_t offset = static_cast<size_t>(chunk.data() - source->content.data());
+        // The copies of the page share the loader: the user is told once
+        auto reported = std::make_shared<std::atomic_flag>();
+        this->pages.back()->setLayerLoader([source, offset, length = chunk.size(), reported](std::string& error) {
+            auto layers = parseLayers(*source, std::string_view(source->content).substr(offset, length), error);
+            if (!error.empty() && source->reportError && !reported->test_and_set()) {
+                source->reportError(FS(_F("A page of the file \"{1}\" could not be read completely: {2}\nOnly the "
+                                          "content read before the error is shown, and saving the document will drop "
+                                          "the rest.") %
+                                       source->filepath.u8string() % error));
+            }
+            return layers;
+        });
+    }
+    return true;
+}
+
+auto LoadHandler::parseLayers(const PageSource& source, std::string_view chunk, std::string& error)
+        -> std::vector<Layer*> {
+    std::vector<Layer*> layers;
+    auto pages = parsePages(source, chunk, error);
+    if (!pages.empty()) {
+        std::swap(layers, pages.front()->layer);
+    }
+    return layers;
+}
+
+auto LoadHandler::parsePages(const PageSource& source, std::string_view chunk, std::string& error)
+        -> std::vector<PageRef> {
+    LoadHandler handler;
+    handler.filepath = source.filepath;
+    handler.xournalFilepath = source.xournalFilepath;
+    handler.fileVersion = source.fileVersion;
+    handler.isGzFile = source.isGzFile;
+    handler.pos = PARSER_POS_STARTED;
+    // The backgrounds were parsed when loading the document
+    handler.deferBackgrounds = true;
+
+    g_hash_table_unref(handler.audioFiles);
+    handler.audioFiles = g_hash_table_ref(source.audioFiles);
+
+    const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
+                                  LoadHandler::parserText, nullptr, nullptr};
+    GMarkupParseContext* context =
+            g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), &handler, nullptr);
+    if (g_markup_parse_context_parse(context, chunk.data(), static_cast<gssize>(chunk.size()), &handler.error)) {
+        g_markup_parse_context_end_parse(context, &handler.error);
+    }
+    g_markup_parse_context_free(context);
+
+    if (handler.error) {
+        // The layers were not validated when loading the document: keep what could be parsed
+        g_warning("LoadHandler::parsePages: %s\n", handler.error->message);
+        error = handler.error->message;
+        g_clear_error(&handler.error);
+    }
+
+    return std::move(handler.pages);
+}
+
+void LoadHandler::replayJournal() {
+    fs::path journalPath = AutosaveJournal::getJournalPath(this->filepath);
+    if (!fs::exists(journalPath)) {
+        return;
+    }
+
+    gzFile fp = GzUtil::openPath(journalPath, "r");
+    if (!fp) {
+        g_warning("LoadHandler::replayJournal: could not open %s\n", char_cast(journalPath.u8string().c_str()));
+        return;
+    }
+    std::string content;
+    char buffer[4096];
+    int len = 0;
+    // Reading stops at a partial record written while crashing
+    while ((len = gzread(fp, buffer, sizeof(buffer))) > 0) {
+        content.append(buffer, static_cast<size_t>(len));
+    }
+    gzclose(fp);
+
+    PageSource source;
+    source.filepath = this->filepath;
+    source.xournalFilepath = this->xournalFilepath;
+    source.fileVersion = this->fileVersion;
+    source.isGzFile = this->isGzFile;
+    source.audioFiles = g_hash_table_ref(this->audioFiles);
+
+    const std::string baseId = AutosaveJournal::getBaseId(this->filepath);
+    const std::string pageCount = std::to_string(this->doc->getPageCount());
+    constexpr std::string_view recordEnd = "</record>";
+
+    size_t start = findOpeningTag(content, "<record", 0);
+    while (start != std::string::npos) {
+        size_t headerEnd = content.find('>', start);
+        size_t end = content.find(recordEnd, start);
+        if (headerEnd == std::string::npos || end == std::string::npos || end < headerEnd) {
+            break;
+        }
+        std::string_view header(content.data() + start, headerEnd - start);
+        std::string_view body(content.data() + headerEnd + 1, end - headerEnd - 1);
+        start = findOpeningTag(content, "<record", end + recordEnd.size());
+
+        // Records written before the autosave file was replaced do not apply
+        if (getTagAttribute(header, "base") != baseId || getTagAttribute(header, "pagecount") != pageCount) {
+            continue;
+        }
+
+        std::vector<size_t> pageIds;
+        std::string_view ids = getTagAttribute(header, "pages");
+        const char* idsEnd = ids.data() + ids.size();
+        for (const char* ptr = ids.data(); ptr < idsEnd;) {
+            size_t id = 0;
+            auto [next, ec] = std::from_chars(ptr, idsEnd, id);
+            if (ec != std::errc() || id >= this->doc->getPageCount()) {
+                break;
+            }
+            pageIds.push_back(id);
+            // Skip the separator
+            ptr = next == idsEnd ? next : next + 1;
+        }
+
+        std::string error;
+        auto pages = parsePages(source, body, error);
+        if (pages.size() != pageIds.size()) {
+            g_warning("LoadHandler::replayJournal: invalid record in %s\n", char_cast(journalPath.u8string().c_str()));
+            continue;
+        }
+        for (size_t i = 0; i < pages.size(); i++) {
+            this->doc->getPage(pageIds[i])->setLayers(std::exchange(pages[i]->layer, {}));
+        }
+    }
+}
+
 auto LoadHandler::parseXml() -> bool {
     xoj_assert(this->doc);
     const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
@@ -227,20 +645,39 @@ auto LoadHandler::parseXml() -> bool {
     GMarkupParseContext* context =
             g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), this, nullptr);
 
-    zip_int64_t len = 0;
-    do {
-        char buffer[1024];
-        len = readContentFile(buffer, sizeof(buffer));
-        if (len > 0) {
-            valid = g_markup_parse_context_parse(context, buffer, len, &error);
+    // The content is parsed from a single buffer: the parser gets the text of the elements (e.g. base64 images)
+    // without copying it from chunk to chunk
+    auto source = std::make_shared<PageSource>();
+    source->content = readContent();
+    const std::string& content = source->content;
+    std::vector<std::string_view> chunks;
+    size_t prefixEnd = 0;
+    size_t suffixStart = 0;
+    size_t parsed = 0;  ///< Bytes of content already fed to the context
+
+    if ((this->lazyLoading || (this->parallelParsing && this->scheduler && this->scheduler->getWorkerCount() > 0)) &&
+        findPageChunks(content, chunks, prefixEnd, suffixStart) && chunks.size() > 1) {
+        // The header must be parsed first: the file version and the audio attachments are needed by the pages
+        valid = parseXmlChunk(context, content.data(), prefixEnd);
+        parsed = prefixEnd;
+
+        if (valid && this->pos == PARSER_POS_STARTED && this->lazyLoading) {
+            valid = parsePagesLazily(context, source, chunks);
+            parsed = suffixStart;
+        } else if (valid && this->pos == PARSER_POS_STARTED) {
+            auto workers = parsePagesParallel(chunks);
+            if (!workers.empty()) {
+                addParsedPages(std::move(workers));
+                valid = this->error == nullptr;
+                parsed = suffixStart;
+            }
+            // Otherwise, some page is broken: parse the pages sequentially to report the error as usual
         }
+    }
 
-        if (error) {
-            g_warning("LoadHandler::parseXml: %s\n", error->message);
-            valid = false;
-            break;
-        }
-    } while (len >= 0 && valid && !error);
+    if (valid) {
+        valid = parseXmlChunk(context, content.data() + parsed, content.size() - parsed);
+    }
 
     if (valid) {
         valid = g_markup_parse_context_end_parse(context, &error);
@@ -323,6 +760,9 @@ void LoadHandler::parseContents() {
         this->page = std::make_unique<XojPage>(width, height, /*suppressLayer*/ true);
 
         pages.push_back(this->page);
+        if (this->deferBackgrounds) {
+            deferredBackgrounds.emplace_back();
+        }
     } else if (strcmp(elementName, "audio") == 0) {
         this->parseAudio();
     } else if (strcmp(elementName, "title") == 0) {
@@ -510,7 +950,14 @@ void LoadHandler::parseBgPdf() {
 }
 
 void LoadHandler::parsePage() {
-    if (!strcmp(elementName, "background")) {
+    if (!strcmp(elementName, "background") && this->deferBackgrounds) {
+        // Backgrounds may load the PDF or refer to previous pages: record them for the parent to parse in order
+        AttributeList attributes;
+        for (auto n = attributeNames, v = attributeValues; *n; ++n, ++v) {
+            attributes.emplace_back(*n, *v);
+        }
+        deferredBackgrounds.back().emplace_back(std::move(attributes));
+    } else if (!strcmp(elementName, "background")) {
         const char* name = LoadHandlerHelper::getAttrib("name", true, this);
         if (name != nullptr) {
             this->page->setBackgroundName(name);
@@ -541,6 +988,8 @@ void LoadHandler::parsePage() {
 }
 
 void LoadHandler::parseStroke() {
+    this->strokePointsRead = false;
+
     auto strokeOwn = std::make_unique<Stroke>();
     this->stroke = strokeOwn.get();
     this->layer->addElement(std::move(strokeOwn));
@@ -561,13 +1010,10 @@ void LoadHandler::parseStroke() {
         pressure = endPtr;
     }
 
-    while (*pressure != 0) {
-        char* tmpptr = nullptr;
-        double val = g_ascii_strtod(pressure, &tmpptr);
-        if (tmpptr == pressure) {
-            break;
-        }
-        pressure = tmpptr;
+    const char* pressureEnd = pressure + strlen(pressure);
+    this->pressureBuffer.reserve(Util::countTokens(pressure, pressureEnd));
+    double val = 0;
+    while ((pressure = Util::parseDouble(pressure, pressureEnd, val)) != nullptr) {
         this->pressureBuffer.push_back(val);
     }
 
@@ -651,6 +1097,12 @@ void LoadHandler::parseStroke() {
         loadedFilename = "";
         loadedTimeStamp = 0;
     }
+
+    // Since file version 5, the points may be stored in a binary attachment (see SaveHandler::setBinaryStrokes())
+    const char* pointData = LoadHandlerHelper::getAttrib("pointdata", true, this);
+    if (pointData != nullptr) {
+        readBinaryPoints(pointData);
+    }
 }
 
 void LoadHandler::parseText() {
@@ -921,7 +1373,6 @@ void LoadHandler::parserEndElement(GMarkupParseContext* context, const gchar* el
         handler->pos = PARSER_POS_IN_LAYER;
         handler->text = nullptr;
     } else if (handler->pos == PARSER_POS_IN_IMAGE && strcmp(elementName, "image") == 0) {
-        xoj_assert_message(handler->image->getImage() != nullptr, "image can't be rendered");
         handler->pos = PARSER_POS_IN_LAYER;
         handler->image = nullptr;
     } else if (handler->pos == PARSER_POS_IN_TEXIMAGE && strcmp(elementName, "teximage") == 0) {
@@ -998,6 +1449,77 @@ void LoadHandler::fixNullPressureValues() {
             });
 }
 
+void LoadHandler::setStrokePressure() {
+    if (this->pressureBuffer.empty()) {
+        return;
+    }
+
+    if (this->pressureBuffer.size() + 1 >= this->stroke->getPointCount()) {
+        auto firstNonPositive = std::find_if(this->pressureBuffer.begin(), this->pressureBuffer.end(),
+                                             [](double v) { return v <= 0 || std::isnan(v); });
+        if (firstNonPositive != this->pressureBuffer.end()) {
+            // Warning: this may delete this->stroke if no positive pressure values are provided
+            // Do not dereference this->stroke after that
+            fixNullPressureValues();
+        } else {
+            this->stroke->setPressure(this->pressureBuffer);
+        }
+    } else {
+        g_warning("%s", FC(_F("xoj-File: {1}") % this->filepath.u8string()));
+        g_warning("%s", FC(_F("Wrong number of pressure values, got {1}, expected {2}") %
+                           this->pressureBuffer.size() % (this->stroke->getPointCount() - 1)));
+    }
+    this->pressureBuffer.clear();
+}
+
+void LoadHandler::readBinaryPoints(const char* filename) {
+    // The text content of the element, if any, is ignored
+    this->strokePointsRead = true;
+
+    size_t offset = LoadHandlerHelper::getAttribSizeT("offset", this);
+    size_t count = LoadHandlerHelper::getAttribSizeT("count", this);
+    const char* fields = LoadHandlerHelper::getAttrib("fields", false, this);
+    if (this->error) {
+        return;
+    }
+
+    bool hasPressure = fields != nullptr && strcmp(fields, "xyz") == 0;
+    if (!hasPressure && (fields == nullptr || strcmp(fields, "xy") != 0)) {
+        error("%s", FC(_F("Unknown point data fields: \"{1}\"") % (fields ? fields : "")));
+        return;
+    }
+
+    auto& data = this->binaryAttachments[filename];
+    if (!data) {
+        data = readZipAttachment(filename);
+        if (!data) {
+            return;
+        }
+    }
+
+    // Pressure values are stored for each segment, as in the text format
+    const size_t valueCount = 2 * count + (hasPressure && count > 0 ? count - 1 : 0);
+    if (count < 2 || offset > data->size() || (data->size() - offset) / sizeof(double) < valueCount) {
+        error("%s", FC(_F("Invalid point data in {1} at offset {2}") % filename % offset));
+        return;
+    }
+
+    std::vector<double> values(valueCount);
+    Util::readLittleEndianDoubles(data->data() + offset, valueCount, values.data());
+
+    std::vector<Point> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        points.emplace_back(values[i], values[count + i]);
+    }
+    this->stroke->setPointVector(std::move(points));
+
+    if (hasPressure) {
+        this->pressureBuffer.assign(values.begin() + as_signed(2 * count), values.end());
+    }
+    setStrokePressure();
+}
+
 void LoadHandler::parserText(GMarkupParseContext* context, const gchar* text, gsize textLen, gpointer userdata,
                              GError** error) {
     // Return on error
@@ -1006,96 +1528,71 @@ void LoadHandler::parserText(GMarkupParseContext* context, const gchar* text, gs
     }
 
     auto* handler = static_cast<LoadHandler*>(userdata);
-    if (handler->pos == PARSER_POS_IN_STROKE) {
-        const char* ptr = text;
-        int n = 0;
-
-        bool xRead = false;
-        double x = 0;
+    if (handler->pos == PARSER_POS_IN_STROKE && handler->strokePointsRead) {
+        // The points were read from a binary attachment
+        return;
+    } else if (handler->pos == PARSER_POS_IN_STROKE) {
+        const char* end = text + textLen;
 
-        while (textLen > 0) {
-            double tmp = g_ascii_strtod(text, const_cast<char**>(&ptr));
-            if (ptr == text) {
-                break;
-            }
-            textLen -= as_unsigned(ptr - text);
-            text = ptr;
-            n++;
+        // Fill the whole point vector before handing it to the stroke at once
+        std::vector<Point> points;
+        points.reserve(Util::countTokens(text, end) / 2);
 
-            if (!xRead) {
-                xRead = true;
-                x = tmp;
+        int n = 0;
+        double x = 0;
+        double val = 0;
+        for (const char* ptr = text; (ptr = Util::parseDouble(ptr, end, val)) != nullptr; n++) {
+            if (n & 1) {
+                points.emplace_back(x, val);
             } else {
-                xRead = false;
-                handler->stroke->addPoint(Point(x, tmp));
+                x = val;
             }
         }
-        handler->stroke->freeUnusedPointItems();
+        handler->stroke->setPointVector(std::move(points));
 
         if (n < 4 || (n & 1)) {
             error2(*error, "%s", FC(_F("Wrong count of points ({1})") % n));
             return;
         }
 
-        if (!handler->pressureBuffer.empty()) {
-            if (handler->pressureBuffer.size() + 1 >= handler->stroke->getPointCount()) {
-                auto firstNonPositive = std::find_if(handler->pressureBuffer.begin(), handler->pressureBuffer.end(),
-                                                     [](double v) { return v <= 0 || std::isnan(v); });
-                if (firstNonPositive != handler->pressureBuffer.end()) {
-                    // Warning: this may delete handler->stroke if no positive pressure values are provided
-                    // Do not dereference handler->stroke after that
-                    handler->fixNullPressureValues();
-                } else {
-                    handler->stroke->setPressure(handler->pressureBuffer);
-                }
-            } else {
-                g_warning("%s", FC(_F("xoj-File: {1}") % handler->filepath.u8string()));
-                g_warning("%s", FC(_F("Wrong number of pressure values, got {1}, expected {2}") %
-                                   handler->pressureBuffer.size() % (handler->stroke->getPointCount() - 1)));
-            }
-            handler->pressureBuffer.clear();
-        }
+        handler->setStrokePressure();
     } else if (handler->pos == PARSER_POS_IN_TEXT) {
         gchar* txt = g_strndup(text, textLen);
         handler->text->setText(txt);
         g_free(txt);
     } else if (handler->pos == PARSER_POS_IN_IMAGE) {
-        handler->readImage(text, textLen);
+        handler->readImage(std::string_view(text, textLen));
     } else if (handler->pos == PARSER_POS_IN_TEXIMAGE) {
-        handler->readTexImage(text, textLen);
+        handler->readTexImage(std::string_view(text, textLen));
     }
 }
 
-auto LoadHandler::parseBase64(const gchar* base64, gsize length) -> string {
-    // We have to copy the string in order to null terminate it, sigh.
-    auto* base64data = static_cast<gchar*>(g_memdup(base64, static_cast<guint>(length) + 1));
-    base64data[length] = '\0';
-
-    gsize binaryBufferLen = 0;
-    guchar* binaryBuffer = g_base64_decode(base64data, &binaryBufferLen);
-    g_free(base64data);
-
-    string str = string(reinterpret_cast<char*>(binaryBuffer), binaryBufferLen);
-    g_free(binaryBuffer);
-
-    return str;
+auto LoadHandler::parseBase64(std::string_view base64) -> string {
+    // Decode into the result directly, the decoder skips the line breaks
+    string data((base64.size() / 4) * 3 + 3, '\0');
+    gint state = 0;
+    guint save = 0;
+    gsize length = g_base64_decode_step(base64.data(), base64.size(), reinterpret_cast<guchar*>(data.data()), &state,
+                                        &save);
+    data.resize(length);
+    return data;
 }
 
-void LoadHandler::readImage(const gchar* base64string, gsize base64stringLen) {
+void LoadHandler::readImage(std::string_view base64string) {
     xoj_assert(this->image != nullptr);
-    if (base64stringLen == 0 || (base64stringLen == 1 && base64string[0] == '\n') || this->image->hasData()) {
+    if (base64string.empty() || base64string == "\n" || this->image->hasData()) {
         return;
     }
 
-    this->image->setImage(parseBase64(const_cast<char*>(base64string), base64stringLen));
+    this->image->setImage(parseBase64(base64string));
 }
 
-void LoadHandler::readTexImage(const gchar* base64string, gsize base64stringLen) {
-    if (base64stringLen == 1 && !strcmp(base64string, "\n")) {
+void LoadHandler::readTexImage(std::string_view base64string) {
+    if (base64string == "\n") {
         return;
     }
 
-    this->teximage->loadData(parseBase64(const_cast<char*>(base64string), base64stringLen));
+    this->teximage->loadData(parseBase64(base64string));
 }
 
 auto LoadHandler::loadDocument(fs::path const& filepath) -> std::unique_ptr<Document> {
@@ -1117,6 +1614,8 @@ auto LoadHandler::loadDocument(fs::path const& filepath) -> std::unique_ptr<Docu
         return nullptr;
     }
 
+    replayJournal();
+
     if (fileVersion == 1) {
         // This is a Xournal document, not a Xournal++
         // Even if the new fileextension is .xopp, allow to
@@ -1135,6 +1634,9 @@ auto LoadHandler::loadDocument(fs::path const& filepath) -> std::unique_ptr<Docu
 }
 
 auto LoadHandler::readZipAttachment(fs::path const& filename) -> std::unique_ptr<std::string> {
+    // libzip archives must not be used from several threads at once
+    std::lock_guard lock(this->parent ? this->parent->zipMutex : this->zipMutex);
+
     zip_stat_t attachmentFileStat;
     const int statStatus = zip_stat(this->zipFp, char_cast(filename.u8string().c_str()), 0, &attachmentFileStat);
     if (statStatus != 0) {
@@ -1182,8 +1684,23 @@ auto LoadHandler::getTempFileForPath(fs::path const& filename) -> fs::path {
         return string(static_cast<char*>(tmpFilename));
     }
 
+    if (this->fileVersion >= 5) {
+        // Since file version 5, zip files may refer to audio files which are not attached, like .xoj files
+        return filename;
+    }
+
     error("%s", FC(_F("Requested temporary file was not found for attachment {1}") % filename.u8string()));
     return "";
 }
 
 auto LoadHandler::getFileVersion() const -> int { return this->fileVersion; }
+
+void LoadHandler::setParallelParsing(bool enable) { this->parallelParsing = enable; }
+
+void LoadHandler::setScheduler(Scheduler* scheduler) { this->scheduler = scheduler; }
+
+void LoadHandler::setLazyLoading(bool enable) { this->lazyLoading = enable; }
+
+void LoadHandler::setLazyLoadingErrorHandler(std::function<void(const std::string&)> handler) {
+    this->lazyLoadingErrorHandler = std::move(handler);
+}
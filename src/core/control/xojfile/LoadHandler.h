@@ -11,11 +11,16 @@
 
 #pragma once
 
-#include <cstddef>   // for size_t
-#include <memory>    // for unique_ptr
-#include <optional>  // for optional
-#include <string>    // for string
-#include <vector>    // for vector
+#include <cstddef>      // for size_t
+#include <functional>   // for function
+#include <map>          // for map
+#include <memory>       // for unique_ptr
+#include <mutex>        // for mutex
+#include <optional>     // for optional
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <utility>      // for pair
+#include <vector>       // for vector
 
 #include <glib.h>     // for gchar, GError, gsize, GMarkupPars...
 #include <zip.h>      // for zip_file_t, zip_t
@@ -32,6 +37,7 @@
 
 class Image;
 class Layer;
+class Scheduler;
 class Stroke;
 class TexImage;
 class Text;
@@ -65,6 +71,38 @@ public:
     /** @return The version of the loaded file */
     int getFileVersion() const;
 
+    /**
+     * Parse the pages of the document concurrently (enabled by default), if a scheduler is set.
+     * The result is the same as with sequential parsing: in case of error, the loader falls back to sequential
+     * parsing, so that error messages are unchanged.
+     */
+    void setParallelParsing(bool enable);
+
+    /**
+     * The scheduler whose workers help parsing the pages in parallel. Without it, the pages are parsed sequentially.
+     */
+    void setScheduler(Scheduler* scheduler);
+
+    /**
+     * Only parse the size and background of the pages when loading (disabled by default).
+     * The layers of a page are parsed when first accessed, and may be freed again, see XojPage::unloadLayers().
+     * Takes precedence over parallel parsing.
+     */
+    void setLazyLoading(bool enable);
+
+    /**
+     * Called with a message for the user when the layers of a page loaded lazily can only be parsed partially, once
+     * per page (see XojPage::getLoadError()). May be called from any thread holding the document lock.
+     */
+    void setLazyLoadingErrorHandler(std::function<void(const std::string&)> handler);
+
+private:
+    /**
+     * Creates a handler parsing some pages on behalf of `parent` (see parsePagesParallel()).
+     * Backgrounds are not parsed but recorded, and applied in page order by the parent (see addParsedPages()).
+     */
+    explicit LoadHandler(LoadHandler* parent);
+
 private:
     void parseStart();
     void parseContents();
@@ -82,11 +120,67 @@ private:
 
     std::string readLine();
     zip_int64_t readContentFile(char* buffer, zip_uint64_t len);
+    std::string readContent();
     bool closeFile();
     bool openFile(fs::path const& filepath);
     bool parseXml();
+    bool parseXmlChunk(GMarkupParseContext* context, const char* data, size_t len);
+
+    /**
+     * Parse the <page> elements of `chunks` with the workers of the scheduler.
+     * @return The handlers holding the parsed pages, in document order, or an empty vector if a page failed to parse
+     */
+    std::vector<std::unique_ptr<LoadHandler>> parsePagesParallel(const std::vector<std::string_view>& chunks);
+    /**
+     * Parse the recorded backgrounds and add the pages parsed by the workers, in order.
+     */
+    void addParsedPages(std::vector<std::unique_ptr<LoadHandler>> workers);
+
+    /**
+     * The document content and the state needed to parse the layers of its pages after loading
+     */
+    struct PageSource {
+        ~PageSource();
+
+        std::string content;
+        fs::path filepath;
+        fs::path xournalFilepath;
+        int fileVersion = 0;
+        bool isGzFile = false;
+        GHashTable* audioFiles = nullptr;
+        std::function<void(const std::string&)> reportError;
+    };
+
+    /**
+     * Parse the headers of the <page> elements of `chunks` and let the pages parse their layers on demand.
+     * Pages reading from the archive are parsed completely, since it is closed after loading.
+     */
+    bool parsePagesLazily(GMarkupParseContext* context, const std::shared_ptr<PageSource>& source,
+                          const std::vector<std::string_view>& chunks);
+    /**
+     * Parse the layers of the <page> element `chunk`
+     */
+    static std::vector<Layer*> parseLayers(const PageSource& source, std::string_view chunk, std::string& error);
+    /**
+     * Parse the <page> elements of `chunk`, without their backgrounds. On error, `error` is set and the pages hold what
+     * could be parsed.
+     */
+    static std::vector<PageRef> parsePages(const PageSource& source, std::string_view chunk, std::string& error);
+
+    /**
+     * Replace the layers of the pages changed in the autosave journal of the file, if any (see AutosaveJournal)
+     */
+    void replayJournal();
 
     void fixNullPressureValues();
+    /**
+     * Apply the pressure values read for the current stroke, once its points are known
+     */
+    void setStrokePressure();
+    /**
+     * Read the points of the current stroke from the binary attachment `filename` (file version 5)
+     */
+    void readBinaryPoints(const char* filename);
     static void parserText(GMarkupParseContext* context, const gchar* text, gsize textLen, gpointer userdata,
                            GError** error);
     static void parserEndElement(GMarkupParseContext* context, const gchar* elementName, gpointer userdata,
@@ -103,11 +197,11 @@ private:
     void parseBgPdf();
     void parseAttachment();
 
-    void readImage(const gchar* base64string, gsize base64stringLen);
-    void readTexImage(const gchar* base64string, gsize base64stringLen);
+    void readImage(std::string_view base64string);
+    void readTexImage(std::string_view base64string);
 
 private:
-    static std::string parseBase64(const gchar* base64, gsize length);
+    static std::string parseBase64(std::string_view base64);
 
     /**
      * Returns the contents of the zip attachment with the given file name, or
@@ -138,6 +232,25 @@ private:
     bool isGzFile = false;
 
     std::vector<double> pressureBuffer;
+    /// Whether the points of the current stroke were read from a binary attachment
+    bool strokePointsRead = false;
+    /// The binary point attachments read so far
+    std::map<std::string, std::unique_ptr<std::string>> binaryAttachments;
+
+    bool parallelParsing = true;
+    Scheduler* scheduler = nullptr;
+    bool lazyLoading = false;
+    std::function<void(const std::string&)> lazyLoadingErrorHandler;
+    /// Set for the handlers parsing pages on behalf of another handler
+    LoadHandler* parent = nullptr;
+    /// Do not parse the backgrounds of the pages, but record them (see deferredBackgrounds)
+    bool deferBackgrounds = false;
+    /// Serializes the accesses to the zip archive, which is shared with the page workers
+    std::mutex zipMutex;
+
+    using AttributeList = std::vector<std::pair<std::string, std::string>>;
+    /// Attributes of the <background> elements of each page, recorded by the page workers
+    std::vector<std::vector<AttributeList>> deferredBackgrounds;
 
     std::vector<PageRef> pages;
     PageRef page;
@@ -1,13 +1,27 @@
 #include "SaveHandler.h"
 
-#include <cinttypes>   // for PRIx32
-#include <cstdint>     // for uint32_t
-#include <cstdio>      // for sprintf, size_t
+#include <algorithm>     // for find, min, transform
+#include <cinttypes>     // for PRIx32
+#include <cstdint>       // for uint32_t
+#include <cstdio>        // for sprintf, size_t
+#include <cstring>       // for memcpy
+#include <exception>     // for exception
+#include <functional>    // for function
+#include <iterator>      // for back_inserter
+#include <memory>        // for unique_ptr, make_unique
+#include <string>        // for string, to_string
+#include <string_view>   // for string_view
+#include <system_error>  // for error_code
+#include <utility>       // for move, pair
+#include <vector>        // for vector
 
 #include <cairo.h>                  // for cairo_surface_t
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for gdk_pixbuf_save
 #include <glib.h>                   // for g_free, g_strdup_printf
+#include <glib/gstdio.h>            // for g_close
+#include <zip.h>                    // for zip_open, zip_file_add, zip_close
 
+#include "control/jobs/ProgressListener.h"     // for ProgressListener
 #include "control/pagetype/PageTypeHandler.h"  // for PageTypeHandler
 #include "control/xml/XmlAudioNode.h"          // for XmlAudioNode
 #include "control/xml/XmlImageNode.h"          // for XmlImageNode
@@ -34,24 +48,198 @@
 #include "util/OutputStream.h"                 // for GzOutputStream, Output...
 #include "util/PathUtil.h"                     // for clearExtensions, normalizeAssetPath
 #include "util/PlaceholderString.h"            // for PlaceholderString
+#include "util/Util.h"                         // for appendLittleEndianDoubles
 #include "util/i18n.h"                         // for FS, _F
 
-#include "config.h"  // for FILE_FORMAT_VERSION
+#include "config.h"  // for FILE_FORMAT_VERSION, BINARY_FILE_FORMAT_VERSION
 #include "filesystem.h"
 
-SaveHandler::SaveHandler() {
-    this->firstPdfPageVisited = false;
-    this->attachBgId = 1;
+namespace {
+constexpr std::string_view PNG_SIGNATURE = "\x89PNG\r\n\x1a\n";
+
+auto getPointDataName(size_t pageId) -> std::string { return "strokes/page" + std::to_string(pageId + 1) + ".bin"; }
+
+auto getAttachedBackgroundName(int id) -> std::string { return "bg_" + std::to_string(id) + ".png"; }
+
+auto hasBinaryPressure(const Stroke* s) -> bool { return s->hasPressure() && s->getPointCount() > 0; }
+
+/**
+ * Size of the points of the stroke in the binary attachment of its page
+ */
+auto getBinaryPointsSize(const Stroke* s) -> size_t {
+    size_t n = s->getPointCount();
+    return sizeof(double) * (2 * n + (hasBinaryPressure(s) ? n - 1 : 0));
 }
 
-void SaveHandler::prepareSave(const Document* doc, const fs::path& target) {
-    if (this->root) {
-        // cleanup old data
-        backgroundImages.clear();
+/**
+ * Append the points of the stroke to the binary attachment of its page: all x, then all y, then the pressure of each
+ * segment, as in the text format
+ */
+void appendBinaryPoints(std::string& data, const Stroke* s) {
+    auto pts = s->getPoints();
+    std::vector<double> values;
+    values.reserve(3 * pts.size());
+    std::transform(pts.begin(), pts.end(), std::back_inserter(values), [](const Point& p) { return p.x; });
+    std::transform(pts.begin(), pts.end(), std::back_inserter(values), [](const Point& p) { return p.y; });
+    if (hasBinaryPressure(s)) {
+        std::transform(pts.begin(), pts.end() - 1, std::back_inserter(values), [](const Point& p) { return p.z; });
+    }
+    Util::appendLittleEndianDoubles(data, values);
+}
+
+/**
+ * The files of the zip container besides content.xml, known before the content is written
+ */
+struct ZipAttachments {
+    /// The pages with a binary point attachment
+    std::vector<size_t> pointDataPages;
+    /// Name and image of the attached backgrounds, named as in SaveHandler::visitPage()
+    std::vector<std::pair<std::string, BackgroundImage>> images;
+    bool pdf = false;
+};
+
+auto collectZipAttachments(const Document* doc) -> ZipAttachments {
+    ZipAttachments res;
+    std::vector<BackgroundImage> visitedImages;
+    bool hasPdfPage = false;
+    int attachBgId = 1;
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        ConstPageRef p = doc->getPage(i);
+
+        bool hasPoints = false;
+        for (const Layer* l: p->getLayersView()) {
+            for (const auto& e: l->getElementsView()) {
+                hasPoints = hasPoints ||
+                            (e->getType() == ELEMENT_STROKE && dynamic_cast<const Stroke*>(e)->getPointCount() > 0);
+            }
+        }
+        if (hasPoints) {
+            res.pointDataPages.push_back(i);
+        }
+
+        hasPdfPage = hasPdfPage || p->getBackgroundType().isPdfPage();
+        if (p->getBackgroundType().isImagePage()) {
+            // Later pages with the same image are written as clones of the first one
+            const BackgroundImage& img = p->getBackgroundImage();
+            if (std::find(visitedImages.begin(), visitedImages.end(), img) != visitedImages.end()) {
+                continue;
+            }
+            visitedImages.push_back(img);
+            if (img.isAttached() && img.getPixbuf()) {
+                res.images.emplace_back(getAttachedBackgroundName(attachBgId++), img);
+            }
+        }
+    }
+    res.pdf = hasPdfPage && doc->isAttachPdf();
+    return res;
+}
+
+/**
+ * Source of a zip entry whose content is written chunk by chunk while libzip writes the archive, so that the entry is
+ * never held in memory as a whole.
+ */
+class ChunkedZipSource {
+public:
+    /**
+     * Writes the chunk of the given index (starting from 0) to the stream
+     * @return false if there is no such chunk
+     */
+    using ChunkWriter = std::function<bool(size_t, OutputStream*)>;
+
+    explicit ChunkedZipSource(ChunkWriter writeChunk): writeChunk(std::move(writeChunk)) { zip_error_init(&error); }
+    ~ChunkedZipSource() { zip_error_fini(&error); }
+
+    ChunkedZipSource(const ChunkedZipSource&) = delete;
+    ChunkedZipSource& operator=(const ChunkedZipSource&) = delete;
+
+    /**
+     * The source must outlive the archive
+     */
+    auto create(zip_t* zip) -> zip_source_t* { return zip_source_function(zip, &ChunkedZipSource::callback, this); }
+
+private:
+    static auto callback(void* userdata, void* data, zip_uint64_t len, zip_source_cmd_t cmd) -> zip_int64_t {
+        auto* self = static_cast<ChunkedZipSource*>(userdata);
+        switch (cmd) {
+            case ZIP_SOURCE_OPEN:
+                self->nextChunk = 0;
+                self->finished = false;
+                self->buffer.clear();
+                self->position = 0;
+                return 0;
+            case ZIP_SOURCE_READ:
+                try {
+                    return self->read(static_cast<char*>(data), len);
+                } catch (const std::exception& e) {
+                    g_warning("Could not write zip entry: %s", e.what());
+                    zip_error_set(&self->error, ZIP_ER_INTERNAL, 0);
+                    return -1;
+                }
+            case ZIP_SOURCE_CLOSE:
+                self->buffer.clear();
+                return 0;
+            case ZIP_SOURCE_STAT:
+                if (len < sizeof(zip_stat_t)) {
+                    zip_error_set(&self->error, ZIP_ER_INVAL, 0);
+                    return -1;
+                }
+                // The size is unknown until the entry is written
+                zip_stat_init(static_cast<zip_stat_t*>(data));
+                return sizeof(zip_stat_t);
+            case ZIP_SOURCE_ERROR:
+                return zip_error_to_data(&self->error, data, len);
+            case ZIP_SOURCE_FREE:
+                return 0;
+            case ZIP_SOURCE_SUPPORTS:
+                return zip_source_make_command_bitmap(ZIP_SOURCE_OPEN, ZIP_SOURCE_READ, ZIP_SOURCE_CLOSE,
+                                                      ZIP_SOURCE_STAT, ZIP_SOURCE_ERROR, ZIP_SOURCE_FREE, -1);
+            default:
+                zip_error_set(&self->error, ZIP_ER_OPNOTSUPP, 0);
+                return -1;
+        }
     }
 
+    auto read(char* data, zip_uint64_t len) -> zip_int64_t {
+        zip_uint64_t done = 0;
+        while (done < len) {
+            const std::string& str = this->buffer.getString();
+            if (this->position == str.size()) {
+                if (this->finished) {
+                    break;
+                }
+                this->buffer.clear();
+                this->position = 0;
+                this->finished = !this->writeChunk(this->nextChunk++, &this->buffer);
+                continue;
+            }
+            size_t count = std::min(static_cast<size_t>(len - done), str.size() - this->position);
+            std::memcpy(data + done, str.data() + this->position, count);
+            this->position += count;
+            done += count;
+        }
+        return static_cast<zip_int64_t>(done);
+    }
+
+    ChunkWriter writeChunk;
+    size_t nextChunk = 0;
+    bool finished = false;
+
+    /// The chunk being read
+    StringOutputStream buffer;
+    size_t position = 0;
+
+    zip_error_t error;
+};
+}  // namespace
+
+SaveHandler::SaveHandler() {
     this->firstPdfPageVisited = false;
     this->attachBgId = 1;
+}
+
+void SaveHandler::prepareSave(const Document* doc, const fs::path& target) {
+    this->doc = doc;
+    this->target = target;
 
     root.reset(new XmlNode("xournal"));
 
@@ -63,16 +251,6 @@ void SaveHandler::prepareSave(const Document* doc, const fs::path& target) {
         image->setImage(preview);
         this->root->addChild(image);
     }
-
-    for (size_t i = 0; i < doc->getPageCount(); i++) {
-        PageRef p = doc->getPage(i);
-        p->getBackgroundImage().clearSaveState();
-    }
-
-    for (size_t i = 0; i < doc->getPageCount(); i++) {
-        PageRef p = doc->getPage(i);
-        visitPage(root.get(), p, doc, static_cast<int>(i), target);
-    }
 }
 
 void SaveHandler::writeHeader() {
@@ -118,23 +296,35 @@ void SaveHandler::visitStroke(XmlPointNode* stroke, const Stroke* s) {
 
     stroke->setAttrib("color", getColorStr(s->getColor(), alpha).c_str());
 
-    const auto& pts = s->getPointVector();
+    auto pts = s->getPoints();
 
-    stroke->setPoints(pts);
-
-    if (s->hasPressure()) {
+    if (this->binaryStrokes) {
+        stroke->setAttrib("width", s->getWidth());
+        writeBinaryPoints(stroke, s);
+    } else if (s->hasPressure()) {
+        stroke->setPoints(pts);
         std::vector<double> values;
         values.reserve(pts.size() + 1);
         values.emplace_back(s->getWidth());
         std::transform(pts.begin(), pts.end() - 1, std::back_inserter(values), [](const Point& p) { return p.z; });
         stroke->setAttrib("width", std::move(values));
     } else {
+        stroke->setPoints(pts);
         stroke->setAttrib("width", s->getWidth());
     }
 
     visitStrokeExtended(stroke, s);
 }
 
+void SaveHandler::writeBinaryPoints(XmlPointNode* stroke, const Stroke* s) {
+    // The points themselves are written by appendBinaryPoints(), when the attachment of the page is stored
+    stroke->setAttrib("pointdata", this->pointDataName);
+    stroke->setAttrib("offset", this->pointDataSize);
+    stroke->setAttrib("count", s->getPointCount());
+    stroke->setAttrib("fields", hasBinaryPressure(s) ? "xyz" : "xy");
+    this->pointDataSize += getBinaryPointsSize(s);
+}
+
 /**
  * Export the fill attributes
  */
@@ -160,66 +350,81 @@ void SaveHandler::visitStrokeExtended(XmlPointNode* stroke, const Stroke* s) {
     }
 }
 
-void SaveHandler::visitLayer(XmlNode* page, const Layer* l) {
-    auto* layer = new XmlNode("layer");
-    page->addChild(layer);
+void SaveHandler::visitLayer(OutputStream* out, const Layer* l) {
+    XmlNode layer("layer");
     if (l->hasName()) {
-        layer->setAttrib("name", l->getName().c_str());
+        layer.setAttrib("name", l->getName().c_str());
     }
 
-    for (const auto& e: l->getElementsView()) {
+    auto elements = l->getElementsView();
+    if (elements.size() == 0) {
+        layer.writeOut(out);
+        return;
+    }
+
+    layer.writeOpeningTag(out);
+
+    // Each element is serialized and released before the next one, so memory does not grow with the layer size
+    for (const auto& e: elements) {
         if (e->getType() == ELEMENT_STROKE) {
             auto* s = dynamic_cast<const Stroke*>(e);
-            auto* stroke = new XmlPointNode("stroke");
-            layer->addChild(stroke);
-            visitStroke(stroke, s);
+            XmlPointNode stroke("stroke");
+            visitStroke(&stroke, s);
+            stroke.writeOut(out);
         } else if (e->getType() == ELEMENT_TEXT) {
             const Text* t = dynamic_cast<const Text*>(e);
-            auto* text = new XmlTextNode("text", t->getText());
-            layer->addChild(text);
+            XmlTextNode text("text", t->getText());
 
             const XojFont& f = t->getFont();
 
-            text->setAttrib("font", f.getName().c_str());
-            text->setAttrib("size", f.getSize());
-            text->setAttrib("x", t->getX());
-            text->setAttrib("y", t->getY());
-            text->setAttrib("color", getColorStr(t->getColor()).c_str());
+            text.setAttrib("font", f.getName().c_str());
+            text.setAttrib("size", f.getSize());
+            text.setAttrib("x", t->getX());
+            text.setAttrib("y", t->getY());
+            text.setAttrib("color", getColorStr(t->getColor()).c_str());
 
-            writeTimestamp(text, t);
+            writeTimestamp(&text, t);
+            text.writeOut(out);
         } else if (e->getType() == ELEMENT_IMAGE) {
             auto* i = dynamic_cast<const Image*>(e);
-            auto* image = new XmlImageNode("image");
-            layer->addChild(image);
+            XmlImageNode image("image");
 
-            image->setImage(i->getImage());
+            std::string_view rawData(reinterpret_cast<const char*>(i->getRawData()), i->getRawDataLength());
+            if (rawData.starts_with(PNG_SIGNATURE)) {
+                // The file format stores PNG images: no need to render and encode the image again
+                image.setPngData(rawData);
+            } else {
+                image.setImage(i->getImage().get());
+            }
 
-            image->setAttrib("left", i->getX());
-            image->setAttrib("top", i->getY());
-            image->setAttrib("right", i->getX() + i->getElementWidth());
-            image->setAttrib("bottom", i->getY() + i->getElementHeight());
+            image.setAttrib("left", i->getX());
+            image.setAttrib("top", i->getY());
+            image.setAttrib("right", i->getX() + i->getElementWidth());
+            image.setAttrib("bottom", i->getY() + i->getElementHeight());
+            image.writeOut(out);
         } else if (e->getType() == ELEMENT_TEXIMAGE) {
             auto* i = dynamic_cast<const TexImage*>(e);
-            auto* image = new XmlTexNode("teximage", std::string(i->getBinaryData()));
-            layer->addChild(image);
-
-            image->setAttrib("text", i->getText().c_str());
-            image->setAttrib("left", i->getX());
-            image->setAttrib("top", i->getY());
-            image->setAttrib("right", i->getX() + i->getElementWidth());
-            image->setAttrib("bottom", i->getY() + i->getElementHeight());
+            XmlTexNode image("teximage", std::string(i->getBinaryData()));
+
+            image.setAttrib("text", i->getText().c_str());
+            image.setAttrib("left", i->getX());
+            image.setAttrib("top", i->getY());
+            image.setAttrib("right", i->getX() + i->getElementWidth());
+            image.setAttrib("bottom", i->getY() + i->getElementHeight());
+            image.writeOut(out);
         }
     }
+
+    layer.writeClosingTag(out);
 }
 
-void SaveHandler::visitPage(XmlNode* root, ConstPageRef p, const Document* doc, int id, const fs::path& target) {
-    auto* page = new XmlNode("page");
-    root->addChild(page);
-    page->setAttrib("width", p->getWidth());
-    page->setAttrib("height", p->getHeight());
+void SaveHandler::visitPage(OutputStream* out, ConstPageRef p, const Document* doc, int id, const fs::path& target) {
+    XmlNode page("page");
+    page.setAttrib("width", p->getWidth());
+    page.setAttrib("height", p->getHeight());
 
     auto* background = new XmlNode("background");
-    page->addChild(background);
+    page.addChild(background);
 
     writeBackgroundName(background, p);
 
@@ -241,7 +446,8 @@ void SaveHandler::visitPage(XmlNode* root, ConstPageRef p, const Document* doc,
                 background->setAttrib("filename", "bg.pdf");
 
                 GError* error = nullptr;
-                if (!exists(filepath)) {
+                // The zip container stores the PDF itself (see saveToZip())
+                if (!this->binaryStrokes && !exists(filepath)) {
                     doc->getPdfDocument().save(filepath, &error);
                 }
 
@@ -266,43 +472,34 @@ void SaveHandler::visitPage(XmlNode* root, ConstPageRef p, const Document* doc,
     } else if (p->getBackgroundType().isImagePage()) {
         background->setAttrib("type", "pixmap");
 
-        int cloneId = p->getBackgroundImage().getCloneId();
+        // Later pages with the same image refer to the first one. The document is left untouched: the image may be
+        // shared with the document being edited (see Document::createSnapshot()).
+        const BackgroundImage& img = p->getBackgroundImage();
+        int cloneId = -1;
+        if (const void* contentId = img.getContentId()) {
+            auto [it, firstUse] = this->backgroundImagePages.try_emplace(contentId, id);
+            if (!firstUse) {
+                cloneId = it->second;
+            }
+        }
+
         if (cloneId != -1) {
             background->setAttrib("domain", "clone");
             char* filename = g_strdup_printf("%i", cloneId);
             background->setAttrib("filename", filename);
             g_free(filename);
-        } else if (p->getBackgroundImage().isAttached() && p->getBackgroundImage().getPixbuf()) {
-            char* filename = g_strdup_printf("bg_%d.png", this->attachBgId++);
+        } else if (img.isAttached() && img.getPixbuf()) {
+            std::string filename = getAttachedBackgroundName(this->attachBgId++);
             background->setAttrib("domain", "attach");
             background->setAttrib("filename", filename);
 
-            backgroundImages.emplace_back(p->getBackgroundImage());
-
-            /*
-             * Because BackgroundImage is basically a wrapped pointer, the following lines actually modify
-             * *(p->getBackgroundImage().content) and thus the Document.
-             * TODO Find a better way
-             */
-            backgroundImages.back().setFilepath(filename);
-            backgroundImages.back().setCloneId(id);
-
-            g_free(filename);
+            backgroundImages.emplace_back(std::move(filename), img);
         } else {
             // "absolute" just means path. For backward compatibility, it is hard to change the word
             background->setAttrib("domain", "absolute");
-            auto normalizedPath = Util::normalizeAssetPath(p->getBackgroundImage().getFilepath(), target.parent_path(),
-                                                           doc->getPathStorageMode());
+            auto normalizedPath =
+                    Util::normalizeAssetPath(img.getFilepath(), target.parent_path(), doc->getPathStorageMode());
             background->setAttrib("filename", char_cast(normalizedPath.c_str()));
-
-            BackgroundImage img = p->getBackgroundImage();
-
-            /*
-             * Because BackgroundImage is basically a wrapped pointer, the following line actually modifies
-             * *(p->getBackgroundImage().content) and thus the Document.
-             * TODO Find a better way
-             */
-            img.setCloneId(id);
         }
     } else {
         writeSolidBackground(background, p);
@@ -311,12 +508,46 @@ void SaveHandler::visitPage(XmlNode* root, ConstPageRef p, const Document* doc,
     // no layer, but we need to write one layer, else the old Xournal cannot read the file
     if (p->getLayerCount() == 0) {
         auto* layer = new XmlNode("layer");
-        page->addChild(layer);
+        page.addChild(layer);
     }
 
+    page.writeOpeningTag(out);
+
+    this->pointDataName = getPointDataName(static_cast<size_t>(id));
+    this->pointDataSize = 0;
+
     for (const Layer* l: p->getLayersView()) {
-        visitLayer(page, l);
+        visitLayer(out, l);
+    }
+
+    page.writeClosingTag(out);
+}
+
+auto SaveHandler::saveAttachedPdf(const Document* doc) -> fs::path {
+    GError* error = nullptr;
+    gchar* tmpName = nullptr;
+    fs::path res;
+    int fd = g_file_open_tmp("xournalpp-bg-XXXXXX.pdf", &tmpName, &error);
+    if (fd != -1) {
+        g_close(fd, nullptr);
+        res = fs::path(tmpName);
+        g_free(tmpName);
+
+        if (!doc->getPdfDocument().save(res, &error)) {
+            std::error_code ec;
+            fs::remove(res, ec);
+            res.clear();
+        }
     }
+
+    if (error) {
+        if (!this->errorMessage.empty()) {
+            this->errorMessage += "\n";
+        }
+        this->errorMessage += FS(_F("Could not write background \"{1}\", {2}") % "bg.pdf" % error->message);
+        g_error_free(error);
+    }
+    return res;
 }
 
 void SaveHandler::writeSolidBackground(XmlNode* background, ConstPageRef p) {
@@ -338,6 +569,11 @@ void SaveHandler::writeBackgroundName(XmlNode* background, ConstPageRef p) {
 }
 
 void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
+    if (this->binaryStrokes) {
+        saveToZip(filepath, listener);
+        return;
+    }
+
     GzOutputStream out(filepath);
 
     if (!out.getLastError().empty()) {
@@ -355,13 +591,47 @@ void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
 }
 
 void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener) {
+    writeContentBegin(out, listener);
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        writeContentPage(out, i, listener);
+    }
+    writeContentEnd(out, filepath);
+}
+
+void SaveHandler::writeContentBegin(OutputStream* out, ProgressListener* listener) {
     // XMLNode should be locale-safe ( store doubles using Locale 'C' format
 
     out->write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
-    root->writeOut(out, listener);
+    root->writeOpeningTag(out);
 
-    for (const BackgroundImage& img: backgroundImages) {
-        auto tmpfn = (fs::path(filepath) += ".") += img.getFilepath();
+    backgroundImages.clear();
+    backgroundImagePages.clear();
+    this->firstPdfPageVisited = false;
+    this->attachBgId = 1;
+
+    const size_t pageCount = doc->getPageCount();
+    if (listener) {
+        listener->setMaximumState(pageCount);
+    }
+}
+
+void SaveHandler::writeContentPage(OutputStream* out, size_t id, ProgressListener* listener) {
+    visitPage(out, doc->getPage(id), doc, static_cast<int>(id), target);
+    if (listener) {
+        listener->setCurrentState(id + 1);
+    }
+}
+
+void SaveHandler::writeContentEnd(OutputStream* out, const fs::path& filepath) {
+    root->writeClosingTag(out);
+
+    if (this->binaryStrokes) {
+        // The zip container stores the images itself (see saveToZip())
+        return;
+    }
+
+    for (const auto& [name, img]: backgroundImages) {
+        auto tmpfn = (fs::path(filepath) += ".") += name;
         // Are we certain that does not modify the GdkPixbuf?
         if (!gdk_pixbuf_save(const_cast<GdkPixbuf*>(img.getPixbuf()), char_cast(tmpfn.u8string().c_str()), "png",
                              nullptr, nullptr)) {
@@ -374,4 +644,169 @@ void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressLi
     }
 }
 
+void SaveHandler::writeJournalRecord(OutputStream* out, const Document* doc, const std::vector<size_t>& pageIds,
+                                     const std::string& baseId) {
+    this->doc = doc;
+
+    std::string ids;
+    for (size_t id: pageIds) {
+        if (!ids.empty()) {
+            ids += " ";
+        }
+        ids += std::to_string(id);
+    }
+
+    XmlNode record("record");
+    record.setAttrib("base", baseId);
+    record.setAttrib("pagecount", doc->getPageCount());
+    record.setAttrib("pages", ids);
+    record.writeOpeningTag(out);
+
+    // The size and background of the pages are unchanged since the autosave file was written
+    for (size_t id: pageIds) {
+        ConstPageRef p = doc->getPage(id);
+        XmlNode page("page");
+        page.setAttrib("width", p->getWidth());
+        page.setAttrib("height", p->getHeight());
+        page.writeOpeningTag(out);
+        for (const Layer* l: p->getLayersView()) {
+            visitLayer(out, l);
+        }
+        page.writeClosingTag(out);
+    }
+
+    record.writeClosingTag(out);
+}
+
+void SaveHandler::saveToZip(const fs::path& filepath, ProgressListener* listener) {
+    int zipError = 0;
+    zip_t* zipFp = zip_open(char_cast(filepath.u8string().c_str()), ZIP_CREATE | ZIP_TRUNCATE, &zipError);
+    if (!zipFp) {
+        zip_error_t error;
+        zip_error_init_with_code(&error, zipError);
+        if (!this->errorMessage.empty()) {
+            this->errorMessage += "\n";
+        }
+        this->errorMessage += FS(_F("Error opening file: \"{1}\"") % filepath.u8string());
+        this->errorMessage += std::string("\n") + zip_error_strerror(&error);
+        zip_error_fini(&error);
+        return;
+    }
+
+    this->root->setAttrib("fileversion", BINARY_FILE_FORMAT_VERSION);
+
+    const ZipAttachments attachments = collectZipAttachments(doc);
+    const fs::path pdfFile = attachments.pdf ? saveAttachedPdf(doc) : fs::path();
+
+    // libzip reads the sources when the archive is closed: they must be kept until then
+    const std::string mimetype = "application/xournal++";
+    const std::string version = "current=" + std::to_string(BINARY_FILE_FORMAT_VERSION) +
+                                "\nmin=" + std::to_string(BINARY_FILE_FORMAT_VERSION);
+    std::vector<std::unique_ptr<ChunkedZipSource>> sources;
+
+    auto addFile = [zipFp](const std::string& name, zip_source_t* source, bool compress) {
+        if (!source) {
+            return false;
+        }
+        zip_int64_t index = zip_file_add(zipFp, name.c_str(), source, ZIP_FL_OVERWRITE | ZIP_FL_ENC_UTF_8);
+        if (index < 0) {
+            zip_source_free(source);
+            return false;
+        }
+        if (!compress) {
+            zip_set_file_compression(zipFp, static_cast<zip_uint64_t>(index), ZIP_CM_STORE, 0);
+        }
+        return true;
+    };
+    auto addChunks = [&](const std::string& name, ChunkedZipSource::ChunkWriter writeChunk) {
+        auto& source = sources.emplace_back(std::make_unique<ChunkedZipSource>(std::move(writeChunk)));
+        return addFile(name, source->create(zipFp), true);
+    };
+
+    bool valid = addFile("mimetype", zip_source_buffer(zipFp, mimetype.data(), mimetype.size(), 0), false) &&
+                 addFile("META-INF/version", zip_source_buffer(zipFp, version.data(), version.size(), 0), true);
+
+    // Written one page at a time, while the archive is closed
+    const size_t pageCount = doc->getPageCount();
+    valid = valid && addChunks("content.xml", [&](size_t chunk, OutputStream* out) {
+                if (chunk == 0) {
+                    writeContentBegin(out, listener);
+                } else if (chunk <= pageCount) {
+                    writeContentPage(out, chunk - 1, listener);
+                } else if (chunk == pageCount + 1) {
+                    writeContentEnd(out, filepath);
+                } else {
+                    return false;
+                }
+                return true;
+            });
+
+    for (size_t id: attachments.pointDataPages) {
+        valid = valid && addChunks(getPointDataName(id), [doc = this->doc, id](size_t chunk, OutputStream* out) {
+                    if (chunk > 0) {
+                        return false;
+                    }
+                    // In the same order as visitLayer()
+                    std::string data;
+                    ConstPageRef p = doc->getPage(id);
+                    for (const Layer* l: p->getLayersView()) {
+                        for (const auto& e: l->getElementsView()) {
+                            if (e->getType() == ELEMENT_STROKE) {
+                                appendBinaryPoints(data, dynamic_cast<const Stroke*>(e));
+                            }
+                        }
+                    }
+                    out->write(data.data(), data.size());
+                    return true;
+                });
+    }
+
+    for (const auto& [name, img]: attachments.images) {
+        valid = valid && addChunks(name, [this, &name = name, &img = img](size_t chunk, OutputStream* out) {
+                    if (chunk > 0) {
+                        return false;
+                    }
+                    gchar* buffer = nullptr;
+                    gsize size = 0;
+                    if (gdk_pixbuf_save_to_buffer(const_cast<GdkPixbuf*>(img.getPixbuf()), &buffer, &size, "png",
+                                                  nullptr, nullptr)) {
+                        out->write(buffer, size);
+                        g_free(buffer);
+                    } else {
+                        if (!this->errorMessage.empty()) {
+                            this->errorMessage += "\n";
+                        }
+                        this->errorMessage += FS(_F("Could not write background \"{1}\". Continuing anyway.") %
+                                                 name);
+                    }
+                    return true;
+                });
+    }
+
+    if (!pdfFile.empty()) {
+#ifdef ZIP_LENGTH_TO_END  // Only introduced in libzip 1.10.1
+        valid = valid && addFile("bg.pdf", zip_source_file(zipFp, char_cast(pdfFile.u8string().c_str()), 0,
+                                                           ZIP_LENGTH_TO_END), true);
+#else
+        valid = valid && addFile("bg.pdf", zip_source_file(zipFp, char_cast(pdfFile.u8string().c_str()), 0, -1), true);
+#endif
+    }
+
+    if (!valid || zip_close(zipFp) != 0) {
+        if (!this->errorMessage.empty()) {
+            this->errorMessage += "\n";
+        }
+        this->errorMessage += FS(_F("Error writing data to file: \"{1}\"") % filepath.u8string());
+        this->errorMessage += std::string("\n") + zip_error_strerror(zip_get_error(zipFp));
+        zip_discard(zipFp);
+    }
+
+    if (!pdfFile.empty()) {
+        std::error_code ec;
+        fs::remove(pdfFile, ec);
+    }
+}
+
+void SaveHandler::setBinaryStrokes(bool enable) { this->binaryStrokes = enable; }
+
 auto SaveHandler::getErrorMessage() -> const std::string& { return this->errorMessage; }
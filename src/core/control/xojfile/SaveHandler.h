@@ -11,9 +11,12 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>        // for size_t
+#include <memory>         // for unique_ptr
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+#include <vector>         // for vector
 
 #include "control/xml/XmlNode.h"    // for XmlNode
 #include "model/BackgroundImage.h"  // for BackgroundImage
@@ -36,16 +39,35 @@ public:
     SaveHandler();
 
 public:
+    /**
+     * Prepare saving the document. Pages are not serialized here: they are streamed directly from the document
+     * to the output in saveTo(), so the document must stay alive and unchanged until saveTo() returns.
+     * Save a snapshot (see Document::createSnapshot()) to avoid keeping the document locked meanwhile.
+     */
     void prepareSave(const Document* doc, const fs::path& target);
     void saveTo(const fs::path& filepath, ProgressListener* listener = nullptr);
     void saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener = nullptr);
     const std::string& getErrorMessage();
 
+    /**
+     * Save to a zip container, with the points of the strokes stored as little-endian doubles in one binary
+     * attachment per page, instead of decimal text (disabled by default). Only used by saveTo(const fs::path&).
+     * Such files can only be read since BINARY_FILE_FORMAT_VERSION.
+     */
+    void setBinaryStrokes(bool enable);
+
+    /**
+     * Write the layers of the pages `pageIds` of the document, as a record of the autosave journal (see
+     * AutosaveJournal). `baseId` identifies the autosave file the record applies to.
+     */
+    void writeJournalRecord(OutputStream* out, const Document* doc, const std::vector<size_t>& pageIds,
+                            const std::string& baseId);
+
 protected:
     static std::string getColorStr(Color c, unsigned char alpha = 0xff);
 
-    virtual void visitPage(XmlNode* root, ConstPageRef p, const Document* doc, int id, const fs::path& target);
-    virtual void visitLayer(XmlNode* page, const Layer* l);
+    virtual void visitPage(OutputStream* out, ConstPageRef p, const Document* doc, int id, const fs::path& target);
+    virtual void visitLayer(OutputStream* out, const Layer* l);
     virtual void visitStroke(XmlPointNode* stroke, const Stroke* s);
 
     /**
@@ -58,12 +80,40 @@ protected:
     virtual void writeTimestamp(XmlAudioNode* xmlAudioNode, const AudioElement* audioElement);
     virtual void writeBackgroundName(XmlNode* background, ConstPageRef p);
 
+private:
+    void writeContentBegin(OutputStream* out, ProgressListener* listener);
+    void writeContentPage(OutputStream* out, size_t id, ProgressListener* listener);
+    void writeContentEnd(OutputStream* out, const fs::path& filepath);
+
+    /**
+     * Write the zip container. Its entries are produced while libzip writes the archive, one page at a time.
+     */
+    void saveToZip(const fs::path& filepath, ProgressListener* listener);
+    void writeBinaryPoints(XmlPointNode* stroke, const Stroke* s);
+
+    /**
+     * Save the attached PDF to a temporary file, to be stored in the zip container
+     * @return The temporary file, or an empty path on error
+     */
+    fs::path saveAttachedPdf(const Document* doc);
+
 protected:
     std::unique_ptr<XmlNode> root{};
+    const Document* doc = nullptr;
+    fs::path target;
+
     bool firstPdfPageVisited;
     int attachBgId;
 
     std::string errorMessage;
 
-    std::vector<BackgroundImage> backgroundImages{};
+    /// The attached background images written so far, with their file name
+    std::vector<std::pair<std::string, BackgroundImage>> backgroundImages{};
+    /// The page on which each background image was written first, by BackgroundImage::getContentId()
+    std::unordered_map<const void*, int> backgroundImagePages{};
+
+    bool binaryStrokes = false;
+    /// Name and size of the binary point attachment of the page being written. Its content is written separately.
+    std::string pointDataName;
+    size_t pointDataSize = 0;
 };
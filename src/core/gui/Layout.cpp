@@ -48,17 +48,33 @@ Layout::Layout(XournalView* view, ScrollHandling* scrollHandling): view(view), s
 }
 
 void Layout::horizontalScrollChanged(GtkAdjustment* adjustment, Layout* layout) {
+    double previousScroll = layout->lastScrollHorizontal;
     Layout::checkScroll(adjustment, layout->lastScrollHorizontal);
     layout->updateVisibility();
+
+    layout->prefetchAlongScroll(layout->lastScrollHorizontal - previousScroll, false);
 }
 
 void Layout::verticalScrollChanged(GtkAdjustment* adjustment, Layout* layout) {
+    double previousScroll = layout->lastScrollVertical;
     Layout::checkScroll(adjustment, layout->lastScrollVertical);
     layout->updateVisibility();
 
+    layout->prefetchAlongScroll(layout->lastScrollVertical - previousScroll, true);
+
     layout->maybeAddLastPage(layout);
 }
 
+void Layout::prefetchAlongScroll(double delta, bool vertical) {
+    const gint64 now = g_get_monotonic_time();
+    // At least a millisecond, for the scroll events received at once
+    const gint64 elapsed = std::max(now - this->lastScrollTime, gint64{1000});
+    const double elapsedSeconds = static_cast<double>(elapsed) / G_USEC_PER_SEC;
+    this->lastScrollTime = now;
+
+    this->view->prefetchPdfPages(delta / elapsedSeconds, vertical);
+}
+
 void Layout::maybeAddLastPage(Layout* layout) {
     auto* control = this->view->getControl();
     auto* settings = control->getSettings();
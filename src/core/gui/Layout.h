@@ -152,6 +152,12 @@ private:
 
     void maybeAddLastPage(Layout* layout);
 
+    /**
+     * Prefetches the PDF backgrounds of the pages ahead, depending on the scroll speed
+     * @param delta The scroll since the last scroll event, in pixels
+     */
+    void prefetchAlongScroll(double delta, bool vertical);
+
     // Todo(Fabian): move to ScrollHandling also it must not depend on Layout
     static void checkScroll(GtkAdjustment* adjustment, double& lastScroll);
 
@@ -162,6 +168,8 @@ private:
     // Todo(Fabian): move to ScrollHandling also it must not depend on Layout
     double lastScrollHorizontal = -1;
     double lastScrollVertical = -1;
+    /// Monotonic time of the last scroll event, in microseconds
+    gint64 lastScrollTime = 0;
 
     /**
      * layoutPages invalidates the precalculation of recalculate
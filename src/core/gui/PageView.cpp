@@ -1,7 +1,8 @@
 #include "PageView.h"
 
-#include <algorithm>  // for max, find_if
+#include <algorithm>  // for max, find_if, remove_if, stable_sort
 #include <cinttypes>  // for int64_t
+#include <cmath>      // for abs, log
 #include <cstdint>    // for int64_t
 #include <cstdlib>    // for size_t
 #include <iomanip>    // for operator<<, quoted
@@ -78,6 +79,7 @@
 #include "util/safe_casts.h"                        // for ceil_cast, floor_cast, round_cast
 #include "util/serdesstream.h"                      // for serdes_stream
 #include "view/DebugShowRepaintBounds.h"            // for IF_DEBUG_REPAINT
+#include "view/TileCache.h"                         // for TileCache, Tile
 #include "view/overlays/OverlayView.h"              // for OverlayView, Tool...
 #include "view/overlays/PdfElementSelectionView.h"  // for PdfElementSelecti...
 #include "view/overlays/SearchResultView.h"         // for SearchResultView
@@ -109,24 +111,33 @@ XojPageView::XojPageView(XournalView* xournal, const PageRef& page):
 XojPageView::~XojPageView() {
     this->unregisterFromHandler();
 
+    cancelRendering();  // So that the scheduler does not wait for a useless rendering to finish
     this->xournal->getControl()->getScheduler()->removePage(this);
 
     this->overlayViews.clear();
     endText();
-    deleteViewBuffer();  // Ensures the mutex is locked during the buffer's destruction
+    deleteViewBuffer();  // Ensures the mutex is locked while the tiles are dropped
 }
 
 void XojPageView::addOverlayView(std::unique_ptr<xoj::view::OverlayView> overlay) {
     this->overlayViews.emplace_back(std::move(overlay));
 }
 
-void XojPageView::setIsVisible(bool visible) { this->visible = visible; }
+void XojPageView::setIsVisible(bool visible) {
+    if (this->visible && !visible) {
+        cancelRendering();
+    }
+    this->visible = visible;
+}
 
 void XojPageView::deleteViewBuffer() {
+    cancelRendering();
     std::lock_guard lock(this->drawingMutex);
-    this->buffer.reset();
+    xoj::view::TileCache::instance().evict(this);
 }
 
+void XojPageView::cancelRendering() { this->renderGeneration++; }
+
 auto XojPageView::containsPoint(int x, int y, bool local) const -> bool {
     if (!local) {
         bool leftOk = this->getX() <= x;
@@ -831,12 +842,19 @@ void XojPageView::flagDirtyRegion(const Range& rg) const { repaintArea(rg.minX,
 void XojPageView::drawAndDeleteToolView(xoj::view::ToolView* v, const Range& rg) {
     if (v->isViewOf(this->inputHandler.get()) || v->isViewOf(this->verticalSpace.get()) ||
         v->isViewOf(this->textEditor.get())) {
-        // Draw the inputHandler's view onto the page buffer.
+        // Draw the inputHandler's view onto the tiles of the page. The missing tiles will be rendered when needed.
         std::lock_guard lock(this->drawingMutex);
-        if (auto cr = buffer.get(); cr) {
-            v->drawWithoutDrawingAids(cr);
-        } else {
-            rerenderPage();
+        const double zoom = getZoom();
+        const int dpiScaling = xournal->getDpiScaleFactor();
+        for (auto& [key, tile]: xoj::view::TileCache::instance().getTiles(this)) {
+            if (!rg.empty() && !tile->getExtent().intersect(rg).isValid()) {
+                continue;
+            }
+            if (key.zoom == zoom && key.dpiScaling == dpiScaling && !tile->stale) {
+                v->drawWithoutDrawingAids(tile->get());
+            } else {
+                tile->stale = true;
+            }
         }
     }
     this->deleteOverlayView(v, rg);
@@ -955,8 +973,6 @@ void XojPageView::drawLoadingPage(cairo_t* cr) {
     cairo_move_to(cr, (page->getWidth() - ex.width) / 2 - ex.x_bearing,
                   (page->getHeight() - ex.height) / 2 - ex.y_bearing);
     cairo_show_text(cr, txtLoading.c_str());
-
-    rerenderPage();
 }
 
 bool XojPageView::displayLinkPopover(std::shared_ptr<XojPdfPage> page, double pageX, double pageY) {
@@ -1050,21 +1066,12 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
     xoj::util::CairoSaveGuard saveGuard(cr);
     cairo_scale(cr, zoom, zoom);
 
-    {
-        std::lock_guard lock(this->drawingMutex);  // Lock the mutex first
-        xoj::util::CairoSaveGuard saveGuard(cr);   // see comment at the end of the scope
-        if (!this->hasBuffer()) {
-            drawLoadingPage(cr);
-            return true;
-        }
-
-        if (this->buffer.getZoom() != zoom) {
-            rerenderPage();
-            cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_FAST);
-        }
-        this->buffer.paintTo(cr);
-    }  // Restore the state of cr and then release the mutex
-       // restoring the state of cr ensures this->buffer.surface is not longer referenced as the source in cr.
+    double x1 = 0;
+    double y1 = 0;
+    double x2 = 0;
+    double y2 = 0;
+    cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+    paintTiles(cr, Range(x1, y1, x2, y2).intersect(Range(0, 0, page->getWidth(), page->getHeight())), zoom);
 
     /**
      * All the overlay painters below follow the assumption:
@@ -1079,13 +1086,84 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
     return true;
 }
 
+void XojPageView::paintTiles(cairo_t* cr, const Range& area, double zoom) {
+    auto& cache = xoj::view::TileCache::instance();
+    const auto range = xoj::view::TileCache::getTileRange(area, zoom);
+    const int dpiScaling = xournal->getDpiScaleFactor();
+
+    std::vector<xoj::view::TileCache::Key> missingTiles;
+    {
+        std::lock_guard lock(this->drawingMutex);  // Lock the mutex first
+        xoj::util::CairoSaveGuard saveGuard(cr);   // see comment at the end of the scope
+
+        std::vector<std::shared_ptr<xoj::view::Tile>> tiles;
+        std::vector<Range> uncoveredAreas;
+        for (int y = range.minY; y <= range.maxY; y++) {
+            for (int x = range.minX; x <= range.maxX; x++) {
+                xoj::view::TileCache::Key key{this, zoom, dpiScaling, x, y};
+                auto tile = cache.lookup(key);
+                if (!tile || tile->stale || tile->draft) {
+                    missingTiles.push_back(key);
+                }
+                if (tile) {
+                    tiles.push_back(std::move(tile));
+                } else {
+                    uncoveredAreas.push_back(xoj::view::TileCache::getTileExtent(x, y, zoom));
+                }
+            }
+        }
+
+        if (!uncoveredAreas.empty()) {
+            // Until the tiles are rendered, show the tiles rendered at another zoom level, scaled
+            xoj::util::CairoSaveGuard saveGuard(cr);
+            for (const Range& rg: uncoveredAreas) {
+                cairo_rectangle(cr, rg.minX, rg.minY, rg.getWidth(), rg.getHeight());
+            }
+            cairo_clip(cr);
+
+            // The tiles rendered at the closest zoom level last, on top of the rougher ones
+            auto otherTiles = cache.getTiles(this);
+            otherTiles.erase(std::remove_if(otherTiles.begin(), otherTiles.end(),
+                                            [&](const auto& entry) {
+                                                return entry.first.zoom == zoom && entry.first.dpiScaling == dpiScaling;
+                                            }),
+                             otherTiles.end());
+            auto distance = [zoom](const auto& entry) { return std::abs(std::log(entry.first.zoom / zoom)); };
+            std::stable_sort(otherTiles.begin(), otherTiles.end(),
+                             [&](const auto& a, const auto& b) { return distance(a) > distance(b); });
+
+            for (auto& [key, tile]: otherTiles) {
+                tile->paintTo(cr);
+            }
+            if (otherTiles.empty()) {
+                drawLoadingPage(cr);
+            }
+        }
+
+        for (const auto& tile: tiles) {
+            tile->paintTo(cr);
+        }
+    }  // Restore the state of cr and then release the mutex
+       // restoring the state of cr ensures the tiles' surfaces are no longer referenced as the source in cr.
+
+    {
+        std::lock_guard lock(this->repaintRectMutex);
+        this->paintedArea = area;
+        if (missingTiles.empty()) {
+            return;
+        }
+        this->neededTiles = std::move(missingTiles);
+    }
+    this->xournal->getControl()->getScheduler()->addRerenderPage(this);
+}
+
 /**
  * GETTER / SETTER
  */
 
 auto XojPageView::isSelected() const -> bool { return selected; }
 
-auto XojPageView::hasBuffer() const -> bool { return this->buffer.isInitialized(); }
+auto XojPageView::hasBuffer() const -> bool { return xoj::view::TileCache::instance().hasTiles(this); }
 
 auto XojPageView::getSelectionColor() -> GdkRGBA { return Util::rgb_to_GdkRGBA(settings->getSelectionColor()); }
 
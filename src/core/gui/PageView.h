@@ -11,7 +11,9 @@
 
 #pragma once
 
+#include <atomic>   // for atomic
 #include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
 #include <memory>   // for unique_ptr, shared_ptr
 #include <mutex>    // for mutex
 #include <string>   // for string
@@ -25,10 +27,11 @@
 #include "gui/inputdevices/InputEvents.h"
 #include "model/PageListener.h"       // for PageListener
 #include "model/PageRef.h"            // for PageRef
+#include "util/Range.h"               // for Range
 #include "util/Rectangle.h"           // for Rectangle
 #include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
-#include "view/Mask.h"                // for Mask
 #include "view/Repaintable.h"         // for Repaintable
+#include "view/TileCache.h"           // for TileCache
 
 #include "Layout.h"            // for Layout
 #include "LegacyRedrawable.h"  // for LegacyRedrawable
@@ -46,7 +49,6 @@ class VerticalToolHandler;
 class XournalView;
 class Element;
 class PositionInputData;
-class Range;
 class TexImage;
 class XojPdfRectangle;
 class XojPdfPage;
@@ -117,6 +119,12 @@ public:
 
     void deleteViewBuffer() override;
 
+    /**
+     * Aborts the rendering of the page in progress, if any, e.g. because the zoom level changed or the page is no
+     * longer visible
+     */
+    void cancelRendering();
+
     /**
      * Returns whether this PageView contains the
      * given point on the display
@@ -211,6 +219,11 @@ private:
 
     void drawLoadingPage(cairo_t* cr);
 
+    /**
+     * Paints the tiles covering the area (in page coordinates) and requests the missing ones
+     */
+    void paintTiles(cairo_t* cr, const Range& area, double zoom);
+
     /**
      * @brief Make and display a popover dialog near the given location.
      *
@@ -282,9 +295,12 @@ private:
     bool visible = true;
     bool selected = false;
 
-    xoj::view::Mask buffer;
+    /// Locked while drawing on or painting the tiles of the page (see xoj::view::TileCache)
     std::mutex drawingMutex;
 
+    /// Incremented to cancel the rendering in progress (see xoj::view::RenderGeneration)
+    std::atomic<uint32_t> renderGeneration = 0;
+
     bool inEraser = false;
 
     /**
@@ -301,6 +317,10 @@ private:
     std::vector<xoj::util::Rectangle<double>> rerenderRects;
     bool rerenderComplete = false;
     bool sizeChanged = false;
+    /// Tiles which were missing or outdated when the page was painted
+    std::vector<xoj::view::TileCache::Key> neededTiles;
+    /// The part of the page painted last
+    Range paintedArea;
 
     int dispX{};  // position on display - set in Layout::layoutPages
     int dispY{};
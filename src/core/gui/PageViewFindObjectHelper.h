@@ -25,6 +25,7 @@
 #include "gui/PageView.h"
 #include "model/Layer.h"
 #include "model/XojPage.h"
+#include "util/Rectangle.h"
 #include "util/safe_casts.h"
 
 #include "XournalView.h"
@@ -112,27 +113,30 @@ public:
 
     bool checkLayer(const Layer* l) override {
         double minDistance = ACTION_RADIUS;
+        const Element* found = nullptr;
+        auto candidates = l->getElementsInArea(xoj::util::Rectangle<double>(
+                x - ACTION_RADIUS, y - ACTION_RADIUS, 2. * ACTION_RADIUS, 2. * ACTION_RADIUS));
         // Iterate starting from the front-most element
-        Element::Index pos = as_signed(l->getElementsView().size());
-        for (auto it = l->getElementsView().rbegin(); it < l->getElementsView().rend(); ++it) {
-            pos--;
+        for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
             // First perform a rough check to avoid expensive calls to Stroke::distanceTo()
             if ((*it)->intersectsArea(x - minDistance, y - minDistance, 2. * minDistance, 2. * minDistance)) {
                 double d = (*it)->distanceTo(x, y);
-                if (d == 0.0) {
-                    this->match = *it;
-                    this->matchIndex = pos;
-                    return true;
-                }
                 if (d < minDistance) {
-                    this->match = *it;
-                    this->matchIndex = pos;
+                    found = *it;
                     minDistance = d;
+                    if (d == 0.0) {
+                        break;
+                    }
                     // Keep going, we may find something closer
                 }
             }
         }
-        return minDistance != ACTION_RADIUS;
+        if (!found) {
+            return false;
+        }
+        this->match = found;
+        this->matchIndex = l->indexOf(found);
+        return true;
     }
 
 private:
@@ -162,7 +166,9 @@ protected:
     /// Plays every element of the layer that are closer than ACTION_RADIUS
     bool checkLayer(const Layer* l) override {
         bool found = false;
-        for (auto&& e: l->getElementsView()) {
+        auto candidates = l->getElementsInArea(xoj::util::Rectangle<double>(
+                x - ACTION_RADIUS, y - ACTION_RADIUS, 2. * ACTION_RADIUS, 2. * ACTION_RADIUS));
+        for (const Element* e: candidates) {
             if (auto* audio = dynamic_cast<const AudioElement*>(e); audio) {
                 // First perform a rough check to avoid expensive calls to Stroke::distanceTo()
                 if (audio->intersectsArea(x - ACTION_RADIUS, y - ACTION_RADIUS, 2. * ACTION_RADIUS,
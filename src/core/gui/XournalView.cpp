@@ -1,12 +1,15 @@
 #include "XournalView.h"
 
-#include <algorithm>  // for max, min
+#include <algorithm>  // for max, min, clamp
+#include <cmath>      // for abs
 #include <iterator>   // for begin
 #include <memory>     // for unique_ptr, make_unique
 #include <optional>   // for optional
+#include <vector>     // for vector
 
 #include <gdk/gdk.h>         // for GdkEventKey, GDK_SHIF...
 #include <gdk/gdkkeysyms.h>  // for GDK_KEY_Page_Down
+#include <gio/gio.h>         // for GMemoryMonitor
 #include <glib-object.h>     // for g_object_ref_sink
 
 #include "control/Control.h"                     // for Control
@@ -14,6 +17,7 @@
 #include "control/ScrollHandler.h"               // for ScrollHandler
 #include "control/ToolHandler.h"                 // for ToolHandler
 #include "control/actions/ActionDatabase.h"      // for ActionDatabase
+#include "control/jobs/PdfPrefetchJob.h"         // for PdfPrefetchJob
 #include "control/jobs/XournalScheduler.h"       // for XournalScheduler
 #include "control/settings/MetadataManager.h"    // for MetadataManager
 #include "control/settings/Settings.h"           // for Settings
@@ -30,8 +34,10 @@
 #include "gui/widgets/XournalWidget.h"           // for gtk_xournal_get_layout
 #include "model/Document.h"                      // for Document
 #include "model/Element.h"                       // for Element, ELEMENT_STROKE
+#include "model/ImageCache.h"                    // for ImageCache
 #include "model/PageRef.h"                       // for PageRef
 #include "model/Stroke.h"                        // for Stroke, StrokeTool::E...
+#include "model/StrokeContourCache.h"            // for StrokeContourCache
 #include "model/XojPage.h"                       // for XojPage
 #include "undo/DeleteUndoAction.h"               // for DeleteUndoAction
 #include "undo/UndoRedoHandler.h"                // for UndoRedoHandler
@@ -41,7 +47,7 @@
 #include "util/Util.h"                           // for npos
 #include "util/glib_casts.h"                     // for wrap_v
 #include "util/gtk4_helper.h"                    // for gtk_scrolled_window_set_child
-#include "util/safe_casts.h"                     // for round_cast
+#include "util/safe_casts.h"                     // for round_cast, ceil_cast
 
 #include "Layout.h"           // for Layout
 #include "PageView.h"         // for XojPageView
@@ -54,6 +60,12 @@ constexpr int REGULAR_MOVE_AMOUNT = 3;
 constexpr int SMALL_MOVE_AMOUNT = 1;
 constexpr int LARGE_MOVE_AMOUNT = 10;
 
+/// The PDF backgrounds of the pages reached within this time at the current scroll speed are prefetched, in seconds
+constexpr double PDF_PREFETCH_HORIZON = 1.0;
+
+/// The maximum number of PDF backgrounds prefetched ahead of the visible pages
+constexpr size_t PDF_PREFETCH_MAX_PAGES = 8;
+
 std::pair<size_t, size_t> XournalView::preloadPageBounds(size_t page, size_t maxPage) {
     const size_t preloadBefore = this->control->getSettings()->getPreloadPagesBefore();
     const size_t preloadAfter = this->control->getSettings()->getPreloadPagesAfter();
@@ -71,6 +83,8 @@ XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* sc
     }
     doc->unlock();
 
+    onSettingsChanged();
+
     registerListener(control);
 
     InputContext* inputContext = new InputContext(this, scrollHandling);
@@ -101,10 +115,23 @@ XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* sc
     gtk_widget_grab_focus(this->widget);
 
     this->cleanupTimeout = g_timeout_add_seconds(5, xoj::util::wrap_v<clearMemoryTimer>, this);
+
+#if GLIB_CHECK_VERSION(2, 64, 0)
+    this->memoryMonitor.reset(G_OBJECT(g_memory_monitor_dup_default()), xoj::util::adopt);
+    g_signal_connect(this->memoryMonitor.get(), "low-memory-warning",
+                     G_CALLBACK(+[](GMemoryMonitor*, GMemoryMonitorWarningLevel, gpointer self) {
+                         static_cast<XournalView*>(self)->unloadHiddenPages();
+                     }),
+                     this);
+#endif
 }
 
 XournalView::~XournalView() {
+    cancelPdfPrefetch();
     g_source_remove(this->cleanupTimeout);
+    if (this->memoryMonitor) {
+        g_signal_handlers_disconnect_by_data(this->memoryMonitor.get(), this);
+    }
 
     gtk_widget_destroy(this->widget);
     this->widget = nullptr;
@@ -120,14 +147,44 @@ auto XournalView::cleanupBufferCache() -> void {
     const auto& [pagesLower, pagesUpper] = this->preloadPageBounds(this->currentPage, this->viewPages.size());
     xoj_assert(pagesLower <= pagesUpper);
 
+    std::vector<PageRef> hiddenPages;
     for (size_t i = 0; i < this->viewPages.size(); i++) {
         auto&& page = this->viewPages[i];
         const size_t pageNum = i + 1;
         const bool isPreload = pagesLower <= pageNum && pageNum <= pagesUpper;
         if (!isPreload && !page->isVisible() && page->hasBuffer()) {
             page->deleteViewBuffer();
+            hiddenPages.push_back(page->getPage());
         }
     }
+
+    if (!hiddenPages.empty()) {
+        // The images of these pages are decoded again only if the pages are rendered again
+        Document* doc = control->getDocument();
+        doc->lock();
+        for (const PageRef& page: hiddenPages) {
+            page->releaseImages();
+        }
+        doc->unlock();
+    }
+}
+
+auto XournalView::unloadHiddenPages() -> void {
+    const auto& [pagesLower, pagesUpper] = this->preloadPageBounds(this->currentPage, this->viewPages.size());
+
+    Document* doc = control->getDocument();
+    doc->lock();
+    for (size_t i = 0; i < this->viewPages.size(); i++) {
+        auto&& page = this->viewPages[i];
+        const size_t pageNum = i + 1;
+        const bool isPreload = pagesLower <= pageNum && pageNum <= pagesUpper;
+        if (!isPreload && !page->isVisible()) {
+            page->getPage()->unloadLayers();
+        }
+    }
+    doc->unlock();
+
+    ImageCache::instance().evictUnused();
 }
 
 auto XournalView::getCurrentPage() const -> size_t { return currentPage; }
@@ -342,6 +399,9 @@ void XournalView::onSettingsChanged() {
     if (this->cache) {
         this->cache->updateSettings(control->getSettings());
     }
+    Settings* settings = control->getSettings();
+    ImageCache::instance().setMaxSize(size_t{settings->getImageCacheSize()} * 1024 * 1024);
+    xoj::view::StrokeContourCache::instance().setMaxSize(size_t{settings->getStrokeContourCacheSize()} * 1024 * 1024);
 }
 
 // send the focus back to the appropriate widget
@@ -522,6 +582,7 @@ auto XournalView::getVisibleRect(const XojPageView* redrawable) const -> Rectang
 }
 
 void XournalView::recreatePdfCache() {
+    cancelPdfPrefetch();
     this->cache.reset();
 
     Document* doc = control->getDocument();
@@ -532,6 +593,72 @@ void XournalView::recreatePdfCache() {
     doc->unlock();
 }
 
+void XournalView::prefetchPdfPages(double velocity, bool vertical) {
+    if (!this->cache || velocity == 0.0) {
+        return;
+    }
+    const int direction = velocity > 0 ? 1 : -1;
+
+    std::optional<size_t> firstVisible;
+    std::optional<size_t> lastVisible;
+    for (size_t i = 0; i < this->viewPages.size(); i++) {
+        if (this->viewPages[i]->isVisible()) {
+            firstVisible = firstVisible.value_or(i);
+            lastVisible = i;
+        }
+    }
+    if (!firstVisible || (direction < 0 && *firstVisible == 0)) {
+        return;
+    }
+
+    const size_t from = direction > 0 ? *lastVisible + 1 : *firstVisible - 1;
+    const XojPageView* edgePage = this->viewPages[direction > 0 ? *lastVisible : *firstVisible].get();
+    const double pageExtent = vertical ? edgePage->getDisplayHeightDouble() : edgePage->getDisplayWidthDouble();
+    const size_t count = std::clamp(ceil_cast<size_t>(std::abs(velocity) * PDF_PREFETCH_HORIZON / pageExtent),
+                                    size_t{1}, PDF_PREFETCH_MAX_PAGES);
+
+    if (direction == this->pdfPrefetchDirection && from == this->pdfPrefetchFrom && count <= this->pdfPrefetchCount) {
+        // Already scheduled
+        return;
+    }
+    // Supersedes the previous prefetching, in particular if the direction changed
+    this->pdfPrefetchGeneration++;
+    this->pdfPrefetchDirection = direction;
+    this->pdfPrefetchFrom = from;
+    this->pdfPrefetchCount = count;
+
+    std::vector<size_t> pdfPageNos;
+    Document* doc = control->getDocument();
+    doc->lock();
+    for (size_t n = 0; n < count; n++) {
+        const size_t i = direction > 0 ? from + n : from - n;
+        if (i >= this->viewPages.size()) {
+            // Also stops when scrolling backwards past the first page
+            break;
+        }
+        PageRef page = this->viewPages[i]->getPage();
+        if (page->getBackgroundType().isPdfPage()) {
+            pdfPageNos.push_back(page->getPdfPageNr());
+        }
+    }
+    doc->unlock();
+
+    if (pdfPageNos.empty()) {
+        return;
+    }
+    auto* job = new PdfPrefetchJob(this, std::move(pdfPageNos), getZoom(), getDpiScaleFactor(),
+                                   {&this->pdfPrefetchGeneration, this->pdfPrefetchGeneration.load()});
+    control->getScheduler()->addPdfPrefetch(job);
+    job->unref();
+}
+
+void XournalView::cancelPdfPrefetch() {
+    this->pdfPrefetchGeneration++;
+    this->pdfPrefetchDirection = 0;
+    // The running job uses the PDF cache
+    control->getScheduler()->removePdfPrefetch(this);
+}
+
 /**
  * @return Helper class for Touch specific fixes
  */
@@ -552,6 +679,13 @@ void XournalView::ensureRectIsVisible(int x, int y, int width, int height) {
 }
 
 void XournalView::zoomChanged() {
+    for (auto& page: this->viewPages) {
+        // The pages are rendered again at the new zoom level
+        page->cancelRendering();
+    }
+    // The PDF backgrounds are prefetched again at the new zoom level, on the next scroll
+    this->pdfPrefetchGeneration++;
+    this->pdfPrefetchDirection = 0;
 
     size_t currentPage = this->getCurrentPage();
     XojPageView* view = getViewFor(currentPage);
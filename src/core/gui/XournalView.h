@@ -11,7 +11,9 @@
 
 #pragma once
 
+#include <atomic>   // for atomic
 #include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
 #include <limits>   // for numeric_limits
 #include <memory>   // for unique_ptr
 #include <string>   // for string
@@ -28,6 +30,7 @@
 #include "model/DocumentListener.h"        // for DocumentListener
 #include "pdf/base/XojPdfPage.h"           // for XojPdfRectangle
 #include "util/Util.h"                     // for npos
+#include "util/raii/GObjectSPtr.h"         // for GObjectSPtr
 
 class Control;
 class XournalppCursor;
@@ -120,6 +123,14 @@ public:
      */
     void recreatePdfCache();
 
+    /**
+     * Renders the PDF backgrounds of the next pages in the scroll direction into the PDF cache, ahead of time.
+     * Prefetching stops when the direction changes.
+     * @param velocity The scroll speed, in pixels per second, positive when scrolling forward
+     * @param vertical The scroll is vertical
+     */
+    void prefetchPdfPages(double velocity, bool vertical);
+
     /**
      * A pen action was detected now, therefore ignore touch events
      * for a short time
@@ -164,6 +175,16 @@ private:
 
     void cleanupBufferCache();
 
+    /**
+     * Frees the contents of the hidden pages outside of the preload range, if they can be loaded again
+     */
+    void unloadHiddenPages();
+
+    /**
+     * Stops the prefetching of the PDF backgrounds, if any
+     */
+    void cancelPdfPrefetch();
+
 private:
     /**
      * Scrollbars
@@ -181,6 +202,14 @@ private:
 
     std::unique_ptr<PdfCache> cache;
 
+    /// Incremented to cancel the prefetching of the PDF backgrounds (see xoj::view::RenderGeneration)
+    std::atomic<uint32_t> pdfPrefetchGeneration = 0;
+
+    /// The last prefetching scheduled: scroll direction (0 if none), first page and number of pages
+    int pdfPrefetchDirection = 0;
+    size_t pdfPrefetchFrom = 0;
+    size_t pdfPrefetchCount = 0;
+
     /**
      * Handler for rerendering pages / repainting pages
      */
@@ -191,5 +220,10 @@ private:
      */
     guint cleanupTimeout = std::numeric_limits<guint>::max();
 
+    /**
+     * The system memory monitor (a GMemoryMonitor), to unload pages on low memory
+     */
+    xoj::util::GObjectSPtr<GObject> memoryMonitor;
+
     friend class Layout;
 };
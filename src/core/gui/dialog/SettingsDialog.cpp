@@ -623,6 +623,12 @@ void SettingsDialog::load() {
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(builder.get("preloadPagesAfter")),
                               static_cast<double>(settings->getPreloadPagesAfter()));
     loadCheckbox("cbEagerPageCleanup", settings->isEagerPageCleanup());
+    loadCheckbox("cbLoadPagesOnDemand", settings->isLoadPagesOnDemand());
+    loadCheckbox("cbSaveBinaryStrokes", settings->isSaveBinaryStrokes());
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(builder.get("spImageCacheSize")),
+                              static_cast<double>(settings->getImageCacheSize()));
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(builder.get("spRenderThreads")),
+                              static_cast<double>(settings->getRenderThreads()));
 
     disableWithCheckbox("cbUnlimitedScrolling", "cbAddVerticalSpace");
     disableWithCheckbox("cbUnlimitedScrolling", "cbAddHorizontalSpace");
@@ -914,6 +920,10 @@ void SettingsDialog::save() {
     settings->setPreloadPagesAfter(preloadPagesAfter);
     settings->setPreloadPagesBefore(preloadPagesBefore);
     settings->setEagerPageCleanup(getCheckbox("cbEagerPageCleanup"));
+    settings->setLoadPagesOnDemand(getCheckbox("cbLoadPagesOnDemand"));
+    settings->setSaveBinaryStrokes(getCheckbox("cbSaveBinaryStrokes"));
+    settings->setImageCacheSize(spinAsUint(GTK_SPIN_BUTTON(builder.get("spImageCacheSize"))));
+    settings->setRenderThreads(spinAsUint(GTK_SPIN_BUTTON(builder.get("spRenderThreads"))));
 
     settings->setDefaultSaveName(
             xoj::util::utf8(gtk_editable_get_text(GTK_EDITABLE(builder.get("txtDefaultSaveName")))).str());
@@ -1,8 +1,16 @@
 #include "BackgroundImage.h"
 
-#include <string>   // for string
-#include <utility>  // for move
-
+#include <algorithm>  // for max, find_if, rotate
+#include <cstddef>    // for size_t
+#include <cmath>      // for floor, log2, ldexp
+#include <iterator>   // for next, prev
+#include <mutex>      // for mutex, lock_guard
+#include <string>     // for string
+#include <utility>    // for move, pair
+#include <vector>     // for vector
+
+#include <cairo.h>        // for cairo_image_surface_create
+#include <gdk/gdk.h>      // for gdk_cairo_surface_create_from_pixbuf
 #include <glib-object.h>  // for g_object_unref
 
 #include "util/Stacktrace.h"  // for Stacktrace
@@ -32,16 +40,44 @@ struct BackgroundImage::Content {
     };
 
     Content(const Content&) = delete;
-    Content(Content&&) = default;
+    Content(Content&&) = delete;
     auto operator=(const Content&) -> Content& = delete;
-    auto operator=(Content&&) -> Content& = default;
+    auto operator=(Content&&) -> Content& = delete;
 
     fs::path path;
     GdkPixbuf* pixbuf = nullptr;
-    int pageId = -1;
     bool attach = false;
+
+    /// Protects the surfaces, which are created while rendering, possibly by several threads
+    std::mutex surfaceMutex;
+    /// The pixbuf converted to a cairo surface
+    xoj::util::CairoSurfaceSPtr surface;
+    /// The downscaled versions of the surface with their level, most recently used first
+    std::vector<std::pair<int, xoj::util::CairoSurfaceSPtr>> mipmaps;
 };
 
+/// The smallest version of an image is 2^MAX_MIPMAP_LEVEL times smaller than the image
+constexpr int MAX_MIPMAP_LEVEL = 6;
+
+/// How many downscaled versions of an image are kept, e.g. one for the sidebar and one for the main view
+constexpr size_t MAX_CACHED_MIPMAPS = 2;
+
+/// The version of the surface 2^level times smaller
+static auto createScaledSurface(cairo_surface_t* source, int level) -> xoj::util::CairoSurfaceSPtr {
+    const int width = std::max(cairo_image_surface_get_width(source) >> level, 1);
+    const int height = std::max(cairo_image_surface_get_height(source) >> level, 1);
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
+                                        xoj::util::adopt);
+    xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+    cairo_scale(cr.get(), static_cast<double>(width) / cairo_image_surface_get_width(source),
+                static_cast<double>(height) / cairo_image_surface_get_height(source));
+    cairo_set_source_surface(cr.get(), source, 0, 0);
+    cairo_pattern_set_filter(cairo_get_source(cr.get()), CAIRO_FILTER_GOOD);
+    cairo_set_operator(cr.get(), CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr.get());
+    return surface;
+}
+
 void BackgroundImage::free() { this->img.reset(); }
 
 void BackgroundImage::loadFile(fs::path const& path, GError** error) {
@@ -52,24 +88,10 @@ void BackgroundImage::loadFile(GInputStream* stream, fs::path const& path, GErro
     this->img = std::make_shared<Content>(stream, path, error);
 }
 
-auto BackgroundImage::getCloneId() const -> int { return this->img ? this->img->pageId : -1; }
-
-void BackgroundImage::setCloneId(int id) {
-    if (this->img) {
-        this->img->pageId = id;
-    }
-}
-
-void BackgroundImage::clearSaveState() { this->setCloneId(-1); }
+auto BackgroundImage::getContentId() const -> const void* { return this->img.get(); }
 
 auto BackgroundImage::getFilepath() const -> fs::path { return this->img ? this->img->path : fs::path{}; }
 
-void BackgroundImage::setFilepath(fs::path path) {
-    if (this->img) {
-        this->img->path = std::move(path);
-    }
-}
-
 auto BackgroundImage::isAttached() const -> bool { return this->img ? this->img->attach : false; }
 
 void BackgroundImage::setAttach(bool attach) {
@@ -84,4 +106,38 @@ void BackgroundImage::setAttach(bool attach) {
 auto BackgroundImage::getPixbuf() -> GdkPixbuf* { return this->img ? this->img->pixbuf : nullptr; }
 auto BackgroundImage::getPixbuf() const -> const GdkPixbuf* { return this->img ? this->img->pixbuf : nullptr; }
 
+auto BackgroundImage::getSurface(double scale) const -> xoj::util::CairoSurfaceSPtr {
+    if (!this->img || !this->img->pixbuf) {
+        return nullptr;
+    }
+
+    // The smallest version which is still at least as large as painted
+    int level = 0;
+    if (scale < 1.0) {
+        level = scale > std::ldexp(1.0, -MAX_MIPMAP_LEVEL) ? static_cast<int>(std::floor(-std::log2(scale))) :
+                                                             MAX_MIPMAP_LEVEL;
+    }
+
+    std::lock_guard lock(this->img->surfaceMutex);
+    if (!this->img->surface) {
+        // Premultiplied once and for all, instead of every time the image is painted
+        this->img->surface.reset(gdk_cairo_surface_create_from_pixbuf(this->img->pixbuf, 1, nullptr), xoj::util::adopt);
+    }
+    if (level == 0) {
+        return this->img->surface;
+    }
+
+    auto& mipmaps = this->img->mipmaps;
+    auto it = std::find_if(mipmaps.begin(), mipmaps.end(), [level](const auto& m) { return m.first == level; });
+    if (it == mipmaps.end()) {
+        if (mipmaps.size() >= MAX_CACHED_MIPMAPS) {
+            mipmaps.pop_back();
+        }
+        mipmaps.emplace_back(level, createScaledSurface(this->img->surface.get(), level));
+        it = std::prev(mipmaps.end());
+    }
+    std::rotate(mipmaps.begin(), it, std::next(it));
+    return mipmaps.front().second;
+}
+
 auto BackgroundImage::isEmpty() const -> bool { return !this->img; }
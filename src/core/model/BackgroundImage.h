@@ -17,6 +17,8 @@
 #include <gio/gio.h>                // for GInputStream
 #include <glib.h>                   // for GError
 
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
 #include "filesystem.h"  // for path
 
 struct BackgroundImage {
@@ -27,12 +29,12 @@ struct BackgroundImage {
     void loadFile(fs::path const& filepath, GError** error);
     void loadFile(GInputStream* stream, fs::path const& filepath, GError** error);
 
-    int getCloneId() const;
-    void setCloneId(int id);
-    void clearSaveState();
+    /**
+     * @return An identifier of the image data, shared by the copies of this object, or nullptr if no image is loaded
+     */
+    const void* getContentId() const;
 
     fs::path getFilepath() const;
-    void setFilepath(fs::path filepath);
 
     bool isAttached() const;
     void setAttach(bool attach);
@@ -40,6 +42,15 @@ struct BackgroundImage {
     GdkPixbuf* getPixbuf();
     const GdkPixbuf* getPixbuf() const;
 
+    /**
+     * The image converted to a cairo surface. The conversion is done once, and shared by the clones of the image.
+     * @param scale The scale at which the image will be painted, relative to the size of the pixbuf. Below 1, the
+     * smallest downscaled version of the image which is at least as large as painted is returned. Only the last
+     * few downscaled versions used are kept.
+     * @return The surface, or nullptr if no image is loaded
+     */
+    xoj::util::CairoSurfaceSPtr getSurface(double scale = 1.0) const;
+
     bool isEmpty() const;
 
 private:
@@ -108,6 +108,7 @@ void Document::clearDocument(bool destroy) {
 
     this->pages.clear();
     this->pageIndex.reset();
+    this->snapshotPages.clear();
     freeTreeContentModel();
 
     this->filepath = fs::path{};
@@ -121,6 +122,38 @@ auto Document::getPageCount() const -> size_t { return this->pages.size(); }
 
 auto Document::getPdfPageCount() const -> size_t { return pdfDocument.getPageCount(); }
 
+auto Document::createSnapshot(DocumentHandler* handler) const -> std::unique_ptr<Document> {
+    auto snapshot = std::make_unique<Document>(handler);
+    snapshot->pdfDocument = this->pdfDocument;
+    snapshot->password = this->password;
+    snapshot->createBackupOnSave = this->createBackupOnSave;
+    snapshot->pdfFilepath = this->pdfFilepath;
+    snapshot->filepath = this->filepath;
+    snapshot->attachPdf = this->attachPdf;
+    snapshot->pathStorageMode = this->pathStorageMode;
+    snapshot->setPreview(this->preview);
+
+    // Only the copies of the current pages are kept
+    decltype(this->snapshotPages) copies;
+    copies.reserve(this->pages.size());
+    snapshot->pages.reserve(this->pages.size());
+    for (const PageRef& page: this->pages) {
+        size_t revision = page->getRevision();
+        auto it = this->snapshotPages.find(page.get());
+        // The address of a deleted page may be reused by another one
+        bool unchanged = it != this->snapshotPages.end() && it->second.revision == revision &&
+                         it->second.original.lock() == page;
+        PageRef copy = unchanged ? it->second.copy.lock() : nullptr;
+        if (!copy) {
+            copy = std::make_shared<XojPage>(*page);
+        }
+        snapshot->pages.push_back(copy);
+        copies[page.get()] = SnapshotPage{page, revision, copy};
+    }
+    this->snapshotPages = std::move(copies);
+    return snapshot;
+}
+
 void Document::setFilepath(fs::path filepath) { this->filepath = std::move(filepath); }
 
 auto Document::getFilepath() const -> fs::path { return filepath; }
@@ -14,7 +14,7 @@
 #pragma once
 
 #include <cstddef>        // for size_t
-#include <memory>         // for unique_ptr
+#include <memory>         // for unique_ptr, weak_ptr
 #include <mutex>          // for mutex
 #include <string>         // for string
 #include <unordered_map>  // for unordered_map
@@ -75,6 +75,15 @@ public:
 
     Document& operator=(const Document& doc);
 
+    /**
+     * Creates a copy of the document to save it without keeping this document locked. The document must be locked.
+     * Pages are copied, but their layers are shared as long as they can be loaded again (see XojPage::XojPage()).
+     * The copies are shared with the snapshots still alive, e.g. a save running while autosaving, so that only the
+     * pages changed since are copied again (see XojPage::getRevision()). They are released with the last snapshot
+     * using them. The pages of a snapshot must not be modified.
+     */
+    std::unique_ptr<Document> createSnapshot(DocumentHandler* handler) const;
+
     void setFilepath(fs::path filepath);
     fs::path getFilepath() const;
     fs::path getPdfFilepath() const;
@@ -167,6 +176,16 @@ private:
      */
     cairo_surface_t* preview = nullptr;
 
+    /**
+     * The copies of the pages made by the last snapshot, by original page. They are owned by the snapshots only.
+     */
+    struct SnapshotPage {
+        std::weak_ptr<XojPage> original;
+        size_t revision;
+        std::weak_ptr<XojPage> copy;
+    };
+    mutable std::unordered_map<const XojPage*, SnapshotPage> snapshotPages;
+
     /**
      * The lock of the document
      */
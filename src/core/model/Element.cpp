@@ -6,6 +6,7 @@
 
 #include <glib.h>  // for gint
 
+#include "model/Layer.h"                          // for Layer
 #include "util/safe_casts.h"                      // for as_unsigned
 #include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
 #include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
@@ -14,16 +15,48 @@ using xoj::util::Rectangle;
 
 Element::Element(ElementType type): type(type) {}
 
+Element::Element(const Element& other):
+        Serializable(other),
+        sizeCalculated(other.sizeCalculated),
+        width(other.width),
+        height(other.height),
+        x(other.x),
+        y(other.y),
+        snappedBounds(other.snappedBounds),
+        type(other.type),
+        color(other.color) {}
+
+auto Element::operator=(const Element& other) -> Element& {
+    this->sizeCalculated = other.sizeCalculated;
+    this->width = other.width;
+    this->height = other.height;
+    this->x = other.x;
+    this->y = other.y;
+    this->snappedBounds = other.snappedBounds;
+    this->type = other.type;
+    this->color = other.color;
+    boundsChanged();
+    return *this;
+}
+
+void Element::boundsChanged() {
+    if (this->layer) {
+        this->layer->elementBoundsChanged(this);
+    }
+}
+
 auto Element::getType() const -> ElementType { return this->type; }
 
 void Element::setX(double x) {
     this->x = x;
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 void Element::setY(double y) {
     this->y = y;
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Element::getX() const -> double {
@@ -53,6 +86,7 @@ void Element::move(double dx, double dy) {
     this->x += dx;
     this->y += dy;
     this->snappedBounds = this->snappedBounds.translated(dx, dy);
+    boundsChanged();
 }
 
 auto Element::getElementWidth() const -> double {
@@ -11,7 +11,7 @@
 
 #pragma once
 
-#include <cstddef>  // for ptrdiff_t
+#include <cstddef>  // for ptrdiff_t, size_t
 #include <memory>   // for unique_ptr
 #include <vector>   // for vector
 
@@ -21,6 +21,7 @@
 #include "util/Rectangle.h"                 // for Rectangle
 #include "util/serializing/Serializable.h"  // for Serializable
 
+class Layer;
 class ObjectInputStream;
 class ObjectOutputStream;
 
@@ -40,6 +41,10 @@ class Element: public Serializable {
 protected:
     Element(ElementType type);
 
+    /// The copy is not part of the layer of `other`
+    Element(const Element& other);
+    Element& operator=(const Element& other);
+
 public:
     ~Element() override = default;
 
@@ -90,6 +95,11 @@ private:
 protected:
     virtual void calcSize() const = 0;
 
+    /**
+     * Must be called whenever the bounds of the element change, to keep the spatial index of its layer up to date
+     */
+    void boundsChanged();
+
 protected:
     // If the size has been calculated
     mutable bool sizeCalculated = false;
@@ -114,6 +124,18 @@ private:
      * The color in RGB format
      */
     Color color{0U};
+
+    /**
+     * The layer containing this element, if any. Set by the layer.
+     */
+    Layer* layer = nullptr;
+
+    /**
+     * Position of this element in its layer, maintained lazily by the layer (see Layer::indexOf())
+     */
+    size_t positionInLayer = 0;
+
+    friend class Layer;
 };
 
 namespace xoj {
@@ -10,9 +10,10 @@
 #include <gdk/gdk.h>  // for gdk_cairo_set_sourc...
 #include <glib.h>     // for guchar
 
-#include "model/Element.h"   // for Element, ELEMENT_IMAGE
-#include "util/Assert.h"     // for xoj_assert
-#include "util/Rectangle.h"  // for Rectangle
+#include "model/Element.h"     // for Element, ELEMENT_IMAGE
+#include "model/ImageCache.h"  // for ImageCache
+#include "util/Assert.h"       // for xoj_assert
+#include "util/Rectangle.h"    // for Rectangle
 #include "util/i18n.h"
 #include "util/raii/GObjectSPtr.h"  // for GObjectSPtr
 #include "util/safe_casts.h"
@@ -24,11 +25,7 @@ using xoj::util::Rectangle;
 Image::Image(): Element(ELEMENT_IMAGE) {}
 
 Image::~Image() {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-
+    releaseImage();
     if (this->format) {
         gdk_pixbuf_format_free(this->format);
         this->format = nullptr;
@@ -44,8 +41,9 @@ auto Image::clone() const -> ElementPtr {
     img->width = this->width;
     img->height = this->height;
     img->data = this->data;
+    img->cacheKey = this->cacheKey;
+    img->imageSize = this->imageSize;
 
-    img->image = cairo_surface_reference(this->image);
     img->snappedBounds = this->snappedBounds;
     img->sizeCalculated = this->sizeCalculated;
 
@@ -55,21 +53,22 @@ auto Image::clone() const -> ElementPtr {
 void Image::setWidth(double width) {
     this->width = width;
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::setHeight(double height) {
     this->height = height;
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::setImage(std::string_view data) { setImage(std::string(data)); }
 
 void Image::setImage(std::string&& data) {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
     this->data = std::move(data);
+    releaseImage();
+    this->cacheKey = ImageCache::computeKey(this->data);
+    this->imageSize = NOSIZE;
 
     if (this->format) {
         gdk_pixbuf_format_free(this->format);
@@ -105,17 +104,15 @@ void Image::setImage(std::string&& data) {
 }
 
 void Image::setImage(GdkPixbuf* img) {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
     this->imageSize = {gdk_pixbuf_get_width(img), gdk_pixbuf_get_height(img)};
 
-    this->image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->imageSize.first, this->imageSize.second);
-    xoj_assert(this->image != nullptr);
+    xoj::util::CairoSurfaceSPtr image(
+            cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->imageSize.first, this->imageSize.second),
+            xoj::util::adopt);
+    xoj_assert(image);
 
     // Paint the pixbuf on to the surface
-    cairo_t* cr = cairo_create(this->image);
+    cairo_t* cr = cairo_create(image.get());
     gdk_cairo_set_source_pixbuf(cr, img, 0, 0);
     cairo_paint(cr);
     cairo_destroy(cr);
@@ -125,13 +122,26 @@ void Image::setImage(GdkPixbuf* img) {
         reinterpret_cast<decltype(Image::data)*>(bufferPtr)->append(reinterpret_cast<const char*>(data), length);
         return CAIRO_STATUS_SUCCESS;
     };
-    cairo_surface_write_to_png_stream(image, writeFunc, &data);
+    this->data.clear();
+    cairo_surface_write_to_png_stream(image.get(), writeFunc, &data);
+
+    releaseImage();
+    this->cacheKey = ImageCache::computeKey(this->data);
+    ImageCache::instance().cache(this->cacheKey, std::move(image));
+    retainImage();
 }
 
 auto Image::renderBuffer() const -> std::optional<std::string> {
+    xoj::util::CairoSurfaceSPtr surface;
+    return render(surface);
+}
+
+auto Image::render(xoj::util::CairoSurfaceSPtr& surface) const -> std::optional<std::string> {
     xoj_assert_message(data.length() > 0, "image has no data, cannot render it!");
-    if (this->image) {
+    if ((surface = ImageCache::instance().lookup(this->cacheKey))) {
         // Already rendered
+        retainImage();
+        this->imageSize = {cairo_image_surface_get_width(surface.get()), cairo_image_surface_get_height(surface.get())};
         return std::nullopt;
     }
     xoj::util::GObjectSPtr<GdkPixbufLoader> loader(gdk_pixbuf_loader_new(), xoj::util::adopt);
@@ -183,25 +193,44 @@ auto Image::renderBuffer() const -> std::optional<std::string> {
     this->imageSize = {gdk_pixbuf_get_width(pixbuf.get()), gdk_pixbuf_get_height(pixbuf.get())};
 
     // TODO: pass in window once this code is refactored into ImageView
-    this->image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->imageSize.first, this->imageSize.second);
-    g_assert(this->image != nullptr);
+    surface.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->imageSize.first, this->imageSize.second),
+                  xoj::util::adopt);
+    g_assert(surface);
 
     // Paint the pixbuf on to the surface
     // NOTE: we do this manually instead of using gdk_cairo_surface_create_from_pixbuf
     // since this does not work in CLI mode.
-    cairo_t* cr = cairo_create(this->image);
+    cairo_t* cr = cairo_create(surface.get());
     gdk_cairo_set_source_pixbuf(cr, pixbuf.get(), 0, 0);
     cairo_paint(cr);
     cairo_destroy(cr);
+
+    ImageCache::instance().cache(this->cacheKey, surface);
+    retainImage();
     return std::nullopt;
 }
 
-auto Image::getImage() const -> cairo_surface_t* {
-    if (auto opt = renderBuffer(); opt.has_value()) {
+auto Image::getImage() const -> xoj::util::CairoSurfaceSPtr {
+    xoj::util::CairoSurfaceSPtr surface;
+    if (auto opt = render(surface); opt.has_value()) {
         // An error occurred
         g_warning("%s", opt->c_str());
     }
-    return this->image;
+    return surface;
+}
+
+void Image::retainImage() const {
+    if (!this->retained) {
+        ImageCache::instance().retain(this->cacheKey);
+        this->retained = true;
+    }
+}
+
+void Image::releaseImage() const {
+    if (this->retained) {
+        ImageCache::instance().release(this->cacheKey);
+        this->retained = false;
+    }
 }
 
 void Image::scale(double x0, double y0, double fx, double fy, double rotation,
@@ -216,6 +245,7 @@ void Image::scale(double x0, double y0, double fx, double fy, double rotation,
     this->width *= fx;
     this->height *= fy;
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::rotate(double x0, double y0, double th) {}
@@ -241,12 +271,10 @@ void Image::readSerialized(ObjectInputStream& in) {
     this->width = in.readDouble();
     this->height = in.readDouble();
 
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-
     this->data = in.readImage();
+    releaseImage();
+    this->cacheKey = ImageCache::computeKey(this->data);
+    this->imageSize = NOSIZE;
 
     in.endObject();
     this->calcSize();
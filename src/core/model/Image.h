@@ -20,7 +20,10 @@
 #include <cairo.h>                  // for cairo_surface_t, cairo_status_t
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for GdkPixbufFormat, GdkPixbuf
 
-#include "Element.h"  // for Element
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
+#include "Element.h"     // for Element
+#include "ImageCache.h"  // for ImageCache
 
 class ObjectInputStream;
 class ObjectOutputStream;
@@ -56,8 +59,13 @@ public:
     /// Returns std::nullopt on success, an error message on failure
     std::optional<std::string> renderBuffer() const;
 
-    /// Returns the internal surface that contains the rendered image data.
-    cairo_surface_t* getImage() const;
+    /// Returns the surface that contains the rendered image data. The surface is shared through the ImageCache, so
+    /// it may be released and rendered again later.
+    xoj::util::CairoSurfaceSPtr getImage() const;
+
+    /// Drops the rendered image data from the ImageCache, e.g. if the image will not be shown for a while. The data is
+    /// kept as long as another image with the same data still shows it.
+    void releaseImage() const;
 
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
@@ -87,9 +95,14 @@ public:
 private:
     void calcSize() const override;
 
+    std::optional<std::string> render(xoj::util::CairoSurfaceSPtr& surface) const;
+    void retainImage() const;
+
 private:
-    /// Temporary surface used as a render buffer.
-    mutable cairo_surface_t* image = nullptr;
+    /// Identifies the rendered image in the ImageCache
+    ImageCache::Key cacheKey;
+    /// Whether the image counts as a user of its surface in the ImageCache, until releaseImage() is called
+    mutable bool retained = false;
 
     /// Image format information.
     mutable GdkPixbufFormat* format = nullptr;
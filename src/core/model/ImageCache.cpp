@@ -0,0 +1,115 @@
+#include "ImageCache.h"
+
+#include <utility>  // for move
+
+#include <cairo.h>  // for cairo_image_surface_get_height, cairo_image_surface_get_stride
+#include <glib.h>   // for g_checksum_new, g_checksum_update, g_checksum_get_digest
+
+namespace {
+auto getSurfaceSize(cairo_surface_t* surface) -> size_t {
+    return static_cast<size_t>(cairo_image_surface_get_stride(surface)) *
+           static_cast<size_t>(cairo_image_surface_get_height(surface));
+}
+}  // namespace
+
+auto ImageCache::computeKey(std::string_view data) -> Key {
+    Key key;
+    key.length = data.size();
+
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(data.data()), static_cast<gssize>(data.size()));
+    gsize digestLength = key.digest.size();
+    g_checksum_get_digest(checksum, key.digest.data(), &digestLength);
+    g_checksum_free(checksum);
+    return key;
+}
+
+auto ImageCache::instance() -> ImageCache& {
+    static ImageCache cache;
+    return cache;
+}
+
+auto ImageCache::lookup(const Key& key) -> xoj::util::CairoSurfaceSPtr {
+    std::lock_guard lock(this->mutex);
+    auto it = this->index.find(key);
+    if (it == this->index.end()) {
+        return nullptr;
+    }
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return it->second->second;
+}
+
+void ImageCache::cache(const Key& key, xoj::util::CairoSurfaceSPtr surface) {
+    std::lock_guard lock(this->mutex);
+    if (auto it = this->index.find(key); it != this->index.end()) {
+        // Decoded concurrently by another thread
+        this->entries.splice(this->entries.begin(), this->entries, it->second);
+        return;
+    }
+
+    size_t surfaceSize = getSurfaceSize(surface.get());
+    shrinkTo(this->maxSize > surfaceSize ? this->maxSize - surfaceSize : 0);
+
+    this->entries.emplace_front(key, std::move(surface));
+    this->index.emplace(key, this->entries.begin());
+    this->size += surfaceSize;
+}
+
+void ImageCache::retain(const Key& key) {
+    std::lock_guard lock(this->mutex);
+    this->users[key]++;
+}
+
+void ImageCache::release(const Key& key) {
+    std::lock_guard lock(this->mutex);
+    auto it = this->users.find(key);
+    if (it == this->users.end()) {
+        return;
+    }
+    if (--it->second == 0) {
+        // Another element with the same data would decode the image again right away
+        this->users.erase(it);
+        evict(key);
+    }
+}
+
+void ImageCache::evict(const Key& key) {
+    if (auto it = this->index.find(key); it != this->index.end()) {
+        this->size -= getSurfaceSize(it->second->second.get());
+        this->entries.erase(it->second);
+        this->index.erase(it);
+    }
+}
+
+void ImageCache::evictUnused() {
+    std::lock_guard lock(this->mutex);
+    for (auto it = this->entries.begin(); it != this->entries.end();) {
+        if (cairo_surface_get_reference_count(it->second.get()) == 1) {
+            this->size -= getSurfaceSize(it->second.get());
+            this->index.erase(it->first);
+            it = this->entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ImageCache::setMaxSize(size_t maxSize) {
+    std::lock_guard lock(this->mutex);
+    this->maxSize = maxSize;
+    shrinkTo(maxSize);
+}
+
+auto ImageCache::getSize() const -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->size;
+}
+
+void ImageCache::shrinkTo(size_t size) {
+    while (this->size > size && !this->entries.empty()) {
+        auto& [key, surface] = this->entries.back();
+        this->size -= getSurfaceSize(surface.get());
+        this->index.erase(key);
+        this->entries.pop_back();
+    }
+}
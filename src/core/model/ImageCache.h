@@ -0,0 +1,116 @@
+/*
+ * Xournal++
+ *
+ * Caches the decoded images
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <array>          // for array
+#include <cstddef>        // for size_t
+#include <cstring>        // for memcpy
+#include <list>           // for list
+#include <mutex>          // for mutex
+#include <string_view>    // for string_view
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
+/**
+ * Decoded images, shared by all the elements with the same encoded data.
+ *
+ * The decoded surfaces are kept as long as their total size fits in the budget, evicting the least recently used
+ * ones. The surfaces are reference counted, so evicting a surface which is being drawn is safe.
+ */
+class ImageCache {
+public:
+    /**
+     * Identifies the encoded data of an image by its SHA-256 digest, so that different images never share an entry
+     */
+    struct Key {
+        std::array<unsigned char, 32> digest{};
+        size_t length = 0;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    static Key computeKey(std::string_view data);
+
+    /**
+     * The cache shared by all the documents
+     */
+    static ImageCache& instance();
+
+public:
+    /**
+     * @return The decoded surface, or nullptr if it is not cached
+     */
+    xoj::util::CairoSurfaceSPtr lookup(const Key& key);
+
+    /**
+     * Adds a decoded surface. The new surface is kept even if it exceeds the budget on its own.
+     */
+    void cache(const Key& key, xoj::util::CairoSurfaceSPtr surface);
+
+    /**
+     * Records that one more element shows the surface decoded from `key`
+     */
+    void retain(const Key& key);
+
+    /**
+     * Records that an element does not show the surface decoded from `key` anymore. The surface is dropped once no
+     * element shows it.
+     */
+    void release(const Key& key);
+
+    /**
+     * Drops the surfaces which are not referenced outside of the cache
+     */
+    void evictUnused();
+
+    /**
+     * @param maxSize The budget in bytes
+     */
+    void setMaxSize(size_t maxSize);
+
+    /**
+     * @return The size of the cached surfaces in bytes
+     */
+    size_t getSize() const;
+
+private:
+    ImageCache() = default;
+
+    void shrinkTo(size_t size);
+    void evict(const Key& key);
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            // The digest is uniformly distributed already
+            size_t hash = 0;
+            std::memcpy(&hash, key.digest.data(), sizeof(hash));
+            return hash;
+        }
+    };
+
+    using Entry = std::pair<Key, xoj::util::CairoSurfaceSPtr>;
+
+    mutable std::mutex mutex;
+
+    /// Most recently used first
+    std::list<Entry> entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+    /// Number of elements showing each surface, see retain() and release()
+    std::unordered_map<Key, size_t, KeyHash> users;
+
+    size_t size = 0;
+    size_t maxSize = 256 * 1024 * 1024;
+};
@@ -1,7 +1,10 @@
 #include "Layer.h"
 
+#include <algorithm>  // for min, find_if, remove
 #include <cstddef>
+#include <iterator>  // for next, distance
 #include <memory>
+#include <mutex>  // for lock_guard
 #include <utility>
 #include <vector>
 
@@ -9,10 +12,14 @@
 
 #include "model/Element.h"  // for Element, Element::Index, Element::Inval...
 #include "model/ElementInsertionPosition.h"
-#include "util/Assert.h"      // for xoj_assert
+#include "model/SpatialIndex.h"  // for SpatialIndex
+#include "util/Assert.h"         // for xoj_assert
 #include "util/Stacktrace.h"  // for Stacktrace
 #include "util/safe_casts.h"
 
+/// Smaller layers are searched linearly
+constexpr size_t INDEX_MIN_ELEMENTS = 64;
+
 Layer::Layer() = default;
 
 Layer::~Layer() = default;
@@ -38,7 +45,9 @@ void Layer::addElement(ElementPtr e) {
         return;
     }
 
+    e->layer = this;
     this->elements.emplace_back(std::move(e));
+    indexElement(static_cast<Element::Index>(this->elements.size() - 1));
 }
 
 void Layer::insertElement(ElementPtr e, Element::Index pos) {
@@ -54,18 +63,30 @@ void Layer::insertElement(ElementPtr e, Element::Index pos) {
         pos = 0;
     }
 
+    e->layer = this;
+
     // If the element should be inserted at the top
     if (pos >= static_cast<int>(this->elements.size())) {
+        pos = static_cast<Element::Index>(this->elements.size());
         this->elements.push_back(std::move(e));
     } else {
         this->elements.insert(this->elements.begin() + pos, std::move(e));
+        invalidatePositions(as_unsigned(pos));
     }
+    indexElement(pos);
 }
 
 auto Layer::indexOf(const Element* e) const -> Element::Index {
-    for (unsigned int i = 0; i < this->elements.size(); i++) {
+    if (size_t pos = e->positionInLayer; pos < this->validPositions && this->elements[pos].get() == e) {
+        return static_cast<Element::Index>(pos);
+    }
+
+    // Every element before validPositions knows its position: e can only be further
+    for (size_t i = this->validPositions; i < this->elements.size(); i++) {
+        this->elements[i]->positionInLayer = i;
+        this->validPositions = i + 1;
         if (this->elements[i].get() == e) {
-            return i;
+            return static_cast<Element::Index>(i);
         }
     }
 
@@ -73,12 +94,13 @@ auto Layer::indexOf(const Element* e) const -> Element::Index {
 }
 
 auto Layer::removeElement(const Element* e) -> InsertionPosition {
-    for (unsigned int i = 0; i < this->elements.size(); i++) {
-        if (e == this->elements[i].get()) {
-            auto res = std::move(this->elements[i]);
-            this->elements.erase(this->elements.begin() + i);
-            return InsertionPosition{std::move(res), i};
-        }
+    if (auto pos = indexOf(e); pos != Element::InvalidIndex) {
+        auto iter = std::next(this->elements.begin(), pos);
+        auto res = std::move(*iter);
+        this->elements.erase(iter);
+        invalidatePositions(as_unsigned(pos));
+        unindexElement(res.get());
+        return InsertionPosition{std::move(res), pos};
     }
 
     g_warning("Could not remove element %p from layer %p, it's not on the layer!", e, this);
@@ -91,6 +113,8 @@ auto Layer::removeElementAt(const Element* e, Element::Index pos) -> InsertionPo
         auto iter = std::next(this->elements.begin(), pos);
         auto res = std::move(*iter);
         this->elements.erase(iter);
+        invalidatePositions(as_unsigned(pos));
+        unindexElement(res.get());
         return InsertionPosition{std::move(res), pos};
     }
     return removeElement(e);
@@ -100,24 +124,41 @@ auto Layer::removeElementsAt(InsertionOrderRef const& elts) -> InsertionOrder {
     InsertionOrder res;
     res.reserve(elts.size());
     auto endIndex = static_cast<Element::Index>(elements.size());
+    size_t firstRemoved = elements.size();
     for (auto&& [e, p]: elts) {
         xoj_assert(e);
         auto pos = p;
         if (pos < 0 || pos > endIndex || elements[static_cast<size_t>(pos)].get() != e) {
-            pos = indexOf(e);
-            if (pos == Element::InvalidIndex) {
+            // Not indexOf(): the removed elements leave holes in the vector until the end of the loop
+            auto it = std::find_if(elements.begin(), elements.end(),
+                                   [e = e](const ElementPtr& elt) { return elt.get() == e; });
+            if (it == elements.end()) {
                 g_warning("Could not remove element from layer, it's not on the layer!");
                 Stacktrace::printStacktrace();
                 continue;
             }
+            pos = std::distance(elements.begin(), it);
         }
+        unindexElement(elements[static_cast<size_t>(pos)].get());
         res.emplace_back(std::move(elements[static_cast<size_t>(pos)]), pos);
+        firstRemoved = std::min(firstRemoved, static_cast<size_t>(pos));
     }
     this->elements.erase(std::remove(this->elements.begin(), this->elements.end(), nullptr), this->elements.end());
+    invalidatePositions(firstRemoved);
     return res;
 }
 
-auto Layer::clearNoFree() -> std::vector<ElementPtr> { return std::move(this->elements); }
+auto Layer::clearNoFree() -> std::vector<ElementPtr> {
+    for (auto& e: this->elements) {
+        e->layer = nullptr;
+    }
+    this->validPositions = 0;
+    {
+        std::lock_guard lock(this->indexMutex);
+        this->index.reset();
+    }
+    return std::move(this->elements);
+}
 
 auto Layer::isAnnotated() const -> bool { return !this->elements.empty(); }
 
@@ -131,12 +172,62 @@ auto Layer::isVisible() const -> bool { return visible; }
  */
 void Layer::setVisible(bool visible) { this->visible = visible; }
 
-auto Layer::getElements() -> std::vector<ElementPtr>& { return this->elements; }
+auto Layer::getElements() const -> const std::vector<ElementPtr>& { return this->elements; }
 
 auto Layer::getElementsView() const -> xoj::util::PointerContainerView<std::vector<ElementPtr>> {
     return this->elements;
 }
 
+auto Layer::getElementsInArea(const xoj::util::Rectangle<double>& area) const -> std::vector<Element*> {
+    std::lock_guard lock(this->indexMutex);
+    if (!this->index) {
+        if (this->elements.size() < INDEX_MIN_ELEMENTS) {
+            std::vector<Element*> res;
+            for (auto const& e: this->elements) {
+                auto bounds = e->boundingRect();
+                if (bounds.x <= area.x + area.width && area.x <= bounds.x + bounds.width &&
+                    bounds.y <= area.y + area.height && area.y <= bounds.y + bounds.height) {
+                    res.push_back(e.get());
+                }
+            }
+            return res;
+        }
+        this->index = std::make_unique<SpatialIndex>();
+        this->index->build(this->elements.begin(), this->elements.end());
+    }
+    return this->index->query(area);
+}
+
+void Layer::elementBoundsChanged(const Element* e) {
+    std::lock_guard lock(this->indexMutex);
+    if (this->index) {
+        this->index->update(e);
+    }
+}
+
+void Layer::indexElement(Element::Index pos) {
+    std::lock_guard lock(this->indexMutex);
+    if (!this->index) {
+        return;
+    }
+    auto i = as_unsigned(pos);
+    const Element* prev = i > 0 ? this->elements[i - 1].get() : nullptr;
+    const Element* next = i + 1 < this->elements.size() ? this->elements[i + 1].get() : nullptr;
+    if (!this->index->add(this->elements[i].get(), prev, next)) {
+        this->index->build(this->elements.begin(), this->elements.end());
+    }
+}
+
+void Layer::invalidatePositions(size_t pos) { this->validPositions = std::min(this->validPositions, pos); }
+
+void Layer::unindexElement(Element* e) {
+    e->layer = nullptr;
+    std::lock_guard lock(this->indexMutex);
+    if (this->index) {
+        this->index->remove(e);
+    }
+}
+
 
 auto Layer::hasName() const -> bool { return name.has_value(); }
 
@@ -13,15 +13,19 @@
 
 #include <cstddef>   // for size_t
 #include <memory>    // for unique_ptr
+#include <mutex>     // for mutex
 #include <optional>  // for optional
 #include <string>    // for string
 #include <vector>    // for vector
 
 #include "util/PointerContainerView.h"
+#include "util/Rectangle.h"  // for Rectangle
 
 #include "Element.h"                   // for Element, Element::Index
 #include "ElementInsertionPosition.h"  // for InsertionOrder
 
+class SpatialIndex;
+
 template <class T>
 using optional = std::optional<T>;
 
@@ -49,6 +53,8 @@ public:
 
     /**
      * Returns the index of the given Element with respect to the internal list
+     * Constant time, except for the first lookup after an insertion or a removal, which renumbers the elements between
+     * the modified position and the element.
      */
     auto indexOf(const Element* e) const -> Element::Index;
 
@@ -78,10 +84,16 @@ public:
     /**
      * Returns an iteratable over the Element%s contained in this Layer
      */
-    auto getElements() -> std::vector<ElementPtr>&;
+    auto getElements() const -> const std::vector<ElementPtr>&;
 
     auto getElementsView() const -> xoj::util::PointerContainerView<std::vector<ElementPtr>>;
 
+    /**
+     * Returns the Element%s whose bounding box overlaps the area, in the order of the Layer.
+     * Uses a spatial index on layers with many elements.
+     */
+    auto getElementsInArea(const xoj::util::Rectangle<double>& area) const -> std::vector<Element*>;
+
     /**
      * Returns whether or not the Layer is empty
      */
@@ -117,10 +129,37 @@ public:
      */
     void setName(const std::string& newName);
 
+private:
+    /**
+     * Called by the element
+     */
+    void elementBoundsChanged(const Element* e);
+
+    void indexElement(Element::Index pos);
+    void unindexElement(Element* e);
+
+    /**
+     * Marks the positions of the elements from pos onwards as outdated
+     */
+    void invalidatePositions(size_t pos);
+
 private:
     std::vector<ElementPtr> elements;
 
+    /**
+     * The elements before this position know their position in the layer (see Element::positionInLayer)
+     */
+    mutable size_t validPositions = 0;
+
+    /**
+     * Built on the first query of a layer with many elements, then kept up to date
+     */
+    mutable std::unique_ptr<SpatialIndex> index;
+    mutable std::mutex indexMutex;
+
     bool visible = true;
 
     std::optional<std::string> name;
+
+    friend class Element;
 };
@@ -0,0 +1,111 @@
+/*
+ * Xournal++
+ *
+ * Read-only view of a sequence of points
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>   // for size_t, ptrdiff_t
+#include <iterator>  // for random_access_iterator_tag
+#include <span>      // for span
+#include <vector>    // for vector
+
+#include "Point.h"  // for Point
+
+/**
+ * @brief Read-only view of the points of a stroke, or of a path being drawn.
+ *
+ * The points are returned by value, and the view gives no access to the underlying memory. It wraps the contiguous
+ * Point objects the strokes store; only Stroke and its kernels (StrokeKernels, StrokeSegmentTree) access them
+ * directly. Like std::span, the view does not own the points.
+ */
+class PointView {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Point;
+        using difference_type = std::ptrdiff_t;
+        using reference = Point;
+
+        /// Gives it->x for iterators returning their points by value
+        class Arrow {
+        public:
+            explicit Arrow(const Point& p): p(p) {}
+            const Point* operator->() const { return &p; }
+
+        private:
+            Point p;
+        };
+        using pointer = Arrow;
+
+        Iterator() = default;
+        explicit Iterator(std::span<const Point>::iterator it): it(it) {}
+
+        Point operator*() const { return *it; }
+        Arrow operator->() const { return Arrow(*it); }
+        Point operator[](difference_type n) const { return it[n]; }
+
+        Iterator& operator++() {
+            ++it;
+            return *this;
+        }
+        Iterator operator++(int) {
+            auto tmp = *this;
+            ++it;
+            return tmp;
+        }
+        Iterator& operator--() {
+            --it;
+            return *this;
+        }
+        Iterator operator--(int) {
+            auto tmp = *this;
+            --it;
+            return tmp;
+        }
+        Iterator& operator+=(difference_type n) {
+            it += n;
+            return *this;
+        }
+        Iterator& operator-=(difference_type n) {
+            it -= n;
+            return *this;
+        }
+
+        Iterator operator+(difference_type n) const { return Iterator(it + n); }
+        Iterator operator-(difference_type n) const { return Iterator(it - n); }
+        difference_type operator-(const Iterator& other) const { return it - other.it; }
+        friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+
+        bool operator==(const Iterator& other) const { return it == other.it; }
+        auto operator<=>(const Iterator& other) const { return it <=> other.it; }
+
+    private:
+        std::span<const Point>::iterator it{};
+    };
+
+public:
+    PointView() = default;
+    PointView(std::span<const Point> points): points(points) {}
+    PointView(const std::vector<Point>& points): points(points) {}
+
+    size_t size() const { return points.size(); }
+    bool empty() const { return points.empty(); }
+
+    Point operator[](size_t index) const { return points[index]; }
+    Point front() const { return points.front(); }
+    Point back() const { return points.back(); }
+
+    Iterator begin() const { return Iterator(points.begin()); }
+    Iterator end() const { return Iterator(points.end()); }
+
+private:
+    std::span<const Point> points;
+};
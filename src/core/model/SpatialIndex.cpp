@@ -0,0 +1,211 @@
+#include "SpatialIndex.h"
+
+#include <algorithm>  // for sort, find, clamp
+#include <cmath>      // for floor, isfinite
+#include <cstdint>    // for int64_t
+#include <utility>    // for pair
+
+#include "model/Element.h"  // for Element
+
+namespace {
+/// Size of the cells of the grid, in page coordinates
+constexpr double CELL_SIZE = 64.0;
+/// Elements covering more cells are not put in the grid
+constexpr int64_t MAX_CELLS_PER_ELEMENT = 64;
+constexpr double MAX_CELL_COORDINATE = 1 << 30;
+
+auto toCell(double coordinate) -> int32_t {
+    return static_cast<int32_t>(
+            std::clamp(std::floor(coordinate / CELL_SIZE), -MAX_CELL_COORDINATE, MAX_CELL_COORDINATE));
+}
+
+template <class T>
+void eraseUnordered(std::vector<T>& v, const T& value) {
+    if (auto it = std::find(v.begin(), v.end(), value); it != v.end()) {
+        *it = v.back();
+        v.pop_back();
+    }
+}
+
+auto overlaps(const xoj::util::Rectangle<double>& a, const xoj::util::Rectangle<double>& b) -> bool {
+    return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+}  // namespace
+
+SpatialIndex::SpatialIndex() = default;
+
+SpatialIndex::~SpatialIndex() = default;
+
+auto SpatialIndex::add(Element* e, const Element* prev, const Element* next) -> bool {
+    uint64_t prevOrder = 0;
+    if (prev) {
+        auto it = this->entries.find(prev);
+        if (it == this->entries.end()) {
+            return false;
+        }
+        prevOrder = it->second.order;
+    }
+
+    if (!next) {
+        insertEntry(e, prevOrder + ORDER_GAP);
+        return true;
+    }
+
+    auto it = this->entries.find(next);
+    if (it == this->entries.end() || it->second.order <= prevOrder + 1) {
+        return false;
+    }
+    insertEntry(e, prevOrder + (it->second.order - prevOrder) / 2);
+    return true;
+}
+
+void SpatialIndex::remove(const Element* e) {
+    auto it = this->entries.find(e);
+    if (it == this->entries.end()) {
+        return;
+    }
+    unindexBounds(it->second);
+    this->entries.erase(it);
+}
+
+void SpatialIndex::update(const Element* e) {
+    auto it = this->entries.find(e);
+    if (it != this->entries.end() && !it->second.dirty) {
+        it->second.dirty = true;
+        this->dirtyElements.push_back(e);
+    }
+}
+
+void SpatialIndex::clear() {
+    this->entries.clear();
+    this->cells.clear();
+    this->largeElements.clear();
+    this->dirtyElements.clear();
+}
+
+auto SpatialIndex::size() const -> size_t { return this->entries.size(); }
+
+auto SpatialIndex::query(const xoj::util::Rectangle<double>& area) -> std::vector<Element*> {
+    flushDirty();
+    this->queryId++;
+
+    std::vector<std::pair<uint64_t, Element*>> found;
+    auto addCandidate = [&](Element* e) {
+        Entry& entry = this->entries[e];
+        if (entry.queryId != this->queryId) {
+            entry.queryId = this->queryId;
+            if (overlaps(e->boundingRect(), area)) {
+                found.emplace_back(entry.order, e);
+            }
+        }
+    };
+
+    const int32_t minX = toCell(area.x);
+    const int32_t minY = toCell(area.y);
+    const int32_t maxX = toCell(area.x + area.width);
+    const int32_t maxY = toCell(area.y + area.height);
+    const auto areaCells = (int64_t{maxX} - minX + 1) * (int64_t{maxY} - minY + 1);
+
+    if (areaCells > static_cast<int64_t>(this->cells.size())) {
+        // Cheaper to look at all the occupied cells
+        for (auto& [key, elements]: this->cells) {
+            const auto x = static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+            const auto y = static_cast<int32_t>(static_cast<uint32_t>(key));
+            if (minX <= x && x <= maxX && minY <= y && y <= maxY) {
+                for (Element* e: elements) { addCandidate(e); }
+            }
+        }
+    } else {
+        for (int32_t x = minX; x <= maxX; x++) {
+            for (int32_t y = minY; y <= maxY; y++) {
+                if (auto it = this->cells.find(cellKey(x, y)); it != this->cells.end()) {
+                    for (Element* e: it->second) { addCandidate(e); }
+                }
+            }
+        }
+    }
+    for (Element* e: this->largeElements) { addCandidate(e); }
+
+    std::sort(found.begin(), found.end());
+
+    std::vector<Element*> result;
+    result.reserve(found.size());
+    for (auto& [order, e]: found) { result.push_back(e); }
+    return result;
+}
+
+void SpatialIndex::insertEntry(Element* e, uint64_t order) {
+    Entry& entry = this->entries[e];
+    unindexBounds(entry);
+    entry.element = e;
+    entry.order = order;
+    entry.dirty = true;
+    this->dirtyElements.push_back(e);
+}
+
+void SpatialIndex::indexBounds(Entry& entry) {
+    auto bounds = entry.element->boundingRect();
+    if (!std::isfinite(bounds.x) || !std::isfinite(bounds.y) || !std::isfinite(bounds.width) ||
+        !std::isfinite(bounds.height)) {
+        entry.large = true;
+    } else {
+        entry.minX = toCell(bounds.x);
+        entry.minY = toCell(bounds.y);
+        entry.maxX = toCell(bounds.x + bounds.width);
+        entry.maxY = toCell(bounds.y + bounds.height);
+        entry.large = (int64_t{entry.maxX} - entry.minX + 1) * (int64_t{entry.maxY} - entry.minY + 1) >
+                      MAX_CELLS_PER_ELEMENT;
+    }
+
+    if (entry.large) {
+        this->largeElements.push_back(entry.element);
+    } else {
+        for (int32_t x = entry.minX; x <= entry.maxX; x++) {
+            for (int32_t y = entry.minY; y <= entry.maxY; y++) {
+                this->cells[cellKey(x, y)].push_back(entry.element);
+            }
+        }
+    }
+    entry.indexed = true;
+}
+
+void SpatialIndex::unindexBounds(Entry& entry) {
+    if (!entry.indexed) {
+        return;
+    }
+    if (entry.large) {
+        eraseUnordered(this->largeElements, entry.element);
+    } else {
+        for (int32_t x = entry.minX; x <= entry.maxX; x++) {
+            for (int32_t y = entry.minY; y <= entry.maxY; y++) {
+                auto it = this->cells.find(cellKey(x, y));
+                if (it == this->cells.end()) {
+                    continue;
+                }
+                eraseUnordered(it->second, entry.element);
+                if (it->second.empty()) {
+                    this->cells.erase(it);
+                }
+            }
+        }
+    }
+    entry.indexed = false;
+}
+
+void SpatialIndex::flushDirty() {
+    for (const Element* e: this->dirtyElements) {
+        auto it = this->entries.find(e);
+        if (it == this->entries.end() || !it->second.dirty) {
+            // Removed meanwhile, or listed twice
+            continue;
+        }
+        unindexBounds(it->second);
+        indexBounds(it->second);
+        it->second.dirty = false;
+    }
+    this->dirtyElements.clear();
+}
+
+auto SpatialIndex::cellKey(int32_t x, int32_t y) -> uint64_t {
+    return (uint64_t{static_cast<uint32_t>(x)} << 32) | static_cast<uint32_t>(y);
+}
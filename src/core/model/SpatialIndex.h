@@ -0,0 +1,107 @@
+/*
+ * Xournal++
+ *
+ * Spatial index of the elements of a layer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t, int32_t
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include "util/Rectangle.h"  // for Rectangle
+
+class Element;
+
+/**
+ * Uniform grid over the bounding boxes of the elements of a layer, to find the elements overlapping an area without
+ * testing all of them.
+ *
+ * Each element also gets an order key, increasing along the layer, so the results of a query can be returned in the
+ * drawing order. The bounds of the elements are read lazily: changed elements are only marked, and indexed again at
+ * the next query.
+ */
+class SpatialIndex {
+public:
+    SpatialIndex();
+    ~SpatialIndex();
+
+public:
+    /**
+     * Indexes the element inserted between `prev` and `next` in the layer (either may be nullptr)
+     *
+     * @return false if there is no order key left between `prev` and `next`: the index must be built again
+     */
+    bool add(Element* e, const Element* prev, const Element* next);
+
+    void remove(const Element* e);
+
+    /**
+     * The bounds of the element changed
+     */
+    void update(const Element* e);
+
+    void clear();
+
+    /**
+     * Indexes all the elements, in layer order
+     */
+    template <class It>
+    void build(It begin, It end) {
+        clear();
+        uint64_t order = 0;
+        for (; begin != end; ++begin) {
+            order += ORDER_GAP;
+            insertEntry(&**begin, order);
+        }
+    }
+
+    /**
+     * @return The elements whose bounding box overlaps `area` (borders included), in layer order
+     */
+    std::vector<Element*> query(const xoj::util::Rectangle<double>& area);
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        Element* element = nullptr;
+        uint64_t order = 0;
+        /// Cells covered by the element when it was indexed
+        int32_t minX = 0;
+        int32_t minY = 0;
+        int32_t maxX = -1;
+        int32_t maxY = -1;
+        /// The element covers too many cells and is kept in `largeElements` instead
+        bool large = false;
+        bool indexed = false;
+        bool dirty = true;
+        /// Id of the last query which returned the element
+        uint32_t queryId = 0;
+    };
+
+    void insertEntry(Element* e, uint64_t order);
+
+    void indexBounds(Entry& entry);
+    void unindexBounds(Entry& entry);
+    void flushDirty();
+
+    static uint64_t cellKey(int32_t x, int32_t y);
+
+private:
+    static constexpr uint64_t ORDER_GAP = uint64_t{1} << 20;
+
+    std::unordered_map<const Element*, Entry> entries;
+    std::unordered_map<uint64_t, std::vector<Element*>> cells;
+    std::vector<Element*> largeElements;
+    std::vector<const Element*> dirtyElements;
+
+    uint32_t queryId = 0;
+};
@@ -4,7 +4,6 @@
 #include <cmath>      // for abs, hypot, sqrt
 #include <cstdint>    // for uint64_t
 #include <iterator>   // for back_insert_iterator
-#include <limits>     // for numeric_limits
 #include <memory>
 #include <numeric>    // for accumulate
 #include <optional>   // for optional, nullopt
@@ -24,7 +23,6 @@
 #include "util/PairView.h"                        // for PairView<>::BaseIte...
 #include "util/PairView.h"                        // for PairView
 #include "util/PlaceholderString.h"               // for PlaceholderString
-#include "util/Point.h"                           // for xoj::util::Point<>
 #include "util/Rectangle.h"                       // for Rectangle
 #include "util/SmallVector.h"                     // for SmallVector
 #include "util/TinyVector.h"                      // for TinyVector
@@ -33,8 +31,11 @@
 #include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
 #include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
 
-#include "PathParameter.h"  // for PathParameter
-#include "config-debug.h"   // for ENABLE_ERASER_DEBUG
+#include "PathParameter.h"       // for PathParameter
+#include "StrokeContourCache.h"  // for StrokeContourCache
+#include "StrokeKernels.h"       // for computeBounds, distanceTo...
+#include "StrokeSegmentTree.h"   // for StrokeSegmentTree
+#include "config-debug.h"        // for ENABLE_ERASER_DEBUG
 
 using xoj::util::Rectangle;
 
@@ -82,7 +83,10 @@ constexpr void updateSnappedBounds(Rectangle<Float>& snap, Point const& p) {
 
 Stroke::Stroke(): AudioElement(ELEMENT_STROKE) {}
 
-Stroke::~Stroke() = default;
+Stroke::~Stroke() {
+    // Give the memory of the contour back
+    xoj::view::StrokeContourCache::instance().invalidate(*this);
+}
 
 /**
  * Clone style attributes, but not the data (position, pressure etc.)
@@ -201,6 +205,7 @@ void Stroke::readSerialized(ObjectInputStream& in) {
 
     in.readData(this->points);
     this->lineStyle.readSerialized(in);
+    invalidateCaches();
 
     in.endObject();
 }
@@ -226,6 +231,7 @@ void Stroke::setFill(int fill) { this->fill = fill; }
 void Stroke::setWidth(double width) {
     this->width = width;
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Stroke::getWidth() const -> double { return this->width; }
@@ -247,6 +253,8 @@ auto Stroke::isInSelection(ShapeContainer* container) const -> bool {
 
 void Stroke::addPoint(const Point& p) {
     this->points.emplace_back(p);
+    boundsChanged();
+    invalidateCaches();
     if (!sizeCalculated) {
         return;
     }
@@ -266,6 +274,8 @@ auto Stroke::getPointVector() const -> std::vector<Point> const& { return points
 void Stroke::deletePointsFrom(size_t index) {
     points.resize(std::min(index, points.size()));
     this->sizeCalculated = false;
+    boundsChanged();
+    invalidateCaches();
 }
 
 auto Stroke::getPoint(size_t index) const -> Point {
@@ -285,7 +295,7 @@ Point Stroke::getPoint(PathParameter parameter) const {
     return res;
 }
 
-auto Stroke::getPoints() const -> const Point* { return this->points.data(); }
+auto Stroke::getPoints() const -> PointView { return this->points; }
 
 void Stroke::setPointVectorInternal(const Range* const snappingBox) {
     if (!snappingBox || this->points.empty() || this->points.front().z != Point::NO_PRESSURE) {
@@ -300,6 +310,8 @@ void Stroke::setPointVectorInternal(const Range* const snappingBox) {
         Element::height = snappingBox->getHeight() + this->width;
         this->sizeCalculated = true;
     }
+    boundsChanged();
+    invalidateCaches();
 }
 
 void Stroke::setPointVector(const std::vector<Point>& other, const Range* const snappingBox) {
@@ -313,13 +325,16 @@ void Stroke::setPointVector(std::vector<Point>&& other, const Range* const snapp
 }
 
 
-void Stroke::freeUnusedPointItems() { this->points = {begin(this->points), end(this->points)}; }
+void Stroke::freeUnusedPointItems() { this->points.shrink_to_fit(); }
 
 void Stroke::setToolType(StrokeTool type) { this->toolType = type; }
 
 auto Stroke::getToolType() const -> StrokeTool { return this->toolType; }
 
-void Stroke::setLineStyle(const LineStyle& style) { this->lineStyle = style; }
+void Stroke::setLineStyle(const LineStyle& style) {
+    this->lineStyle = style;
+    invalidateCaches();
+}
 
 auto Stroke::getLineStyle() const -> const LineStyle& { return this->lineStyle; }
 
@@ -331,6 +346,8 @@ void Stroke::move(double dx, double dy) {
     Element::x += dx;
     Element::y += dy;
     Element::snappedBounds = Element::snappedBounds.translated(dx, dy);
+    boundsChanged();
+    invalidateCaches();
 }
 
 void Stroke::rotate(double x0, double y0, double th) {
@@ -344,6 +361,8 @@ void Stroke::rotate(double x0, double y0, double th) {
         cairo_matrix_transform_point(&rotMatrix, &p.x, &p.y);
     }
     this->sizeCalculated = false;
+    boundsChanged();
+    invalidateCaches();
     // Width and Height will likely be changed after this operation
 }
 
@@ -367,6 +386,8 @@ void Stroke::scale(double x0, double y0, double fx, double fy, double rotation,
     this->width *= fz;
 
     this->sizeCalculated = false;
+    boundsChanged();
+    invalidateCaches();
 }
 
 auto Stroke::hasPressure() const -> bool {
@@ -407,6 +428,8 @@ void Stroke::scalePressure(double factor) {
         p.z *= factor;
     }
     this->sizeCalculated = false;
+    boundsChanged();
+    invalidateCaches();
 }
 
 void Stroke::setLastPressure(double pressure) {
@@ -414,6 +437,7 @@ void Stroke::setLastPressure(double pressure) {
         xoj_assert(pressure != Point::NO_PRESSURE);
         Point& back = this->points.back();
         back.z = pressure;
+        invalidateCaches();
     }
 }
 
@@ -422,6 +446,7 @@ void Stroke::setSecondToLastPressure(double pressure) {
     if (pointCount >= 2) {
         Point& p = this->points[pointCount - 2];
         p.z = pressure;
+        invalidateCaches();
         updateBoundsLastTwoPressures();
     }
 }
@@ -437,6 +462,7 @@ void Stroke::setPressure(const std::vector<double>& pressure) {
     for (size_t i = 0U; i != max_size; ++i) {
         this->points[i].z = pressure[i];
     }
+    invalidateCaches();
 }
 
 /**
@@ -447,10 +473,10 @@ auto Stroke::intersects(double x, double y, double halfEraserSize) const -> bool
         return false;
     }
 
-    double x1 = x - halfEraserSize;
-    double x2 = x + halfEraserSize;
-    double y1 = y - halfEraserSize;
-    double y2 = y + halfEraserSize;
+    const Rectangle<double> eraserBox(x - halfEraserSize, y - halfEraserSize, 2 * halfEraserSize, 2 * halfEraserSize);
+    if (StrokeKernels::anyPointInside(this->points, eraserBox)) {
+        return true;
+    }
 
     double lastX = points[0].x;
     double lastY = points[0].y;
@@ -458,10 +484,6 @@ auto Stroke::intersects(double x, double y, double halfEraserSize) const -> bool
         double px = point.x;
         double py = point.y;
 
-        if (px >= x1 && py >= y1 && px <= x2 && py <= y2) {
-            return true;
-        }
-
         double len = hypot(px - lastX, py - lastY);
         if (len >= halfEraserSize) {
             /**
@@ -500,16 +522,10 @@ auto Stroke::intersects(double x, double y, double halfEraserSize) const -> bool
 }
 
 double Stroke::distanceTo(double x, double y) const {
-    double distance = std::numeric_limits<double>::max();
-    for (auto&& [p1, p2]: PairView(this->points)) {
-        xoj::util::Point<double> v(p2.x - p1.x, p2.y - p1.y);
-        double ratio = std::clamp(((x - p1.x) * v.x + (y - p1.y) * v.y) / (v.x * v.x + v.y * v.y), 0., 1.);
-        /// Projection of (x,y) onto the segment [p1,p2]
-        xoj::util::Point<double> projection(p1.x + ratio * v.x, p1.y + ratio * v.y);
-        double width = p1.z == Point::NO_PRESSURE ? this->width : p1.z;
-        distance = std::clamp(std::hypot(x - projection.x, y - projection.y) - .5 * width, 0., distance);
+    if (const auto* tree = getSegmentTree()) {
+        return tree->distanceTo(this->points, x, y, this->width);
     }
-    return distance;
+    return StrokeKernels::distanceTo(this->points, x, y, this->width);
 }
 
 /**
@@ -719,9 +735,23 @@ auto Stroke::intersectWithPaddedBox(const PaddedBox& box, size_t firstIndex, siz
         DEBUG_ERASER(debugstream << "|  |__** result.size() = " << std::setw(3) << result.size() << std::endl;)
     };
 
-    auto endSegmentIt = std::next(segments.begin(), (std::ptrdiff_t)(lastIndex + 1));
-    for (; segmentIt != endSegmentIt; segmentIt++, index++) {
+    // The segments whose bounding box misses the padded box cannot cross it, and are skipped. The margin keeps those
+    // ending on the boundary of the box, up to rounding errors.
+    constexpr double MARGIN = 1e-6;
+    const Rectangle<double> searchBox(outerBox.x - MARGIN, outerBox.y - MARGIN, outerBox.width + 2 * MARGIN,
+                                      outerBox.height + 2 * MARGIN);
+    const StrokeSegmentTree* tree = getSegmentTree();
+    while (index <= lastIndex) {
+        size_t next = tree ? tree->findSegmentTouchingRectangle(this->points, index, lastIndex, searchBox) :
+                             StrokeKernels::findSegmentTouchingRectangle(this->points, index, lastIndex, searchBox);
+        segmentIt += (std::ptrdiff_t)(next - index);
+        index = next;
+        if (index > lastIndex) {
+            break;
+        }
         processSegment(segmentIt.first(), segmentIt.second(), index);
+        segmentIt++;
+        index++;
     }
 
     auto isHalfTangentAtLastKnotGoingTowardInnerBox =
@@ -824,36 +854,43 @@ void Stroke::calcSize() const {
 
         // used for snapping
         Element::snappedBounds = Rectangle<double>{};
+        return;
     }
 
-    double minSnapX = std::numeric_limits<double>::max();
-    double maxSnapX = std::numeric_limits<double>::min();
-    double minSnapY = std::numeric_limits<double>::max();
-    double maxSnapY = std::numeric_limits<double>::min();
-
-    auto halfThick = 0.0;
+    auto bounds = StrokeKernels::computeBounds(this->points);
 
-    // #pragma omp parralel
-    for (auto&& p: points) {
-        halfThick = std::max(halfThick, p.z);
-        minSnapX = std::min(minSnapX, p.x);
-        minSnapY = std::min(minSnapY, p.y);
-        maxSnapX = std::max(maxSnapX, p.x);
-        maxSnapY = std::max(maxSnapY, p.y);
-    }
+    auto halfThick = hasPressure() ? std::max(bounds.maxPressure, 0.0) / 2.0 : this->width / 2.0;
 
-    halfThick = points[0].z != Point::NO_PRESSURE ? halfThick / 2.0 : this->width / 2.0;
-
-    auto minX = minSnapX - halfThick;
-    auto minY = minSnapY - halfThick;
-    auto maxX = maxSnapX + halfThick;
-    auto maxY = maxSnapY + halfThick;
+    auto minX = bounds.minX - halfThick;
+    auto minY = bounds.minY - halfThick;
+    auto maxX = bounds.maxX + halfThick;
+    auto maxY = bounds.maxY + halfThick;
 
     Element::x = minX;
     Element::y = minY;
     Element::width = maxX - minX;
     Element::height = maxY - minY;
-    Element::snappedBounds = Rectangle<double>(minSnapX, minSnapY, maxSnapX - minSnapX, maxSnapY - minSnapY);
+    Element::snappedBounds =
+            Rectangle<double>(bounds.minX, bounds.minY, bounds.maxX - bounds.minX, bounds.maxY - bounds.minY);
+}
+
+void Stroke::invalidateCaches() {
+    xoj::view::StrokeContourCache::instance().invalidate(*this);
+    this->segmentTree.reset();
+}
+
+auto Stroke::getIndexedBounds(size_t first, size_t last) const -> std::optional<StrokeKernels::Bounds> {
+    if (const auto* tree = getSegmentTree()) {
+        return tree->getBounds(this->points, first, last);
+    }
+    return std::nullopt;
+}
+
+auto Stroke::getSegmentTree() const -> const StrokeSegmentTree* {
+    if (!this->segmentTree && this->points.size() >= StrokeSegmentTree::MIN_POINT_COUNT) {
+        this->segmentTree = std::make_shared<const StrokeSegmentTree>(this->points);
+    }
+    return this->segmentTree.get();
 }
 
 auto Stroke::getErasable() const -> ErasableStroke* { return this->erasable; }
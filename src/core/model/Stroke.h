@@ -11,20 +11,29 @@
 
 #pragma once
 
-#include <cstddef>  // for size_t
-#include <memory>   // for unique_ptr
-#include <vector>   // for vector
+#include <cstddef>   // for size_t
+#include <memory>    // for unique_ptr, shared_ptr, weak_ptr
+#include <optional>  // for optional
+#include <vector>    // for vector
 
 #include "model/Element.h"
 
-#include "AudioElement.h"  // for AudioElement
-#include "LineStyle.h"     // for LineStyle
-#include "Point.h"         // for Point
+#include "AudioElement.h"   // for AudioElement
+#include "LineStyle.h"      // for LineStyle
+#include "Point.h"          // for Point
+#include "PointView.h"      // for PointView
+#include "StrokeKernels.h"  // for Bounds
 
 class Element;
 class ObjectInputStream;
 class ObjectOutputStream;
 class ShapeContainer;
+class StrokeSegmentTree;
+
+namespace xoj::view {
+class CachedStrokeContour;
+class StrokeContourCache;
+};  // namespace xoj::view
 
 class StrokeTool {
 public:
@@ -112,10 +121,26 @@ public:
     void addPoint(const Point& p);
     size_t getPointCount() const;
     void freeUnusedPointItems();
+
+    /**
+     * @brief The points of the stroke, as a read-only view returning them by value.
+     * Prefer this over getPointVector(), which ties the caller to the underlying container.
+     */
+    PointView getPoints() const;
+
+    /**
+     * @brief The underlying vector of points. Only meant for callers which need a copy of the vector.
+     */
     std::vector<Point> const& getPointVector() const;
+
+    /**
+     * @brief The bounds of the points first, ..., last and their largest pressure value, found with the hierarchy of
+     * the segments of long strokes. Assumes first <= last < getPointCount()
+     * @return std::nullopt if the stroke is short enough to be searched linearly
+     */
+    std::optional<StrokeKernels::Bounds> getIndexedBounds(size_t first, size_t last) const;
     Point getPoint(size_t index) const;
     Point getPoint(PathParameter parameter) const;
-    const Point* getPoints() const;
 
     /**
      * @brief Replace the stroke's points by the ones in the provided vector (they will be copied).
@@ -200,6 +225,20 @@ public:
 protected:
     void calcSize() const override;
 
+private:
+    /**
+     * Drops the cached contour and segment tree, after a change of the points or of the line style
+     */
+    void invalidateCaches();
+
+    /**
+     * @brief Hierarchy of the bounding boxes of the segments, built on first use.
+     * @return nullptr if the stroke is short enough to be searched linearly
+     */
+    const StrokeSegmentTree* getSegmentTree() const;
+
+    friend class xoj::view::StrokeContourCache;
+
 private:
     // The stroke width cannot be inherited from Element
     double width = 0;
@@ -225,4 +264,15 @@ private:
     int fill = -1;
 
     StrokeCapStyle capStyle = StrokeCapStyle::ROUND;
+
+    /**
+     * Contour of the stroke with pressure, built when the stroke is first painted and owned by StrokeContourCache
+     */
+    mutable std::weak_ptr<const xoj::view::CachedStrokeContour> contour;
+
+    /**
+     * Segment boxes of long strokes, built by the first eraser or selection query (see getSegmentTree()).
+     * Shared between copies of the stroke until their points change.
+     */
+    mutable std::shared_ptr<const StrokeSegmentTree> segmentTree;
 };
@@ -41,7 +41,7 @@ struct ReturnOp {
     void operator()(cairo_t* cr) { op(cr, x, y, r, a, b); }
 };
 
-xoj::view::StrokeContour::StrokeContour(const std::vector<Point>& path): path(path) {}
+xoj::view::StrokeContour::StrokeContour(PointView path): path(path) {}
 xoj::view::StrokeContour::~StrokeContour() = default;
 
 static inline void drawCoupling(cairo_t* cr, std::vector<ReturnOp>& ops, const Point& p2, double n1, double n3,
@@ -183,8 +183,7 @@ void xoj::view::StrokeContour::drawDebug(cairo_t* cr) const {
 
 
 // Dashes
-xoj::view::StrokeContourDashes::StrokeContourDashes(const std::vector<Point>& path,
-                                                    const std::vector<double>& dashPattern):
+xoj::view::StrokeContourDashes::StrokeContourDashes(PointView path, const std::vector<double>& dashPattern):
         path(path), dashPattern(dashPattern) {}
 xoj::view::StrokeContourDashes::~StrokeContourDashes() = default;
 
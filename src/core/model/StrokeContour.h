@@ -15,30 +15,30 @@
 
 #include <cairo.h>
 
-class Point;
+#include "PointView.h"  // for PointView
 
 namespace xoj::view {
 class StrokeContour final {
 public:
-    explicit StrokeContour(const std::vector<Point>& path);
+    explicit StrokeContour(PointView path);
     ~StrokeContour();
     void addToCairo(cairo_t* cr) const;
     void drawDebug(cairo_t* cr) const;
 
 private:
-    const std::vector<Point>& path;
+    PointView path;
 };
 
 class StrokeContourDashes final {
 public:
-    StrokeContourDashes(const std::vector<Point>& path, const std::vector<double>& dashPattern);
+    StrokeContourDashes(PointView path, const std::vector<double>& dashPattern);
     ~StrokeContourDashes();
     /// Returns the new dash offset (= dashoffset + path length)
     double addToCairo(cairo_t* cr, double dashoffset) const;
     void drawDebug(cairo_t* cr) const;
 
 private:
-    const std::vector<Point>& path;
+    PointView path;
     const std::vector<double>& dashPattern;
 };
 };  // namespace xoj::view
@@ -0,0 +1,114 @@
+#include "StrokeContourCache.h"
+
+#include "model/LineStyle.h"          // for LineStyle
+#include "model/Stroke.h"             // for Stroke
+#include "util/raii/CairoWrappers.h"  // for CairoSPtr, CairoSurfaceSPtr
+
+#include "StrokeContour.h"  // for StrokeContour, StrokeContourDashes
+
+using namespace xoj::view;
+
+namespace {
+/// Tolerance used to approximate the arcs of the contour, in page coordinates, fine enough for high zoom levels
+constexpr double CONTOUR_TOLERANCE = 0.001;
+
+auto buildContour(const Stroke& s) -> cairo_path_t* {
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1), xoj::util::adopt);
+    xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+    cairo_set_tolerance(cr.get(), CONTOUR_TOLERANCE);
+
+    const auto& dashes = s.getLineStyle().getDashes();
+    if (!dashes.empty()) {
+        StrokeContourDashes(s.getPoints(), dashes).addToCairo(cr.get(), 0.0);
+    } else {
+        StrokeContour(s.getPoints()).addToCairo(cr.get());
+    }
+    return cairo_copy_path(cr.get());
+}
+}  // namespace
+
+CachedStrokeContour::CachedStrokeContour(cairo_path_t* path): path(path) {}
+
+CachedStrokeContour::~CachedStrokeContour() { cairo_path_destroy(this->path); }
+
+void CachedStrokeContour::addToCairo(cairo_t* cr) const { cairo_append_path(cr, this->path); }
+
+auto CachedStrokeContour::getSize() const -> size_t {
+    return sizeof(cairo_path_t) + static_cast<size_t>(this->path->num_data) * sizeof(cairo_path_data_t);
+}
+
+auto StrokeContourCache::instance() -> StrokeContourCache& {
+    static StrokeContourCache cache;
+    return cache;
+}
+
+auto StrokeContourCache::get(const Stroke& s) -> std::shared_ptr<const CachedStrokeContour> {
+    {
+        std::lock_guard lock(this->mutex);
+        // A copy of the stroke may refer to a contour which was evicted
+        if (auto contour = s.contour.lock(); contour && contour->cached) {
+            this->entries.splice(this->entries.begin(), this->entries, contour->position);
+            this->statistics.hits++;
+            return contour;
+        }
+        this->statistics.misses++;
+    }
+
+    cairo_path_t* path = buildContour(s);
+    if (path->status != CAIRO_STATUS_SUCCESS) {
+        cairo_path_destroy(path);
+        return nullptr;
+    }
+    auto contour = std::make_shared<const CachedStrokeContour>(path);
+    size_t contourSize = contour->getSize();
+
+    std::lock_guard lock(this->mutex);
+    if (auto previous = s.contour.lock(); previous && previous->cached) {
+        remove(*previous);
+    }
+    shrinkTo(this->maxSize > contourSize ? this->maxSize - contourSize : 0);
+
+    this->entries.push_front(contour);
+    contour->position = this->entries.begin();
+    contour->cached = true;
+    this->size += contourSize;
+    s.contour = contour;
+    return contour;
+}
+
+void StrokeContourCache::invalidate(const Stroke& s) {
+    std::lock_guard lock(this->mutex);
+    if (auto contour = s.contour.lock(); contour && contour->cached) {
+        remove(*contour);
+    }
+    s.contour.reset();
+}
+
+void StrokeContourCache::setMaxSize(size_t maxSize) {
+    std::lock_guard lock(this->mutex);
+    this->maxSize = maxSize;
+    shrinkTo(maxSize);
+}
+
+auto StrokeContourCache::getSize() const -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->size;
+}
+
+auto StrokeContourCache::getStatistics() const -> Statistics {
+    std::lock_guard lock(this->mutex);
+    return this->statistics;
+}
+
+void StrokeContourCache::remove(const CachedStrokeContour& contour) {
+    this->size -= contour.getSize();
+    contour.cached = false;
+    this->entries.erase(contour.position);
+}
+
+void StrokeContourCache::shrinkTo(size_t size) {
+    while (this->size > size && !this->entries.empty()) {
+        remove(*this->entries.back());
+        this->statistics.evictions++;
+    }
+}
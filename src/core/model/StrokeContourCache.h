@@ -0,0 +1,120 @@
+/*
+ * Xournal++
+ *
+ * Caches the contours of the strokes with pressure
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <list>     // for list
+#include <memory>   // for shared_ptr
+#include <mutex>    // for mutex
+
+#include <cairo.h>  // for cairo_path_t, cairo_t
+
+class Stroke;
+
+namespace xoj::view {
+/**
+ * Contour of a stroke with pressure, as added to cairo by StrokeContour (or StrokeContourDashes, with a zero dash
+ * offset), in page coordinates.
+ */
+class CachedStrokeContour final {
+public:
+    explicit CachedStrokeContour(cairo_path_t* path);
+    ~CachedStrokeContour();
+
+    CachedStrokeContour(const CachedStrokeContour&) = delete;
+    CachedStrokeContour& operator=(const CachedStrokeContour&) = delete;
+
+    void addToCairo(cairo_t* cr) const;
+
+    /**
+     * @return The memory used by the path, in bytes
+     */
+    size_t getSize() const;
+
+private:
+    cairo_path_t* path;
+
+    friend class StrokeContourCache;
+    /// The entry of the contour in the cache, if `cached`. Protected by the mutex of the cache.
+    mutable std::list<std::shared_ptr<const CachedStrokeContour>>::iterator position;
+    mutable bool cached = false;
+};
+
+/**
+ * Keeps the contour of the strokes with pressure, so that they are not computed again whenever the stroke is painted
+ * (in the page buffers, the previews, when exporting or printing).
+ *
+ * The contours are owned by the cache and kept as long as their total size fits in the budget, evicting the least
+ * recently used ones. The strokes only refer to their contour, and drop it when they change. The contours are reference
+ * counted, so evicting a contour which is being drawn is safe.
+ */
+class StrokeContourCache final {
+public:
+    struct Statistics {
+        /// A cached contour was used
+        uint64_t hits = 0;
+        /// The contour was built
+        uint64_t misses = 0;
+        /// A contour was dropped to fit in the budget
+        uint64_t evictions = 0;
+    };
+
+public:
+    /**
+     * The cache shared by all the strokes
+     */
+    static StrokeContourCache& instance();
+
+public:
+    /**
+     * @return The contour of the stroke, built and cached if needed, or nullptr if it could not be built. The new
+     * contour is kept even if it exceeds the budget on its own.
+     */
+    std::shared_ptr<const CachedStrokeContour> get(const Stroke& s);
+
+    /**
+     * Drops the contour of the stroke, which has changed
+     */
+    void invalidate(const Stroke& s);
+
+    /**
+     * @param maxSize The budget in bytes
+     */
+    void setMaxSize(size_t maxSize);
+
+    /**
+     * @return The size of the cached contours in bytes
+     */
+    size_t getSize() const;
+
+    Statistics getStatistics() const;
+
+private:
+    StrokeContourCache() = default;
+
+    void remove(const CachedStrokeContour& contour);
+    void shrinkTo(size_t size);
+
+private:
+    /// Protects the entries and the contour pointers of the strokes
+    mutable std::mutex mutex;
+
+    /// Most recently used first
+    std::list<std::shared_ptr<const CachedStrokeContour>> entries;
+
+    size_t size = 0;
+    size_t maxSize = 64 * 1024 * 1024;
+
+    Statistics statistics;
+};
+};  // namespace xoj::view
@@ -0,0 +1,347 @@
+#include "StrokeKernels.h"
+
+#include <algorithm>    // for min, max, clamp
+#include <cmath>        // for sqrt
+#include <cstddef>      // for offsetof
+#include <limits>       // for numeric_limits
+#include <type_traits>  // for is_standard_layout_v
+
+#include "util/Assert.h"  // for xoj_assert
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>  // for _mm_min_pd, _mm_max_pd...
+#define STROKE_KERNELS_SSE2
+#endif
+
+#if defined(STROKE_KERNELS_SSE2) && defined(__GNUC__)
+#include <immintrin.h>  // for _mm256_min_pd, _mm256_max_pd...
+#define STROKE_KERNELS_AVX2
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+using xoj::util::Rectangle;
+
+// The vectorised implementations read the points as an array of doubles: x0 y0 z0 x1 y1 z1 ...
+static_assert(std::is_standard_layout_v<Point>);
+static_assert(sizeof(Point) == 3 * sizeof(double) && offsetof(Point, x) == 0 && offsetof(Point, y) == sizeof(double) &&
+              offsetof(Point, z) == 2 * sizeof(double));
+
+namespace StrokeKernels {
+
+namespace {
+
+/*
+ * Scalar implementations. They are also used for the remainders of the vectorised loops.
+ */
+
+void addToBounds(Bounds& b, const Point& p) {
+    b.minX = std::min(b.minX, p.x);
+    b.minY = std::min(b.minY, p.y);
+    b.maxX = std::max(b.maxX, p.x);
+    b.maxY = std::max(b.maxY, p.y);
+    b.maxPressure = std::max(b.maxPressure, p.z);
+}
+
+Bounds computeBoundsScalar(std::span<const Point> pts) {
+    xoj_assert(!pts.empty());
+    Bounds b{pts[0].x, pts[0].y, pts[0].x, pts[0].y, pts[0].z};
+    for (const Point& p: pts.subspan(1)) {
+        addToBounds(b, p);
+    }
+    return b;
+}
+
+/// Distance between (x, y) and the segment [p1, p2], minus half the width of the segment
+double distanceToSegment(const Point& p1, const Point& p2, double x, double y, double defaultWidth) {
+    double vx = p2.x - p1.x;
+    double vy = p2.y - p1.y;
+    double squaredLength = vx * vx + vy * vy;
+    double ratio = squaredLength > 0.0 ? std::clamp(((x - p1.x) * vx + (y - p1.y) * vy) / squaredLength, 0., 1.) : 0.;
+    /// (x, y) minus its projection onto the segment
+    double dx = x - (p1.x + ratio * vx);
+    double dy = y - (p1.y + ratio * vy);
+    double width = p1.z == Point::NO_PRESSURE ? defaultWidth : p1.z;
+    return std::sqrt(dx * dx + dy * dy) - .5 * width;
+}
+
+double distanceToScalarFrom(std::span<const Point> pts, size_t first, double x, double y, double defaultWidth,
+                            double distance) {
+    for (size_t i = first; i + 1 < pts.size(); i++) {
+        distance = std::min(distance, distanceToSegment(pts[i], pts[i + 1], x, y, defaultWidth));
+    }
+    return std::max(distance, 0.);
+}
+
+double distanceToScalar(std::span<const Point> pts, double x, double y, double defaultWidth) {
+    return distanceToScalarFrom(pts, 0, x, y, defaultWidth, std::numeric_limits<double>::max());
+}
+
+bool isInside(const Point& p, const Rectangle<double>& rect) {
+    return p.x >= rect.x && p.x <= rect.x + rect.width && p.y >= rect.y && p.y <= rect.y + rect.height;
+}
+
+bool anyPointInsideScalar(std::span<const Point> pts, const Rectangle<double>& rect) {
+    return std::any_of(pts.begin(), pts.end(), [&rect](const Point& p) { return isInside(p, rect); });
+}
+
+bool isSegmentTouchingRectangle(const Point& p, const Point& q, const Rectangle<double>& rect) {
+    return std::max(p.x, q.x) >= rect.x && std::min(p.x, q.x) <= rect.x + rect.width &&
+           std::max(p.y, q.y) >= rect.y && std::min(p.y, q.y) <= rect.y + rect.height;
+}
+
+size_t findSegmentTouchingRectangleScalar(std::span<const Point> pts, size_t first, size_t last,
+                                          const Rectangle<double>& rect) {
+    xoj_assert(last + 1 < pts.size());
+    for (size_t i = first; i <= last; i++) {
+        if (isSegmentTouchingRectangle(pts[i], pts[i + 1], rect)) {
+            return i;
+        }
+    }
+    return last + 1;
+}
+
+#ifdef STROKE_KERNELS_SSE2
+/*
+ * SSE2 implementations, on pairs of doubles
+ */
+
+double lane0(__m128d v) { return _mm_cvtsd_f64(v); }
+double lane1(__m128d v) { return _mm_cvtsd_f64(_mm_unpackhi_pd(v, v)); }
+
+Bounds computeBoundsSSE2(std::span<const Point> pts) {
+    xoj_assert(!pts.empty());
+    if (pts.size() < 2) {
+        return computeBoundsScalar(pts);
+    }
+    // Two points fill three registers: (x0, y0) (z0, x1) (y1, z1)
+    const double* data = &pts[0].x;
+    __m128d minA = _mm_loadu_pd(data), minB = _mm_loadu_pd(data + 2), minC = _mm_loadu_pd(data + 4);
+    __m128d maxA = minA, maxB = minB, maxC = minC;
+    size_t i = 2;
+    for (; i + 2 <= pts.size(); i += 2) {
+        const double* d = data + 3 * i;
+        __m128d a = _mm_loadu_pd(d), b = _mm_loadu_pd(d + 2), c = _mm_loadu_pd(d + 4);
+        minA = _mm_min_pd(minA, a), minB = _mm_min_pd(minB, b), minC = _mm_min_pd(minC, c);
+        maxA = _mm_max_pd(maxA, a), maxB = _mm_max_pd(maxB, b), maxC = _mm_max_pd(maxC, c);
+    }
+    Bounds bounds{std::min(lane0(minA), lane1(minB)), std::min(lane1(minA), lane0(minC)),
+                  std::max(lane0(maxA), lane1(maxB)), std::max(lane1(maxA), lane0(maxC)),
+                  std::max(lane0(maxB), lane1(maxC))};
+    for (; i < pts.size(); i++) {
+        addToBounds(bounds, pts[i]);
+    }
+    return bounds;
+}
+
+double distanceToSSE2(std::span<const Point> pts, double x, double y, double defaultWidth) {
+    const __m128d px = _mm_set1_pd(x), py = _mm_set1_pd(y);
+    const __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1.0), half = _mm_set1_pd(.5);
+    const __m128d noPressure = _mm_set1_pd(Point::NO_PRESSURE), width = _mm_set1_pd(defaultWidth);
+    __m128d distance = _mm_set1_pd(std::numeric_limits<double>::max());
+
+    // Two segments per iteration: [pts[i], pts[i + 1]] and [pts[i + 1], pts[i + 2]]
+    size_t i = 0;
+    for (; i + 2 < pts.size(); i += 2) {
+        const Point& p0 = pts[i];
+        const Point& p1 = pts[i + 1];
+        const Point& p2 = pts[i + 2];
+        __m128d x1 = _mm_set_pd(p1.x, p0.x), y1 = _mm_set_pd(p1.y, p0.y), z1 = _mm_set_pd(p1.z, p0.z);
+        __m128d vx = _mm_sub_pd(_mm_set_pd(p2.x, p1.x), x1);
+        __m128d vy = _mm_sub_pd(_mm_set_pd(p2.y, p1.y), y1);
+        __m128d squaredLength = _mm_add_pd(_mm_mul_pd(vx, vx), _mm_mul_pd(vy, vy));
+        __m128d dot = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(px, x1), vx), _mm_mul_pd(_mm_sub_pd(py, y1), vy));
+        // _mm_max_pd returns its second operand if the first one is NaN
+        __m128d ratio = _mm_min_pd(_mm_max_pd(_mm_div_pd(dot, squaredLength), zero), one);
+        ratio = _mm_and_pd(ratio, _mm_cmpgt_pd(squaredLength, zero));
+        __m128d dx = _mm_sub_pd(px, _mm_add_pd(x1, _mm_mul_pd(ratio, vx)));
+        __m128d dy = _mm_sub_pd(py, _mm_add_pd(y1, _mm_mul_pd(ratio, vy)));
+        __m128d hasNoPressure = _mm_cmpeq_pd(z1, noPressure);
+        __m128d w = _mm_or_pd(_mm_and_pd(hasNoPressure, width), _mm_andnot_pd(hasNoPressure, z1));
+        __m128d d = _mm_sub_pd(_mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy))), _mm_mul_pd(half, w));
+        distance = _mm_min_pd(distance, d);
+    }
+    return distanceToScalarFrom(pts, i, x, y, defaultWidth, std::min(lane0(distance), lane1(distance)));
+}
+
+bool anyPointInsideSSE2(std::span<const Point> pts, const Rectangle<double>& rect) {
+    const __m128d lower = _mm_set_pd(rect.y, rect.x);
+    const __m128d upper = _mm_set_pd(rect.y + rect.height, rect.x + rect.width);
+    for (const Point& p: pts) {
+        __m128d xy = _mm_loadu_pd(&p.x);
+        if (_mm_movemask_pd(_mm_and_pd(_mm_cmpge_pd(xy, lower), _mm_cmple_pd(xy, upper))) == 0b11) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t findSegmentTouchingRectangleSSE2(std::span<const Point> pts, size_t first, size_t last,
+                                        const Rectangle<double>& rect) {
+    xoj_assert(last + 1 < pts.size());
+    const __m128d lower = _mm_set_pd(rect.y, rect.x);
+    const __m128d upper = _mm_set_pd(rect.y + rect.height, rect.x + rect.width);
+    __m128d q = _mm_loadu_pd(&pts[first].x);
+    for (size_t i = first; i <= last; i++) {
+        __m128d p = q;
+        q = _mm_loadu_pd(&pts[i + 1].x);
+        __m128d touching = _mm_and_pd(_mm_cmpge_pd(_mm_max_pd(p, q), lower), _mm_cmple_pd(_mm_min_pd(p, q), upper));
+        if (_mm_movemask_pd(touching) == 0b11) {
+            return i;
+        }
+    }
+    return last + 1;
+}
+#endif
+
+#ifdef STROKE_KERNELS_AVX2
+/*
+ * AVX2 implementations, on quadruples of doubles: the same coordinate of 4 consecutive points
+ */
+
+TARGET_AVX2 Bounds computeBoundsAVX2(std::span<const Point> pts) {
+    xoj_assert(!pts.empty());
+    if (pts.size() < 4) {
+        return computeBoundsScalar(pts);
+    }
+    // Four points fill three registers: (x0, y0, z0, x1) (y1, z1, x2, y2) (z2, x3, y3, z3)
+    const double* data = &pts[0].x;
+    __m256d minA = _mm256_loadu_pd(data), minB = _mm256_loadu_pd(data + 4), minC = _mm256_loadu_pd(data + 8);
+    __m256d maxA = minA, maxB = minB, maxC = minC;
+    size_t i = 4;
+    for (; i + 4 <= pts.size(); i += 4) {
+        const double* d = data + 3 * i;
+        __m256d a = _mm256_loadu_pd(d), b = _mm256_loadu_pd(d + 4), c = _mm256_loadu_pd(d + 8);
+        minA = _mm256_min_pd(minA, a), minB = _mm256_min_pd(minB, b), minC = _mm256_min_pd(minC, c);
+        maxA = _mm256_max_pd(maxA, a), maxB = _mm256_max_pd(maxB, b), maxC = _mm256_max_pd(maxC, c);
+    }
+    double mins[12];
+    double maxs[12];
+    _mm256_storeu_pd(mins, minA), _mm256_storeu_pd(mins + 4, minB), _mm256_storeu_pd(mins + 8, minC);
+    _mm256_storeu_pd(maxs, maxA), _mm256_storeu_pd(maxs + 4, maxB), _mm256_storeu_pd(maxs + 8, maxC);
+    Bounds bounds{mins[0], mins[1], maxs[0], maxs[1], maxs[2]};
+    for (size_t n = 1; n < 4; n++) {
+        bounds.minX = std::min(bounds.minX, mins[3 * n]);
+        bounds.minY = std::min(bounds.minY, mins[3 * n + 1]);
+        bounds.maxX = std::max(bounds.maxX, maxs[3 * n]);
+        bounds.maxY = std::max(bounds.maxY, maxs[3 * n + 1]);
+        bounds.maxPressure = std::max(bounds.maxPressure, maxs[3 * n + 2]);
+    }
+    for (; i < pts.size(); i++) {
+        addToBounds(bounds, pts[i]);
+    }
+    return bounds;
+}
+
+TARGET_AVX2 double distanceToAVX2(std::span<const Point> pts, double x, double y, double defaultWidth) {
+    const __m256d px = _mm256_set1_pd(x), py = _mm256_set1_pd(y);
+    const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0), half = _mm256_set1_pd(.5);
+    const __m256d noPressure = _mm256_set1_pd(Point::NO_PRESSURE), width = _mm256_set1_pd(defaultWidth);
+    __m256d distance = _mm256_set1_pd(std::numeric_limits<double>::max());
+
+    // Four segments per iteration: [pts[i], pts[i + 1]] ... [pts[i + 3], pts[i + 4]]
+    size_t i = 0;
+    for (; i + 4 < pts.size(); i += 4) {
+        const Point* p = &pts[i];
+        __m256d x1 = _mm256_set_pd(p[3].x, p[2].x, p[1].x, p[0].x);
+        __m256d y1 = _mm256_set_pd(p[3].y, p[2].y, p[1].y, p[0].y);
+        __m256d z1 = _mm256_set_pd(p[3].z, p[2].z, p[1].z, p[0].z);
+        __m256d vx = _mm256_sub_pd(_mm256_set_pd(p[4].x, p[3].x, p[2].x, p[1].x), x1);
+        __m256d vy = _mm256_sub_pd(_mm256_set_pd(p[4].y, p[3].y, p[2].y, p[1].y), y1);
+        __m256d squaredLength = _mm256_add_pd(_mm256_mul_pd(vx, vx), _mm256_mul_pd(vy, vy));
+        __m256d dot =
+                _mm256_add_pd(_mm256_mul_pd(_mm256_sub_pd(px, x1), vx), _mm256_mul_pd(_mm256_sub_pd(py, y1), vy));
+        // _mm256_max_pd returns its second operand if the first one is NaN
+        __m256d ratio = _mm256_min_pd(_mm256_max_pd(_mm256_div_pd(dot, squaredLength), zero), one);
+        ratio = _mm256_and_pd(ratio, _mm256_cmp_pd(squaredLength, zero, _CMP_GT_OQ));
+        __m256d dx = _mm256_sub_pd(px, _mm256_add_pd(x1, _mm256_mul_pd(ratio, vx)));
+        __m256d dy = _mm256_sub_pd(py, _mm256_add_pd(y1, _mm256_mul_pd(ratio, vy)));
+        __m256d w = _mm256_blendv_pd(z1, width, _mm256_cmp_pd(z1, noPressure, _CMP_EQ_OQ));
+        __m256d dist = _mm256_sub_pd(_mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))),
+                                     _mm256_mul_pd(half, w));
+        distance = _mm256_min_pd(distance, dist);
+    }
+    double distances[4];
+    _mm256_storeu_pd(distances, distance);
+    double minDistance = std::min(std::min(distances[0], distances[1]), std::min(distances[2], distances[3]));
+    return distanceToScalarFrom(pts, i, x, y, defaultWidth, minDistance);
+}
+
+TARGET_AVX2 bool anyPointInsideAVX2(std::span<const Point> pts, const Rectangle<double>& rect) {
+    const __m256d minX = _mm256_set1_pd(rect.x), maxX = _mm256_set1_pd(rect.x + rect.width);
+    const __m256d minY = _mm256_set1_pd(rect.y), maxY = _mm256_set1_pd(rect.y + rect.height);
+    size_t i = 0;
+    for (; i + 4 <= pts.size(); i += 4) {
+        const Point* p = &pts[i];
+        __m256d x = _mm256_set_pd(p[3].x, p[2].x, p[1].x, p[0].x);
+        __m256d y = _mm256_set_pd(p[3].y, p[2].y, p[1].y, p[0].y);
+        __m256d insideX = _mm256_and_pd(_mm256_cmp_pd(x, minX, _CMP_GE_OQ), _mm256_cmp_pd(x, maxX, _CMP_LE_OQ));
+        __m256d insideY = _mm256_and_pd(_mm256_cmp_pd(y, minY, _CMP_GE_OQ), _mm256_cmp_pd(y, maxY, _CMP_LE_OQ));
+        if (_mm256_movemask_pd(_mm256_and_pd(insideX, insideY)) != 0) {
+            return true;
+        }
+    }
+    return anyPointInsideScalar(pts.subspan(i), rect);
+}
+
+TARGET_AVX2 size_t findSegmentTouchingRectangleAVX2(std::span<const Point> pts, size_t first, size_t last,
+                                                    const Rectangle<double>& rect) {
+    xoj_assert(last + 1 < pts.size());
+    const __m256d minX = _mm256_set1_pd(rect.x), maxX = _mm256_set1_pd(rect.x + rect.width);
+    const __m256d minY = _mm256_set1_pd(rect.y), maxY = _mm256_set1_pd(rect.y + rect.height);
+    size_t i = first;
+    for (; i + 3 <= last; i += 4) {
+        const Point* p = &pts[i];
+        __m256d x1 = _mm256_set_pd(p[3].x, p[2].x, p[1].x, p[0].x);
+        __m256d y1 = _mm256_set_pd(p[3].y, p[2].y, p[1].y, p[0].y);
+        __m256d x2 = _mm256_set_pd(p[4].x, p[3].x, p[2].x, p[1].x);
+        __m256d y2 = _mm256_set_pd(p[4].y, p[3].y, p[2].y, p[1].y);
+        __m256d touchingX = _mm256_and_pd(_mm256_cmp_pd(_mm256_max_pd(x1, x2), minX, _CMP_GE_OQ),
+                                          _mm256_cmp_pd(_mm256_min_pd(x1, x2), maxX, _CMP_LE_OQ));
+        __m256d touchingY = _mm256_and_pd(_mm256_cmp_pd(_mm256_max_pd(y1, y2), minY, _CMP_GE_OQ),
+                                          _mm256_cmp_pd(_mm256_min_pd(y1, y2), maxY, _CMP_LE_OQ));
+        if (int mask = _mm256_movemask_pd(_mm256_and_pd(touchingX, touchingY)); mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+    return i <= last ? findSegmentTouchingRectangleScalar(pts, i, last, rect) : last + 1;
+}
+#endif
+
+const Implementation& getBestImplementation() {
+    static const Implementation best = getImplementations().back();
+    return best;
+}
+}  // namespace
+
+auto getImplementations() -> std::vector<Implementation> {
+    std::vector<Implementation> implementations;
+    implementations.push_back({"scalar", computeBoundsScalar, distanceToScalar, anyPointInsideScalar,
+                               findSegmentTouchingRectangleScalar});
+#ifdef STROKE_KERNELS_SSE2
+    implementations.push_back(
+            {"SSE2", computeBoundsSSE2, distanceToSSE2, anyPointInsideSSE2, findSegmentTouchingRectangleSSE2});
+#endif
+#ifdef STROKE_KERNELS_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        implementations.push_back(
+                {"AVX2", computeBoundsAVX2, distanceToAVX2, anyPointInsideAVX2, findSegmentTouchingRectangleAVX2});
+    }
+#endif
+    return implementations;
+}
+
+auto computeBounds(std::span<const Point> pts) -> Bounds { return getBestImplementation().computeBounds(pts); }
+
+auto distanceTo(std::span<const Point> pts, double x, double y, double defaultWidth) -> double {
+    return getBestImplementation().distanceTo(pts, x, y, defaultWidth);
+}
+
+auto anyPointInside(std::span<const Point> pts, const Rectangle<double>& rect) -> bool {
+    return getBestImplementation().anyPointInside(pts, rect);
+}
+
+auto findSegmentTouchingRectangle(std::span<const Point> pts, size_t first, size_t last, const Rectangle<double>& rect)
+        -> size_t {
+    return getBestImplementation().findSegmentTouchingRectangle(pts, first, last, rect);
+}
+};  // namespace StrokeKernels
@@ -0,0 +1,79 @@
+/*
+ * Xournal++
+ *
+ * Vectorised loops over the points of a stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <span>     // for span
+#include <vector>   // for vector
+
+#include "util/Rectangle.h"  // for Rectangle
+
+#include "Point.h"  // for Point
+
+/**
+ * The loops run on every eraser motion, selection test and object pick. Each one has a scalar implementation and,
+ * depending on the platform, SSE2 and AVX2 implementations. The fastest one supported by the CPU is picked at runtime.
+ */
+namespace StrokeKernels {
+
+struct Bounds {
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+    /// Point::NO_PRESSURE if none of the points has a pressure value
+    double maxPressure;
+};
+
+/**
+ * @brief The smallest rectangle containing the points, and the largest pressure value
+ * Assumes there is at least one point
+ */
+[[nodiscard]] Bounds computeBounds(std::span<const Point> pts);
+
+/**
+ * @brief The distance between (x, y) and the polyline, minus half the width of the closest segment, and at least 0.
+ * The width of a segment is the pressure value of its first point, or defaultWidth if it has none.
+ * @return std::numeric_limits<double>::max() if there are less than two points
+ */
+[[nodiscard]] double distanceTo(std::span<const Point> pts, double x, double y, double defaultWidth);
+
+/**
+ * @brief Whether a point lies in the rectangle, its border included
+ */
+[[nodiscard]] bool anyPointInside(std::span<const Point> pts, const xoj::util::Rectangle<double>& rect);
+
+/**
+ * @brief Find the first segment [pts[i], pts[i + 1]], with first <= i <= last, whose bounding box meets the rectangle
+ * (its border included). The other segments can neither cross nor touch the rectangle.
+ * Assumes last + 1 < pts.size()
+ * @return The index i of the segment, or last + 1 if there is none
+ */
+[[nodiscard]] size_t findSegmentTouchingRectangle(std::span<const Point> pts, size_t first, size_t last,
+                                                  const xoj::util::Rectangle<double>& rect);
+
+/**
+ * A set of implementations of the above functions
+ */
+struct Implementation {
+    const char* name;
+    Bounds (*computeBounds)(std::span<const Point> pts);
+    double (*distanceTo)(std::span<const Point> pts, double x, double y, double defaultWidth);
+    bool (*anyPointInside)(std::span<const Point> pts, const xoj::util::Rectangle<double>& rect);
+    size_t (*findSegmentTouchingRectangle)(std::span<const Point> pts, size_t first, size_t last,
+                                           const xoj::util::Rectangle<double>& rect);
+};
+
+/**
+ * @return The implementations supported by the CPU: the scalar one first, the one used by the above functions last
+ */
+[[nodiscard]] std::vector<Implementation> getImplementations();
+};  // namespace StrokeKernels
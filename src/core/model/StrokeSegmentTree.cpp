@@ -0,0 +1,148 @@
+#include "StrokeSegmentTree.h"
+
+#include <algorithm>  // for min, max
+#include <cmath>      // for hypot
+#include <limits>     // for numeric_limits
+#include <utility>    // for move, swap
+
+#include "util/Assert.h"  // for xoj_assert
+
+using xoj::util::Rectangle;
+
+namespace {
+auto touches(const StrokeKernels::Bounds& b, const Rectangle<double>& rect) -> bool {
+    return b.maxX >= rect.x && b.minX <= rect.x + rect.width && b.maxY >= rect.y && b.minY <= rect.y + rect.height;
+}
+
+auto unite(const StrokeKernels::Bounds& a, const StrokeKernels::Bounds& b) -> StrokeKernels::Bounds {
+    return {std::min(a.minX, b.minX), std::min(a.minY, b.minY), std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY),
+            std::max(a.maxPressure, b.maxPressure)};
+}
+
+/// Distance between (x, y) and the box, 0 if it lies inside
+auto distanceToBox(const StrokeKernels::Bounds& b, double x, double y) -> double {
+    double dx = std::max({b.minX - x, 0.0, x - b.maxX});
+    double dy = std::max({b.minY - y, 0.0, y - b.maxY});
+    return std::hypot(dx, dy);
+}
+}  // namespace
+
+StrokeSegmentTree::StrokeSegmentTree(std::span<const Point> pts): segmentCount(pts.size() - 1) {
+    xoj_assert(pts.size() >= 2);
+
+    auto& leaves = levels.emplace_back();
+    leaves.reserve((segmentCount + LEAF_SIZE - 1) / LEAF_SIZE);
+    for (size_t first = 0; first < segmentCount; first += LEAF_SIZE) {
+        // The block of segments first, ..., first + LEAF_SIZE - 1 ends on the point first + LEAF_SIZE
+        size_t count = std::min(LEAF_SIZE, segmentCount - first) + 1;
+        leaves.push_back(StrokeKernels::computeBounds(pts.subspan(first, count)));
+    }
+
+    while (levels.back().size() > 1) {
+        const auto& below = levels.back();
+        std::vector<StrokeKernels::Bounds> level;
+        level.reserve((below.size() + 1) / 2);
+        for (size_t i = 0; i < below.size(); i += 2) {
+            level.push_back(i + 1 < below.size() ? unite(below[i], below[i + 1]) : below[i]);
+        }
+        levels.push_back(std::move(level));
+    }
+}
+
+size_t StrokeSegmentTree::getFirstSegment(size_t level, size_t node) const { return (node * LEAF_SIZE) << level; }
+
+size_t StrokeSegmentTree::getLastSegment(size_t level, size_t node) const {
+    return std::min(((node + 1) * LEAF_SIZE) << level, segmentCount) - 1;
+}
+
+size_t StrokeSegmentTree::findSegmentTouchingRectangle(std::span<const Point> pts, size_t first, size_t last,
+                                                       const Rectangle<double>& rect) const {
+    xoj_assert(pts.size() == segmentCount + 1);
+    return findSegmentTouchingRectangle(pts, levels.size() - 1, 0, first, last, rect);
+}
+
+size_t StrokeSegmentTree::findSegmentTouchingRectangle(std::span<const Point> pts, size_t level, size_t node,
+                                                       size_t first, size_t last, const Rectangle<double>& rect) const {
+    size_t nodeFirst = getFirstSegment(level, node);
+    size_t nodeLast = getLastSegment(level, node);
+    if (nodeLast < first || nodeFirst > last || !touches(levels[level][node], rect)) {
+        return last + 1;
+    }
+    if (level == 0) {
+        size_t end = std::min(nodeLast, last);
+        size_t i = StrokeKernels::findSegmentTouchingRectangle(pts, std::max(nodeFirst, first), end, rect);
+        return i <= end ? i : last + 1;
+    }
+    for (size_t child = 2 * node; child < std::min(2 * node + 2, levels[level - 1].size()); child++) {
+        size_t i = findSegmentTouchingRectangle(pts, level - 1, child, first, last, rect);
+        if (i <= last) {
+            return i;
+        }
+    }
+    return last + 1;
+}
+
+double StrokeSegmentTree::distanceTo(std::span<const Point> pts, double x, double y, double defaultWidth) const {
+    xoj_assert(pts.size() == segmentCount + 1);
+    double distance = std::numeric_limits<double>::max();
+    updateDistance(pts, levels.size() - 1, 0, x, y, defaultWidth, distance);
+    return distance;
+}
+
+void StrokeSegmentTree::updateDistance(std::span<const Point> pts, size_t level, size_t node, double x, double y,
+                                       double defaultWidth, double& distance) const {
+    const auto& box = levels[level][node];
+    // No segment of the node can be closer than this
+    double lowerBound = distanceToBox(box, x, y) - 0.5 * std::max(box.maxPressure, defaultWidth);
+    if (distance <= 0.0 || lowerBound >= distance) {
+        return;
+    }
+    if (level == 0) {
+        size_t first = getFirstSegment(level, node);
+        size_t count = getLastSegment(level, node) - first + 2;
+        distance = std::min(distance, StrokeKernels::distanceTo(pts.subspan(first, count), x, y, defaultWidth));
+        return;
+    }
+
+    // Visit the closer child first, to prune more of the other one
+    size_t children[2] = {2 * node, 2 * node + 1};
+    size_t childCount = std::min<size_t>(2, levels[level - 1].size() - 2 * node);
+    if (childCount == 2 && distanceToBox(levels[level - 1][children[1]], x, y) <
+                                   distanceToBox(levels[level - 1][children[0]], x, y)) {
+        std::swap(children[0], children[1]);
+    }
+    for (size_t i = 0; i < childCount; i++) {
+        updateDistance(pts, level - 1, children[i], x, y, defaultWidth, distance);
+    }
+}
+
+StrokeKernels::Bounds StrokeSegmentTree::getBounds(std::span<const Point> pts, size_t first, size_t last) const {
+    xoj_assert(pts.size() == segmentCount + 1);
+    xoj_assert(first <= last && last < pts.size());
+    StrokeKernels::Bounds bounds = StrokeKernels::computeBounds(pts.subspan(first, 1));
+    addBounds(pts, levels.size() - 1, 0, first, last, bounds);
+    return bounds;
+}
+
+void StrokeSegmentTree::addBounds(std::span<const Point> pts, size_t level, size_t node, size_t first, size_t last,
+                                  StrokeKernels::Bounds& bounds) const {
+    // The points of the node, both bounds included
+    size_t nodeFirst = getFirstSegment(level, node);
+    size_t nodeLast = getLastSegment(level, node) + 1;
+    if (nodeLast < first || nodeFirst > last) {
+        return;
+    }
+    if (first <= nodeFirst && nodeLast <= last) {
+        bounds = unite(bounds, levels[level][node]);
+        return;
+    }
+    if (level == 0) {
+        size_t begin = std::max(nodeFirst, first);
+        size_t end = std::min(nodeLast, last);
+        bounds = unite(bounds, StrokeKernels::computeBounds(pts.subspan(begin, end - begin + 1)));
+        return;
+    }
+    for (size_t child = 2 * node; child < std::min(2 * node + 2, levels[level - 1].size()); child++) {
+        addBounds(pts, level - 1, child, first, last, bounds);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Xournal++
+ *
+ * Hierarchy of the bounding boxes of the segments of a long stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <span>     // for span
+#include <vector>   // for vector
+
+#include "util/Rectangle.h"  // for Rectangle
+
+#include "Point.h"          // for Point
+#include "StrokeKernels.h"  // for Bounds
+
+/**
+ * Bounding boxes of the segments of a stroke, grouped hierarchically, so that the segments near a point or a rectangle
+ * are found in logarithmic time instead of walking the whole stroke.
+ *
+ * The segments are grouped in blocks of LEAF_SIZE consecutive segments. The first level holds the box of each block,
+ * and each level above holds the unions of two consecutive boxes of the level below. The boxes contain the points and
+ * their largest pressure value, not the width of the stroke.
+ *
+ * The tree does not keep the points: the queries take the points the tree was built from.
+ */
+class StrokeSegmentTree final {
+public:
+    /// Number of segments in a block, searched with the vectorised loops of StrokeKernels
+    static constexpr size_t LEAF_SIZE = 32;
+
+    /// Strokes with fewer points are faster to search linearly
+    static constexpr size_t MIN_POINT_COUNT = 4 * LEAF_SIZE;
+
+    /**
+     * Assumes there are at least two points
+     */
+    explicit StrokeSegmentTree(std::span<const Point> pts);
+
+    /**
+     * @brief Same as StrokeKernels::findSegmentTouchingRectangle()
+     */
+    size_t findSegmentTouchingRectangle(std::span<const Point> pts, size_t first, size_t last,
+                                        const xoj::util::Rectangle<double>& rect) const;
+
+    /**
+     * @brief Same as StrokeKernels::distanceTo()
+     */
+    double distanceTo(std::span<const Point> pts, double x, double y, double defaultWidth) const;
+
+    /**
+     * @brief The bounds of the points pts[first], ..., pts[last]
+     * Assumes first <= last < pts.size()
+     */
+    StrokeKernels::Bounds getBounds(std::span<const Point> pts, size_t first, size_t last) const;
+
+private:
+    /**
+     * @brief The segments covered by a node, both bounds included
+     */
+    size_t getFirstSegment(size_t level, size_t node) const;
+    size_t getLastSegment(size_t level, size_t node) const;
+
+    size_t findSegmentTouchingRectangle(std::span<const Point> pts, size_t level, size_t node, size_t first,
+                                        size_t last, const xoj::util::Rectangle<double>& rect) const;
+
+    void updateDistance(std::span<const Point> pts, size_t level, size_t node, double x, double y,
+                        double defaultWidth, double& distance) const;
+
+    void addBounds(std::span<const Point> pts, size_t level, size_t node, size_t first, size_t last,
+                   StrokeKernels::Bounds& bounds) const;
+
+private:
+    size_t segmentCount;
+
+    /// levels[0] holds the boxes of the blocks of segments, levels.back() the box of the whole stroke
+    std::vector<std::vector<StrokeKernels::Bounds>> levels;
+};
@@ -55,11 +55,13 @@ auto TexImage::clone() const -> ElementPtr { return cloneTexImage(); }
 void TexImage::setWidth(double width) {
     this->width = width;
     this->calcSize();
+    boundsChanged();
 }
 
 void TexImage::setHeight(double height) {
     this->height = height;
     this->calcSize();
+    boundsChanged();
 }
 
 auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned int length) -> cairo_status_t {
@@ -126,6 +128,7 @@ void TexImage::scale(double x0, double y0, double fx, double fy, double rotation
     this->width *= fx;
     this->height *= fy;
     this->calcSize();
+    boundsChanged();
 }
 
 void TexImage::rotate(double x0, double y0, double th) {
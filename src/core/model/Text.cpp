@@ -51,6 +51,7 @@ auto Text::getFont() const -> const XojFont& { return font; }
 void Text::setFont(const XojFont& font) {
     this->font = font;
     sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Text::getFontSize() const -> double { return font.getSize(); }
@@ -62,6 +63,7 @@ auto Text::getText() const -> const std::string& { return this->text; }
 void Text::setText(std::string text) {
     this->text = std::move(text);
     sizeCalculated = false;
+    boundsChanged();
 }
 
 void Text::calcSize() const {
@@ -78,11 +80,13 @@ void Text::calcSize() const {
 void Text::setWidth(double width) {
     this->width = width;
     this->updateSnapping();
+    boundsChanged();
 }
 
 void Text::setHeight(double height) {
     this->height = height;
     this->updateSnapping();
+    boundsChanged();
 }
 
 void Text::setInEditing(bool inEditing) { this->inEditing = inEditing; }
@@ -129,6 +133,7 @@ void Text::scale(double x0, double y0, double fx, double fy, double rotation,
     this->font.setSize(size);
 
     sizeCalculated = false;
+    boundsChanged();
 }
 
 void Text::rotate(double x0, double y0, double th) {}
@@ -2,8 +2,11 @@
 
 #include <algorithm>  // for find, transform
 #include <iterator>   // for back_insert_iterator, back_inserter, begin
+#include <mutex>      // for lock_guard
 #include <utility>    // for move
 
+#include "model/Element.h"   // for Element, ELEMENT_IMAGE
+#include "model/Image.h"     // for Image
 #include "model/Layer.h"     // for Layer, Layer::Index
 #include "model/PageType.h"  // for PageType, PageTypeFormat, PageTypeForma...
 #include "util/Assert.h"     // for xoj_assert
@@ -31,7 +34,21 @@ XojPage::XojPage(XojPage const& page):
         currentLayer(page.currentLayer),
         bgType(page.bgType),
         pdfBackgroundPage(page.pdfBackgroundPage),
-        backgroundColor(page.backgroundColor) {
+        backgroundColor(page.backgroundColor),
+        backgroundVisible(page.backgroundVisible),
+        backgroundName(page.backgroundName) {
+    {
+        std::lock_guard lock(page.layerLoaderMutex);
+        this->loadError = page.loadError;
+        if (page.layerLoader && !page.layersModified && page.loadError.empty()) {
+            // The layers are the ones created by the loader: share it instead of copying them
+            this->layerLoader = page.layerLoader;
+            this->layersLoaded = false;
+            return;
+        }
+    }
+
+    page.ensureLayersLoaded();
     this->layer.reserve(page.layer.size());
     std::transform(begin(page.layer), end(page.layer), std::back_inserter(this->layer),
                    [](auto* layer) { return layer->clone(); });
@@ -40,11 +57,13 @@ XojPage::XojPage(XojPage const& page):
 auto XojPage::clone() -> XojPage* { return new XojPage(*this); }
 
 void XojPage::addLayer(Layer* layer) {
+    ensureLayersWritable();
     this->layer.push_back(layer);
     this->currentLayer = npos;
 }
 
 void XojPage::insertLayer(Layer* layer, Layer::Index index) {
+    ensureLayersWritable();
     if (index >= this->layer.size()) {
         addLayer(layer);
         return;
@@ -55,6 +74,7 @@ void XojPage::insertLayer(Layer* layer, Layer::Index index) {
 }
 
 void XojPage::removeLayer(Layer* l) {
+    ensureLayersWritable();
     if (auto it = std::find(layer.begin(), layer.end(), l); it != layer.end()) {
         this->layer.erase(it);
     }
@@ -65,19 +85,45 @@ void XojPage::removeLayer(Layer* l) {
     }
 }
 
+void XojPage::setLayers(std::vector<Layer*> layers) {
+    std::lock_guard lock(this->layerLoaderMutex);
+    for (Layer* l: this->layer) { delete l; }
+    this->layer = std::move(layers);
+    // ensure at least one valid layer exists
+    if (this->layer.empty()) {
+        this->layer.push_back(new Layer());
+    }
+    this->layerLoader = nullptr;
+    this->loadError.clear();
+    this->layersModified = true;
+    markChanged();
+    this->layersLoaded = true;
+    this->currentLayer = npos;
+}
+
 void XojPage::setSelectedLayerId(Layer::Index id) { this->currentLayer = id; }
 
-auto XojPage::getLayers() -> std::vector<Layer*>& { return this->layer; }
+auto XojPage::getLayers() -> std::vector<Layer*>& {
+    ensureLayersWritable();
+    return this->layer;
+}
 
-auto XojPage::getLayersView() const -> xoj::util::PointerContainerView<std::vector<Layer*>> { return this->layer; }
+auto XojPage::getLayersView() const -> xoj::util::PointerContainerView<std::vector<Layer*>> {
+    ensureLayersLoaded();
+    return this->layer;
+}
 
-auto XojPage::getLayerCount() const -> Layer::Index { return this->layer.size(); }
+auto XojPage::getLayerCount() const -> Layer::Index {
+    ensureLayersLoaded();
+    return this->layer.size();
+}
 
 /**
  * Layer ID 0 = Background, Layer ID 1 = Layer 1
  */
 auto XojPage::getSelectedLayerId() -> Layer::Index {
     if (this->currentLayer == npos) {
+        ensureLayersLoaded();
         this->currentLayer = this->layer.size();
     }
 
@@ -87,10 +133,12 @@ auto XojPage::getSelectedLayerId() -> Layer::Index {
 void XojPage::setLayerVisible(Layer::Index layerId, bool visible) {
     if (layerId == 0) {
         backgroundVisible = visible;
+        markChanged();
         return;
     }
 
     layerId--;
+    ensureLayersWritable();
     if (layerId >= this->layer.size()) {
         return;
     }
@@ -104,6 +152,7 @@ auto XojPage::isLayerVisible(Layer::Index layerId) const -> bool {
     }
 
     layerId--;
+    ensureLayersLoaded();
     if (layerId >= this->layer.size()) {
         return false;
     }
@@ -112,16 +161,21 @@ auto XojPage::isLayerVisible(Layer::Index layerId) const -> bool {
 }
 
 void XojPage::setBackgroundPdfPageNr(size_t page) {
+    markChanged();
     this->pdfBackgroundPage = page;
     this->bgType.format = PageTypeFormat::Pdf;
     this->bgType.config = "";
 }
 
-void XojPage::setBackgroundColor(Color color) { this->backgroundColor = color; }
+void XojPage::setBackgroundColor(Color color) {
+    markChanged();
+    this->backgroundColor = color;
+}
 
 auto XojPage::getBackgroundColor() const -> Color { return this->backgroundColor; }
 
 void XojPage::setSize(double width, double height) {
+    markChanged();
     this->width = width;
     this->height = height;
 }
@@ -133,6 +187,7 @@ auto XojPage::getHeight() const -> double { return this->height; }
 auto XojPage::getPdfPageNr() const -> size_t { return this->pdfBackgroundPage; }
 
 auto XojPage::isAnnotated() const -> bool {
+    ensureLayersLoaded();
     for (Layer* l: this->layer) {
         if (l->isAnnotated()) {
             return true;
@@ -142,6 +197,7 @@ auto XojPage::isAnnotated() const -> bool {
 }
 
 void XojPage::setBackgroundType(const PageType& bgType) {
+    markChanged();
     this->bgType = bgType;
 
     if (!bgType.isPdfPage()) {
@@ -154,12 +210,19 @@ void XojPage::setBackgroundType(const PageType& bgType) {
 
 auto XojPage::getBackgroundType() const -> PageType { return this->bgType; }
 
-auto XojPage::getBackgroundImage() -> BackgroundImage& { return this->backgroundImage; }
+auto XojPage::getBackgroundImage() -> BackgroundImage& {
+    markChanged();
+    return this->backgroundImage;
+}
 auto XojPage::getBackgroundImage() const -> const BackgroundImage& { return this->backgroundImage; }
 
-void XojPage::setBackgroundImage(BackgroundImage img) { this->backgroundImage = std::move(img); }
+void XojPage::setBackgroundImage(BackgroundImage img) {
+    markChanged();
+    this->backgroundImage = std::move(img);
+}
 
 auto XojPage::getSelectedLayer() -> Layer* {
+    ensureLayersWritable();
     xoj_assert(!layer.empty());
     size_t layer = getSelectedLayerId();
 
@@ -174,4 +237,77 @@ auto XojPage::getBackgroundName() const -> std::string { return backgroundName.v
 
 auto XojPage::backgroundHasName() const -> bool { return backgroundName.has_value(); }
 
-void XojPage::setBackgroundName(const std::string& newName) { backgroundName = newName; }
+void XojPage::setBackgroundName(const std::string& newName) {
+    markChanged();
+    backgroundName = newName;
+}
+
+void XojPage::setLayerLoader(LayerLoader loader) {
+    std::lock_guard lock(this->layerLoaderMutex);
+    for (Layer* l: this->layer) { delete l; }
+    this->layer.clear();
+    this->layerLoader = std::move(loader);
+    this->loadError.clear();
+    this->layersModified = false;
+    this->layersLoaded = false;
+    markChanged();
+}
+
+auto XojPage::unloadLayers() -> bool {
+    std::lock_guard lock(this->layerLoaderMutex);
+    if (!this->layerLoader || this->layersModified || !this->layersLoaded || !this->loadError.empty()) {
+        return false;
+    }
+
+    for (Layer* l: this->layer) { delete l; }
+    this->layer.clear();
+    this->layersLoaded = false;
+    return true;
+}
+
+auto XojPage::isLoaded() const -> bool { return this->layersLoaded; }
+
+auto XojPage::getLoadError() const -> std::string {
+    std::lock_guard lock(this->layerLoaderMutex);
+    return this->loadError;
+}
+
+void XojPage::markChanged() { this->revision++; }
+
+auto XojPage::getRevision() const -> size_t { return this->revision; }
+
+void XojPage::releaseImages() const {
+    // Unloaded layers have no images to release: do not parse them just for this
+    if (!this->layersLoaded) {
+        return;
+    }
+    for (const Layer* l: this->layer) {
+        for (const Element* e: l->getElementsView()) {
+            if (e->getType() == ELEMENT_IMAGE) {
+                static_cast<const Image*>(e)->releaseImage();
+            }
+        }
+    }
+}
+
+void XojPage::ensureLayersLoaded() const {
+    if (this->layersLoaded.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard lock(this->layerLoaderMutex);
+    if (!this->layersLoaded.load(std::memory_order_relaxed)) {
+        this->layer = this->layerLoader(this->loadError);
+        if (this->layer.empty()) {
+            // ensure at least one valid layer exists
+            this->layer.push_back(new Layer());
+        }
+        this->layersLoaded.store(true, std::memory_order_release);
+    }
+}
+
+void XojPage::ensureLayersWritable() {
+    ensureLayersLoaded();
+    this->layersModified = true;
+    markChanged();
+}
@@ -11,10 +11,13 @@
 
 #pragma once
 
-#include <cstddef>   // for size_t
-#include <optional>  // for optional
-#include <string>    // for string
-#include <vector>    // for vector
+#include <atomic>      // for atomic
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+#include <mutex>       // for mutex
+#include <optional>    // for optional
+#include <string>      // for string
+#include <vector>      // for vector
 
 #include "util/Color.h"  // for Color
 #include "util/PointerContainerView.h"
@@ -29,6 +32,10 @@ class XojPage: public PageHandler {
 public:
     XojPage(double width, double height, bool suppressLayerCreation = false);
     ~XojPage() override;
+    /**
+     * Copies the page and its layers. The layers are not copied, but created again by the layer loader of `page`, if
+     * they were not accessed for modification since it loaded them.
+     */
     XojPage(const XojPage& page);
     void operator=(const XojPage& p) = delete;
 
@@ -39,6 +46,10 @@ protected:
     void insertLayer(Layer* layer, Layer::Index index);
     void removeLayer(Layer* layer);
     void setLayerVisible(Layer::Index layerId, bool visible);
+    /**
+     * Replaces all the layers of the page, and takes ownership of `layers`. Any layer loader is dropped.
+     */
+    void setLayers(std::vector<Layer*> layers);
 
 public:
     // Also set the size over doc->setPageSize!
@@ -85,6 +96,62 @@ public:
      */
     XojPage* clone();
 
+    /**
+     * Creates the layers of a page whose contents are parsed on demand. Sets `error` if the layers could only be
+     * parsed partially.
+     */
+    using LayerLoader = std::function<std::vector<Layer*>(std::string& error)>;
+
+    /**
+     * Replaces the layers of the page: they will be created by `loader` when first accessed
+     */
+    void setLayerLoader(LayerLoader loader);
+
+    /**
+     * Frees the layers if they can be created again by the loader, i.e. if they were never accessed for modification.
+     * The document must be locked.
+     *
+     * @return true if the layers were freed
+     */
+    bool unloadLayers();
+
+    /**
+     * @return false if the layers are waiting for the loader to be created
+     */
+    bool isLoaded() const;
+
+    /**
+     * @return The error met by the loader, or an empty string. Such a page is damaged: it only holds the layers which
+     * could be parsed, which are kept instead of being parsed again.
+     */
+    std::string getLoadError() const;
+
+    /**
+     * Records that the page was modified. Called by the setters of the page and when its layers are accessed for
+     * modification; edits made later through a Layer pointer obtained before must call it too (as the undo actions do
+     * through Control::undoRedoPageChanged()).
+     */
+    void markChanged();
+
+    /**
+     * @return A number which changes whenever the page is modified (see Document::createSnapshot())
+     */
+    size_t getRevision() const;
+
+    /**
+     * Drops the decoded images of the page from the ImageCache, e.g. once the page is far from the viewport.
+     * The document must be locked.
+     */
+    void releaseImages() const;
+
+private:
+    void ensureLayersLoaded() const;
+
+    /**
+     * Loads the layers, and prevents them from being unloaded since they may be modified by the caller
+     */
+    void ensureLayersWritable();
+
 private:
     /**
      * The Background image if any
@@ -98,9 +165,27 @@ private:
     double height = 0;
 
     /**
-     * The layer list
+     * The layer list, empty until loaded if there is a layer loader
+     */
+    mutable std::vector<Layer*> layer;
+
+    /**
+     * Creates the layers on demand, if the page was loaded lazily
+     */
+    LayerLoader layerLoader;
+
+    /**
+     * Whether the layer list is available, and whether it may have been modified since it was loaded
+     */
+    mutable std::atomic<bool> layersLoaded = true;
+    bool layersModified = false;
+    mutable std::string loadError;
+    mutable std::mutex layerLoaderMutex;
+
+    /**
+     * Incremented by markChanged()
      */
-    std::vector<Layer*> layer;
+    std::atomic<size_t> revision = 0;
 
     /**
      * The current selected layer ID
@@ -21,7 +21,7 @@
 using xoj::util::Rectangle;
 
 ErasableStroke::ErasableStroke(const Stroke& stroke): stroke(stroke) {
-    const auto& pts = this->stroke.getPointVector();
+    auto pts = this->stroke.getPoints();
     closedStroke = pts.size() >= 3 && pts.front().lineLengthTo(pts.back()) < CLOSED_STROKE_DISTANCE;
 }
 
@@ -63,9 +63,9 @@ void ErasableStroke::beginErasure(const IntersectionParametersContainer& paddedI
         if (filled) {
             if (subsections.size() == 1) {
                 // We erased the stroke from its ends. Simply add the end points to ensure the filling is rerendered
-                const Point& p1 = this->stroke.getPointVector().front();
+                const Point& p1 = this->stroke.getPoints().front();
                 range.addPoint(p1.x, p1.y);
-                const Point& p2 = this->stroke.getPointVector().back();
+                const Point& p2 = this->stroke.getPoints().back();
                 range.addPoint(p2.x, p2.y);
             } else {
                 // The stroke was split in two or more (and possibly shrank). Need to rerender its entire box.
@@ -303,10 +303,20 @@ auto ErasableStroke::computeSubSectionBoundingBox(const SubSection& section) con
 
     Range rg = pointRange(this->stroke.getPoint(section.min));
 
-    auto data = this->stroke.getPointVector();
-    auto endIt = std::next(data.cbegin(), (std::ptrdiff_t)section.max.index + 1);
-    for (auto ptIt = std::next(data.cbegin(), (std::ptrdiff_t)section.min.index + 1); ptIt != endIt; ++ptIt) {
-        rg = rg.unite(pointRange(*ptIt));
+    auto data = this->stroke.getPoints();
+    const size_t first = section.min.index + 1;
+    const size_t last = section.max.index;
+    if (auto bounds = first <= last ? this->stroke.getIndexedBounds(first, last) : std::nullopt) {
+        // Slightly larger than the loop below: every point gets the padding of the largest pressure value
+        const double padding = hasPressure ? 0.5 * std::max(lastPressure, bounds->maxPressure) : halfWidth;
+        rg = rg.unite(Range(bounds->minX - padding, bounds->minY - padding, bounds->maxX + padding,
+                            bounds->maxY + padding));
+        lastPressure = data[last].z;
+    } else {
+        auto endIt = std::next(data.begin(), (std::ptrdiff_t)last + 1);
+        for (auto ptIt = std::next(data.begin(), (std::ptrdiff_t)first); ptIt != endIt; ++ptIt) {
+            rg = rg.unite(pointRange(*ptIt));
+        }
     }
 
     return rg.unite(pointRange(this->stroke.getPoint(section.max)));
@@ -3,6 +3,8 @@
  *
  * A stroke which is temporary used if you erase a part
  * This class remembers which sections of a stroke have not yet been erased, until the eraser sequence is concluded
+ * The sections are parameter ranges over the points of the original stroke, which are never copied nor modified
+ * during the erasure. Only getStrokes() copies points, those of the remaining sections.
  *
  * @author Xournal++ Team
  * https://github.com/xournalpp/xournalpp
@@ -68,7 +70,8 @@ public:
     /**
      * @brief Get the resulting strokes (if any) once the erasing is finished
      * @return A vector of pointers to newly created strokes (owned by the caller).
-     * The resulting strokes correspond to what's left of the original stroke
+     * The resulting strokes correspond to what's left of the original stroke. Their points are copied from it, with
+     * exactly sized vectors.
      */
     std::vector<std::unique_ptr<Stroke>> getStrokes() const;
 
@@ -107,6 +110,7 @@ protected:
 public:
     /**
      * @brief Reference to the stroke being erased
+     * It stays in its layer until the eraser sequence is concluded, and is then kept by the EraseUndoAction.
      */
     const Stroke& stroke;
 
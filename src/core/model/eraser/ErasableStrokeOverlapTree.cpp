@@ -58,22 +58,22 @@ void ErasableStroke::OverlapTree::Populator::populate(const SubSection& section,
             return;
         }
         if (section.min.t == 0.0) {
-            this->populateNode(root, section.min.index, section.max.index, this->stroke.getPointVector());
+            this->populateNode(root, section.min.index, section.max.index, this->stroke.getPoints());
             return;
         }
         this->populateNode(root, this->stroke.getPoint(section.min), section.min.index + 1, section.max.index,
-                           this->stroke.getPointVector());
+                           this->stroke.getPoints());
         return;
     }
 
     if (section.min.t == 0.0) {
         this->populateNode(root, section.min.index, section.max.index, this->stroke.getPoint(section.max),
-                           this->stroke.getPointVector());
+                           this->stroke.getPoints());
         return;
     }
 
     this->populateNode(root, this->stroke.getPoint(section.min), section.min.index + 1, section.max.index,
-                       this->stroke.getPoint(section.max), this->stroke.getPointVector());
+                       this->stroke.getPoint(section.max), this->stroke.getPoints());
 }
 
 auto ErasableStroke::OverlapTree::Populator::getNextFreeSlot() -> std::pair<Node, Node>* {
@@ -82,7 +82,7 @@ auto ErasableStroke::OverlapTree::Populator::getNextFreeSlot() -> std::pair<Node
 }
 
 void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, const Point& firstPoint, size_t min, size_t max,
-                                                          const Point& lastPoint, const std::vector<Point>& pts) {
+                                                          const Point& lastPoint, PointView pts) {
     xoj_assert(min <= max && max < pts.size());
     /**
      * Split in two in the middle
@@ -97,7 +97,7 @@ void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, const Poin
 }
 
 void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, const Point& firstPoint, size_t min, size_t max,
-                                                          const std::vector<Point>& pts) {
+                                                          PointView pts) {
     xoj_assert(min <= max && max < pts.size());
     if (min == max) {
         // The node corresponds to a single segment
@@ -118,7 +118,7 @@ void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, const Poin
 }
 
 void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, size_t min, size_t max, const Point& lastPoint,
-                                                          const std::vector<Point>& pts) {
+                                                          PointView pts) {
     xoj_assert(min <= max && max < pts.size());
     if (min == max) {
         // The node corresponds to a single segment
@@ -138,8 +138,7 @@ void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, size_t min
     node.computeBoxFromChildren();
 }
 
-void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, size_t min, size_t max,
-                                                          const std::vector<Point>& pts) {
+void ErasableStroke::OverlapTree::Populator::populateNode(Node& node, size_t min, size_t max, PointView pts) {
     xoj_assert(max > min);
     if (min + 1 == max) {
         // The node corresponds to a single segment
@@ -1,6 +1,7 @@
 #include "PopplerGlibDocument.h"
 
-#include <memory>    // for make_shared, unique_ptr
+#include <memory>    // for make_shared, unique_ptr, shared_ptr
+#include <mutex>     // for mutex
 #include <optional>  // for optional
 
 #include <poppler-document.h>  // for poppler_document_get_n_...
@@ -17,7 +18,8 @@ using std::string;
 
 PopplerGlibDocument::PopplerGlibDocument() = default;
 
-PopplerGlibDocument::PopplerGlibDocument(const PopplerGlibDocument& doc): document(doc.document) {
+PopplerGlibDocument::PopplerGlibDocument(const PopplerGlibDocument& doc):
+        document(doc.document), renderMutex(doc.renderMutex) {
     if (document) {
         g_object_ref(document);
     }
@@ -36,6 +38,7 @@ void PopplerGlibDocument::assign(XojPdfDocumentInterface* doc) {
     }
 
     document = (dynamic_cast<PopplerGlibDocument*>(doc))->document;
+    renderMutex = (dynamic_cast<PopplerGlibDocument*>(doc))->renderMutex;
     if (document) {
         g_object_ref(document);
     }
@@ -68,6 +71,8 @@ auto PopplerGlibDocument::load(fs::path const& file, string password, GError** e
         document = nullptr;
     }
 
+    // The copies of the previous document keep its mutex
+    this->renderMutex = std::make_shared<std::mutex>();
     this->document = poppler_document_new_from_file(uri->c_str(), password.c_str(), error);
     return this->document != nullptr;
 }
@@ -80,6 +85,7 @@ auto PopplerGlibDocument::load(std::unique_ptr<std::string> data, string passwor
     GBytes* bytes = g_bytes_new_with_free_func(
             data->data(), data->size(), [](gpointer d) { delete reinterpret_cast<std::string*>(d); }, data.get());
     data.release();  // the string will be deleted with the bytes object
+    this->renderMutex = std::make_shared<std::mutex>();
     this->document = poppler_document_new_from_bytes(bytes, password.c_str(), error);
     g_bytes_unref(bytes);  // a reference is now held by the document
 
@@ -101,7 +107,7 @@ auto PopplerGlibDocument::getPage(size_t page) const -> XojPdfPageSPtr {
     }
 
     PopplerPage* pg = poppler_document_get_page(document, int(page));
-    XojPdfPageSPtr pageptr = std::make_shared<PopplerGlibPage>(pg, document);
+    XojPdfPageSPtr pageptr = std::make_shared<PopplerGlibPage>(pg, document, renderMutex);
     g_object_unref(pg);
 
     return pageptr;
@@ -12,6 +12,8 @@
 #pragma once
 
 #include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr
+#include <mutex>    // for mutex
 #include <string>   // for string
 
 #include <glib.h>     // for GError, gpointer, gsize
@@ -47,4 +49,10 @@ public:
 
 private:
     PopplerDocument* document = nullptr;
+
+    /**
+     * Shared by the copies of the document and by its pages: poppler-glib does not support rendering the pages of a
+     * document from several threads at once
+     */
+    std::shared_ptr<std::mutex> renderMutex = std::make_shared<std::mutex>();
 };
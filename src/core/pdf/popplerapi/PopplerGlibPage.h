@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <memory>  // for shared_ptr
+#include <mutex>   // for mutex
 #include <string>  // for string
 #include <vector>  // for vector
 
@@ -22,7 +24,10 @@
 
 class PopplerGlibPage: public XojPdfPage {
 public:
-    PopplerGlibPage(PopplerPage* page, PopplerDocument* doc);
+    /**
+     * @param renderMutex Serializes the renderings of the pages of the document (see PopplerGlibDocument)
+     */
+    PopplerGlibPage(PopplerPage* page, PopplerDocument* doc, std::shared_ptr<std::mutex> renderMutex);
     PopplerGlibPage(const PopplerGlibPage& other);
     virtual ~PopplerGlibPage();
     PopplerGlibPage& operator=(const PopplerGlibPage& other);
@@ -51,4 +56,5 @@ public:
 private:
     PopplerPage* page;
     PopplerDocument* document;
+    std::shared_ptr<std::mutex> renderMutex;
 };
@@ -1735,7 +1735,7 @@ static int applib_getStrokes(lua_State* L) {
             // -1 = current stroke
 
             lua_newtable(L);  // create table of x-coordinates
-            for (auto p: s->getPointVector()) {
+            for (auto p: s->getPoints()) {
                 lua_pushinteger(L, ++currPointNo);  // key
                 lua_pushnumber(L, p.x);             // value
                 lua_settable(L, -3);                // insert
@@ -1744,7 +1744,7 @@ static int applib_getStrokes(lua_State* L) {
             currPointNo = 0;
 
             lua_newtable(L);  // create table for y-coordinates
-            for (auto p: s->getPointVector()) {
+            for (auto p: s->getPoints()) {
                 lua_pushinteger(L, ++currPointNo);  // key
                 lua_pushnumber(L, p.y);             // value
                 lua_settable(L, -3);                // insert
@@ -1754,7 +1754,7 @@ static int applib_getStrokes(lua_State* L) {
 
             if (s->hasPressure()) {
                 lua_newtable(L);  // create table for pressures
-                for (auto p: s->getPointVector()) {
+                for (auto p: s->getPoints()) {
                     lua_pushinteger(L, ++currPointNo);  // key
                     lua_pushnumber(L, p.z);             // value
                     lua_settable(L, -3);                // insert
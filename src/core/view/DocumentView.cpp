@@ -19,6 +19,12 @@
  */
 void DocumentView::setMarkAudioStroke(bool markAudioStroke) { this->markAudioStroke = markAudioStroke; }
 
+void DocumentView::setDraftQuality(bool draftQuality) { this->draftQuality = draftQuality; }
+
+void DocumentView::setRenderGeneration(xoj::view::RenderGeneration renderGeneration) {
+    this->renderGeneration = renderGeneration;
+}
+
 void DocumentView::setPdfCache(PdfCache* cache) { pdfCache = cache; }
 
 /**
@@ -62,26 +68,46 @@ void DocumentView::finializeDrawing() {
  * Draw the background
  */
 void DocumentView::drawBackground(xoj::view::BackgroundFlags bgFlags) const {
-    auto bgView = xoj::view::BackgroundView::createForPage(page, bgFlags, pdfCache);
-    bgView->draw(cr);
+    if (auto bgView = createBackgroundView(page, bgFlags); bgView) {
+        bgView->draw(cr);
+    }
+}
+
+auto DocumentView::createBackgroundView(ConstPageRef page, xoj::view::BackgroundFlags bgFlags) const
+        -> std::unique_ptr<xoj::view::BackgroundView> {
+    if (this->draftQuality) {
+        bgFlags.pdfQuality = xoj::view::DRAFT_PDF_QUALITY;
+    }
+    return xoj::view::BackgroundView::createForPage(page, bgFlags, pdfCache);
 }
 
 void DocumentView::drawPage(ConstPageRef page, cairo_t* cr, bool dontRenderEditingStroke,
                             xoj::view::BackgroundFlags flags) {
     initDrawing(page, cr, dontRenderEditingStroke);
-
     drawBackground(flags);
+    drawLayers();
+    finializeDrawing();
+}
+
+void DocumentView::drawPageWithoutBackground(ConstPageRef page, cairo_t* cr, bool dontRenderEditingStroke) {
+    initDrawing(page, cr, dontRenderEditingStroke);
+    drawLayers();
+    finializeDrawing();
+}
 
+void DocumentView::drawLayers() {
     xoj::view::Context context{cr, (xoj::view::NonAudioTreatment)this->markAudioStroke,
-                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR};
+                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR,
+                               (xoj::view::QualityTreatment)this->draftQuality, this->renderGeneration};
     for (const Layer* layer: page->getLayersView()) {
+        if (this->renderGeneration.isCancelled()) {
+            break;
+        }
         if (layer->isVisible()) {
             xoj::view::LayerView layerView(layer);
             layerView.draw(context);
         }
     }
-
-    finializeDrawing();
 }
 
 
@@ -105,8 +131,12 @@ void DocumentView::drawLayersOfPage(const LayerRangeVector& layerRange, ConstPag
     }
 
     xoj::view::Context context{cr, (xoj::view::NonAudioTreatment)this->markAudioStroke,
-                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR};
+                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR,
+                               (xoj::view::QualityTreatment)this->draftQuality, this->renderGeneration};
     for (auto&& [_, l]: visibleLayers) {
+        if (this->renderGeneration.isCancelled()) {
+            break;
+        }
         xoj::view::LayerView layerView(l);
         layerView.draw(context);
     }
@@ -11,16 +11,20 @@
 
 #pragma once
 
+#include <memory>  // for unique_ptr
+
 #include <cairo.h>  // for cairo_t
 
-#include "model/PageRef.h"  // for ConstPageRef
-#include "util/ElementRange.h"
-#include "view/background/BackgroundFlags.h"
+#include "model/PageRef.h"                    // for ConstPageRef
+#include "util/ElementRange.h"                // for LayerRangeVector
+#include "view/View.h"                        // for RenderGeneration
+#include "view/background/BackgroundFlags.h"  // for BackgroundFlags
 
 class PdfCache;
 
 namespace xoj::view {
 struct BackgroundFlags;
+class BackgroundView;
 };
 
 class DocumentView {
@@ -39,6 +43,19 @@ public:
     void drawPage(ConstPageRef page, cairo_t* cr, bool dontRenderEditingStroke,
                   xoj::view::BackgroundFlags flags = xoj::view::BACKGROUND_SHOW_ALL);
 
+    /**
+     * Same as drawPage(), except for the background, which is drawn beforehand (see createBackgroundView())
+     */
+    void drawPageWithoutBackground(ConstPageRef page, cairo_t* cr, bool dontRenderEditingStroke);
+
+    /**
+     * Create the view of the background of the page. It copies what it needs from the page, so that it can be drawn
+     * without the document being locked, e.g. while the layers of other pages are drawn.
+     * @return The view, or nullptr if the background type is unknown
+     */
+    std::unique_ptr<xoj::view::BackgroundView> createBackgroundView(ConstPageRef page,
+                                                                    xoj::view::BackgroundFlags bgFlags) const;
+
     /**
      * Only draws the prescribed layers of the given page, regardless of the layer's current visibility.
      * @param layerRange Range of layers to draw
@@ -56,6 +73,17 @@ public:
      */
     void setMarkAudioStroke(bool markAudioStroke);
 
+    /**
+     * Draw a quick approximation of the page, e.g. while zooming
+     */
+    void setDraftQuality(bool draftQuality);
+
+    /**
+     * Stop drawing (between layers and between batches of elements) once the generation is outdated. The result is
+     * then incomplete and must be discarded.
+     */
+    void setRenderGeneration(xoj::view::RenderGeneration renderGeneration);
+
     // API for special drawing, usually you won't call this methods
 public:
     void setPdfCache(PdfCache* cache);
@@ -83,11 +111,16 @@ public:
      */
     void finializeDrawing();
 
+private:
+    void drawLayers();
+
 private:
     cairo_t* cr = nullptr;
     ConstPageRef page = nullptr;
     PdfCache* pdfCache = nullptr;
     bool dontRenderEditingStroke = false;
     bool markAudioStroke = false;
+    bool draftQuality = false;
+    xoj::view::RenderGeneration renderGeneration;
 
 };
@@ -9,6 +9,7 @@
 #include "model/LineStyle.h"              // for LineStyle
 #include "model/PathParameter.h"          // for PathParameter
 #include "model/Point.h"                  // for Point
+#include "model/PointView.h"              // for PointView
 #include "model/Stroke.h"                 // for Stroke, StrokeTool::HIGHLIG...
 #include "model/eraser/ErasableStroke.h"  // for ErasableStroke, ErasableStr...
 #include "util/Assert.h"                  // for xoj_assert
@@ -37,7 +38,7 @@ void ErasableStrokeView::draw(cairo_t* cr) const {
 
     const auto& dashes = stroke.getLineStyle().getDashes();
 
-    const std::vector<Point>& data = stroke.getPointVector();
+    PointView data = stroke.getPoints();
 
     xoj::util::CairoSaveGuard guard(cr);
 
@@ -50,8 +51,8 @@ void ErasableStrokeView::draw(cairo_t* cr) const {
 
             const Point* lastPoint = &p;
 
-            auto endIt = std::next(data.cbegin(), (std::ptrdiff_t)interval.max.index + 1);
-            for (auto it = std::next(data.cbegin(), (std::ptrdiff_t)interval.min.index + 1); it != endIt; ++it) {
+            auto endIt = std::next(data.begin(), (std::ptrdiff_t)interval.max.index + 1);
+            for (auto it = std::next(data.begin(), (std::ptrdiff_t)interval.min.index + 1); it != endIt; ++it) {
                 if (!dashes.empty()) {
                     Util::cairo_set_dash_from_vector(cr, dashes, dashOffset);
                     dashOffset += lastPoint->lineLengthTo(*it);
@@ -92,12 +93,12 @@ void ErasableStrokeView::draw(cairo_t* cr) const {
             Point p = stroke.getPoint(last.min);
             cairo_move_to(cr, p.x, p.y);
 
-            auto endIt = data.cend();
-            for (auto it = std::next(data.cbegin(), (std::ptrdiff_t)last.min.index + 1); it != endIt; ++it) {
+            auto endIt = data.end();
+            for (auto it = std::next(data.begin(), (std::ptrdiff_t)last.min.index + 1); it != endIt; ++it) {
                 cairo_line_to(cr, it->x, it->y);
             }
-            endIt = std::next(data.cbegin(), (std::ptrdiff_t)first.max.index + 1);
-            for (auto it = data.cbegin(); it != endIt; ++it) { cairo_line_to(cr, it->x, it->y); }
+            endIt = std::next(data.begin(), (std::ptrdiff_t)first.max.index + 1);
+            for (auto it = data.begin(); it != endIt; ++it) { cairo_line_to(cr, it->x, it->y); }
 
             Point q = stroke.getPoint(first.max);
             cairo_line_to(cr, q.x, q.y);
@@ -112,8 +113,8 @@ void ErasableStrokeView::draw(cairo_t* cr) const {
             Point p = stroke.getPoint(sectionIt->min);
             cairo_move_to(cr, p.x, p.y);
 
-            auto endIt = std::next(data.cbegin(), (std::ptrdiff_t)sectionIt->max.index + 1);
-            for (auto it = std::next(data.cbegin(), (std::ptrdiff_t)sectionIt->min.index + 1); it != endIt; ++it) {
+            auto endIt = std::next(data.begin(), (std::ptrdiff_t)sectionIt->max.index + 1);
+            for (auto it = std::next(data.begin(), (std::ptrdiff_t)sectionIt->min.index + 1); it != endIt; ++it) {
                 cairo_line_to(cr, it->x, it->y);
             }
 
@@ -147,7 +148,7 @@ void ErasableStrokeView::drawFilling(cairo_t* cr) const {
     }
 
     const Stroke& stroke = this->erasableStroke.stroke;
-    const std::vector<Point>& data = stroke.getPointVector();
+    PointView data = stroke.getPoints();
 
     bool mergeFirstAndLast = this->erasableStroke.isClosedStroke() && sections.size() >= 2 &&
                              sections.front().min == PathParameter(0, 0.0) &&
@@ -165,12 +166,12 @@ void ErasableStrokeView::drawFilling(cairo_t* cr) const {
         Point p = stroke.getPoint(last.min);
         cairo_move_to(cr, p.x, p.y);
 
-        auto endIt = data.cend();
-        for (auto it = std::next(data.cbegin(), (std::ptrdiff_t)last.min.index + 1); it != endIt; ++it) {
+        auto endIt = data.end();
+        for (auto it = std::next(data.begin(), (std::ptrdiff_t)last.min.index + 1); it != endIt; ++it) {
             cairo_line_to(cr, it->x, it->y);
         }
-        endIt = std::next(data.cbegin(), (std::ptrdiff_t)first.max.index + 1);
-        for (auto it = data.cbegin(); it != endIt; ++it) { cairo_line_to(cr, it->x, it->y); }
+        endIt = std::next(data.begin(), (std::ptrdiff_t)first.max.index + 1);
+        for (auto it = data.begin(); it != endIt; ++it) { cairo_line_to(cr, it->x, it->y); }
 
         Point q = stroke.getPoint(first.max);
         cairo_line_to(cr, q.x, q.y);
@@ -185,8 +186,8 @@ void ErasableStrokeView::drawFilling(cairo_t* cr) const {
         Point p = stroke.getPoint(sectionIt->min);
         cairo_move_to(cr, p.x, p.y);
 
-        auto endIt = std::next(data.cbegin(), (std::ptrdiff_t)sectionIt->max.index + 1);
-        for (auto it = std::next(data.cbegin(), (std::ptrdiff_t)sectionIt->min.index + 1); it != endIt; ++it) {
+        auto endIt = std::next(data.begin(), (std::ptrdiff_t)sectionIt->max.index + 1);
+        for (auto it = std::next(data.begin(), (std::ptrdiff_t)sectionIt->min.index + 1); it != endIt; ++it) {
             cairo_line_to(cr, it->x, it->y);
         }
 
@@ -222,7 +223,7 @@ void ErasableStrokeView::paintFilledHighlighter(cairo_t* cr) const {
     cairo_set_operator(cr, CAIRO_OPERATOR_MULTIPLY);
     Util::cairo_set_source_rgbi(cr, stroke.getColor(), static_cast<double>(stroke.getFill()) / 255.0);
 
-    const std::vector<Point>& data = stroke.getPointVector();
+    PointView data = stroke.getPoints();
 
     bool mergeFirstAndLast = erasableStroke.isClosedStroke() && sections.size() >= 2 &&
                              sections.front().min == PathParameter(0, 0.0) &&
@@ -251,12 +252,12 @@ void ErasableStrokeView::paintFilledHighlighter(cairo_t* cr) const {
         Point p = stroke.getPoint(last.min);
         cairo_move_to(crMask, p.x, p.y);
 
-        auto endIt = data.cend();
-        for (auto it = std::next(data.cbegin(), (std::ptrdiff_t)last.min.index + 1); it != endIt; ++it) {
+        auto endIt = data.end();
+        for (auto it = std::next(data.begin(), (std::ptrdiff_t)last.min.index + 1); it != endIt; ++it) {
             cairo_line_to(crMask, it->x, it->y);
         }
-        endIt = std::next(data.cbegin(), (std::ptrdiff_t)first.max.index + 1);
-        for (auto it = data.cbegin(); it != endIt; ++it) { cairo_line_to(crMask, it->x, it->y); }
+        endIt = std::next(data.begin(), (std::ptrdiff_t)first.max.index + 1);
+        for (auto it = data.begin(); it != endIt; ++it) { cairo_line_to(crMask, it->x, it->y); }
 
         Point q = stroke.getPoint(first.max);
         cairo_line_to(crMask, q.x, q.y);
@@ -281,8 +282,8 @@ void ErasableStrokeView::paintFilledHighlighter(cairo_t* cr) const {
         Point p = stroke.getPoint(sectionIt->min);
         cairo_move_to(crMask, p.x, p.y);
 
-        auto endIt = std::next(data.cbegin(), (std::ptrdiff_t)sectionIt->max.index + 1);
-        for (auto it = std::next(data.cbegin(), (std::ptrdiff_t)sectionIt->min.index + 1); it != endIt; ++it) {
+        auto endIt = std::next(data.begin(), (std::ptrdiff_t)sectionIt->max.index + 1);
+        for (auto it = std::next(data.begin(), (std::ptrdiff_t)sectionIt->min.index + 1); it != endIt; ++it) {
             cairo_line_to(crMask, it->x, it->y);
         }
 
@@ -2,8 +2,9 @@
 
 #include <cairo.h>  // for cairo_image_surface_get_height, cairo_image...
 
-#include "model/Image.h"  // for Image
-#include "view/View.h"    // for Context, OPACITY_NO_AUDIO, view
+#include "model/Image.h"                // for Image
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+#include "view/View.h"                // for Context, OPACITY_NO_AUDIO, view
 
 using namespace xoj::view;
 
@@ -16,7 +17,9 @@ void ImageView::draw(const Context& ctx) const {
 
     cairo_save(cr);
 
-    cairo_surface_t* img = image->getImage();
+    // Keep a reference: the cache may drop the surface meanwhile
+    xoj::util::CairoSurfaceSPtr surface = image->getImage();
+    cairo_surface_t* img = surface.get();
     int width = cairo_image_surface_get_width(img);
     int height = cairo_image_surface_get_height(img);
 
@@ -1,18 +1,23 @@
 #include "LayerView.h"
 
-#include <memory>  // for unique_ptr
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
 
 #include <cairo.h>  // for cairo_clip_extents, cairo_rectangle
 #include <glib.h>   // for g_message
 
-#include "model/Element.h"  // for Element
-#include "model/Layer.h"    // for Layer
+#include "model/Element.h"   // for Element
+#include "model/Layer.h"     // for Layer
+#include "util/Rectangle.h"  // for Rectangle
 
 #include "DebugShowRepaintBounds.h"  // for IF_DEBUG_REPAINT
 #include "View.h"                    // for Context, ElementView
 
 using namespace xoj::view;
 
+/// Number of elements drawn between two checks of the cancellation of the rendering
+constexpr size_t CANCELLATION_CHECK_INTERVAL = 64;
+
 LayerView::LayerView(const Layer* layer): layer(layer) {}
 
 const Layer* LayerView::getLayer() const { return layer; }
@@ -27,7 +32,12 @@ void LayerView::draw(const Context& ctx) const {
     double maxY;
     cairo_clip_extents(ctx.cr, &minX, &minY, &maxX, &maxY);
 
-    for (auto const& e: layer->getElementsView()) {
+    const xoj::util::Rectangle<double> area(minX, minY, maxX - minX, maxY - minY);
+    size_t count = 0;
+    for (const Element* e: layer->getElementsInArea(area)) {
+        if (++count % CANCELLATION_CHECK_INTERVAL == 0 && ctx.renderGeneration.isCancelled()) {
+            return;
+        }
 
         IF_DEBUG_REPAINT({
             auto cr = ctx.cr;
@@ -6,6 +6,7 @@
 
 #include "util/Assert.h"
 #include "util/Range.h"
+#include "util/Rectangle.h"
 #include "util/safe_casts.h"  // for ceil_cast, floor_cast
 
 #include "config-debug.h"
@@ -22,14 +23,33 @@ std::string getSurfaceTypeName(cairo_surface_t*);
 #define IF_DBG_MASKS(f)
 #endif
 
+static void assertValidExtent([[maybe_unused]] const Range& extent, [[maybe_unused]] double zoom) {
+    xoj_assert_message(extent.isValid(), std::string("Invalid range in Mask(): X  ") + std::to_string(extent.minX) +
+                                                 " -- " + std::to_string(extent.maxX) +
+                                                 "\n                             Y  " + std::to_string(extent.minY) +
+                                                 " -- " + std::to_string(extent.maxY));
+    xoj_assert(zoom > 0.0);
+}
+
 Mask::Mask(cairo_surface_t* target, const Range& extent, double zoom, cairo_content_t contentType):
         xOffset(floor_cast<int>(extent.minX * zoom)), yOffset(floor_cast<int>(extent.minY * zoom)), zoom(zoom) {
-    constructorImpl(target, extent, zoom, contentType);
+    assertValidExtent(extent, zoom);
+    constructorImpl(target, ceil_cast<int>(extent.maxX * zoom) - xOffset, ceil_cast<int>(extent.maxY * zoom) - yOffset,
+                    contentType);
 }
 
 Mask::Mask(int DPIScaling, const Range& extent, double zoom, cairo_content_t contentType):
         xOffset(floor_cast<int>(extent.minX * zoom)), yOffset(floor_cast<int>(extent.minY * zoom)), zoom(zoom) {
-    constructorImpl(DPIScaling, extent, zoom, contentType);
+    assertValidExtent(extent, zoom);
+    constructorImpl(DPIScaling, ceil_cast<int>(extent.maxX * zoom) - xOffset,
+                    ceil_cast<int>(extent.maxY * zoom) - yOffset, contentType);
+}
+
+Mask::Mask(int DPIScaling, const xoj::util::Rectangle<int>& deviceExtent, double zoom, cairo_content_t contentType):
+        xOffset(deviceExtent.x), yOffset(deviceExtent.y), zoom(zoom) {
+    xoj_assert(deviceExtent.width > 0 && deviceExtent.height > 0);
+    xoj_assert(zoom > 0.0);
+    constructorImpl(DPIScaling, deviceExtent.width, deviceExtent.height, contentType);
 }
 
 template <typename DPIInfoType>
@@ -55,16 +75,8 @@ public:
 };
 
 template <typename DPIInfoType>
-void Mask::constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom, cairo_content_t contentType) {
+void Mask::constructorImpl(DPIInfoType dpiInfo, int width, int height, cairo_content_t contentType) {
     xoj_assert(dpiInfo);
-    xoj_assert_message(extent.isValid(), std::string("Invalid range in Mask(): X  ") + std::to_string(extent.minX) +
-                                                 " -- " + std::to_string(extent.maxX) +
-                                                 "\n                             Y  " + std::to_string(extent.minY) +
-                                                 " -- " + std::to_string(extent.maxY));
-    xoj_assert(zoom > 0.0);
-
-    const int width = ceil_cast<int>(extent.maxX * zoom) - xOffset;
-    const int height = ceil_cast<int>(extent.maxY * zoom) - yOffset;
 
     /*
      * Create the most suitable kind of surface.
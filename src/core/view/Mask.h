@@ -17,6 +17,10 @@
 #include "util/raii/CairoWrappers.h"
 
 class Range;
+namespace xoj::util {
+template <class T>
+class Rectangle;
+}  // namespace xoj::util
 
 namespace xoj::view {
 
@@ -47,6 +51,16 @@ public:
      */
     Mask(int DPIScaling, const Range& extent, double zoom, cairo_content_t contentType = CAIRO_CONTENT_ALPHA);
 
+    /**
+     * @brief Create a mask covering a rectangle of device pixels
+     * @param DPIScaling The DPI scaling of the targeted use monitor
+     * @param deviceExtent The extent of the mask, in device coordinates (i.e. local coordinates multiplied by the zoom)
+     * @param zoom The local zoom ratio (zoom ratio of the cairo context(s) on which the mask will be used).
+     * @param contentType The intended content of the mask
+     */
+    Mask(int DPIScaling, const xoj::util::Rectangle<int>& deviceExtent, double zoom,
+         cairo_content_t contentType = CAIRO_CONTENT_ALPHA);
+
     cairo_t* get();
     bool isInitialized() const;
     /**
@@ -81,7 +95,7 @@ public:
 
 private:
     template <typename DPIInfoType>
-    void constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom, cairo_content_t contentType);
+    void constructorImpl(DPIInfoType dpiInfo, int width, int height, cairo_content_t contentType);
 
     xoj::util::CairoSPtr cr;
     int xOffset = 0;
@@ -100,7 +100,7 @@ void StrokeView::draw(const Context& ctx) const {
             ErasableStrokeView erasableStrokeView(*erasable);
             erasableStrokeView.drawFilling(cr);
         } else {
-            StrokeViewHelper::pathToCairo(cr, s->getPointVector());
+            StrokeViewHelper::pathToCairo(cr, s->getPoints());
             cairo_fill(cr);
         }
     }
@@ -132,10 +132,10 @@ void StrokeView::draw(const Context& ctx) const {
         // don't render erasable for previews
         ErasableStrokeView erasableStrokeView(*erasable);
         erasableStrokeView.draw(cr);
-    } else if (s->hasPressure() && !highlighter) {
-        StrokeViewHelper::drawWithPressure(cr, s->getPointVector(), s->getLineStyle());
+    } else if (s->hasPressure() && !highlighter && ctx.quality == FULL_QUALITY) {
+        StrokeViewHelper::drawWithPressure(cr, *s);
     } else {
-        StrokeViewHelper::drawNoPressure(cr, s->getPointVector(), s->getWidth(), s->getLineStyle());
+        StrokeViewHelper::drawNoPressure(cr, s->getPoints(), s->getWidth(), s->getLineStyle());
     }
 
     if (useMask) {
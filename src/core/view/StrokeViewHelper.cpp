@@ -2,13 +2,14 @@
 
 #include "model/LineStyle.h"
 #include "model/Point.h"
+#include "model/Stroke.h"
 #include "model/StrokeContour.h"
+#include "model/StrokeContourCache.h"
 #include "util/Assert.h"
 #include "util/LoopUtil.h"
-#include "util/PairView.h"
 #include "util/Util.h"  // for cairo_set_dash_from_vector
 
-void xoj::view::StrokeViewHelper::pathToCairo(cairo_t* cr, const std::vector<Point>& pts) {
+void xoj::view::StrokeViewHelper::pathToCairo(cairo_t* cr, PointView pts) {
     for_first_then_each(
             pts, [cr](auto const& first) { cairo_move_to(cr, first.x, first.y); },
             [cr](auto const& other) { cairo_line_to(cr, other.x, other.y); });
@@ -17,7 +18,7 @@ void xoj::view::StrokeViewHelper::pathToCairo(cairo_t* cr, const std::vector<Poi
 /**
  * No pressure sensitivity, one line is drawn
  */
-void xoj::view::StrokeViewHelper::drawNoPressure(cairo_t* cr, const std::vector<Point>& pts, const double strokeWidth,
+void xoj::view::StrokeViewHelper::drawNoPressure(cairo_t* cr, PointView pts, const double strokeWidth,
                                                  const LineStyle& lineStyle, double dashOffset) {
     cairo_set_line_width(cr, strokeWidth);
 
@@ -31,8 +32,8 @@ void xoj::view::StrokeViewHelper::drawNoPressure(cairo_t* cr, const std::vector<
 /**
  * Draw a stroke with pressure, for this multiple lines with different widths needs to be drawn
  */
-double xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, const std::vector<Point>& pts,
-                                                     const LineStyle& lineStyle, double dashOffset) {
+double xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, PointView pts, const LineStyle& lineStyle,
+                                                     double dashOffset) {
     const auto& dashes = lineStyle.getDashes();
     if (cairo_surface_get_type(cairo_get_target(cr)) == CAIRO_SURFACE_TYPE_PDF) {
         // PDF documents have an equivalent of cairo_stroke(). We use it to get smaller PDF files
@@ -47,16 +48,18 @@ double xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, const std::vec
             /*
              * Because the width varies, we need to call cairo_stroke() once per segment
              */
-            for (const auto& [p, q]: PairView(pts)) {
+            for (size_t i = 1; i < pts.size(); i++) {
+                const Point p = pts[i - 1];
+                const Point q = pts[i];
                 Util::cairo_set_dash_from_vector(cr, dashes, dashOffset);
                 dashOffset += p.lineLengthTo(q);
                 drawSegment(p, q);
             }
         } else {
             cairo_set_dash(cr, nullptr, 0, 0.0);
-            for (const auto& [p, q]: PairView(pts)) {
-                drawSegment(p, q);
-            };
+            for (size_t i = 1; i < pts.size(); i++) {
+                drawSegment(pts[i - 1], pts[i]);
+            }
         }
     } else {
         if (!dashes.empty()) {
@@ -68,3 +71,14 @@ double xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, const std::vec
     }
     return dashOffset;
 }
+
+void xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, const Stroke& s) {
+    if (cairo_surface_get_type(cairo_get_target(cr)) != CAIRO_SURFACE_TYPE_PDF) {
+        if (auto contour = StrokeContourCache::instance().get(s); contour) {
+            contour->addToCairo(cr);
+            cairo_fill(cr);
+            return;
+        }
+    }
+    drawWithPressure(cr, s.getPoints(), s.getLineStyle());
+}
@@ -11,24 +11,24 @@
 
 #pragma once
 
-#include <vector>
-
 #include <cairo.h>
 
+#include "model/PointView.h"
+
 class LineStyle;
-class Point;
+class Stroke;
 
 namespace xoj::view::StrokeViewHelper {
 
 /**
  * @brief Simply adds the points to a cairo context, as a single path
  */
-void pathToCairo(cairo_t* cr, const std::vector<Point>& pts);
+void pathToCairo(cairo_t* cr, PointView pts);
 
 /**
  * @brief No pressure sensitivity, one line is drawn, with given width and line style (dashes)
  */
-void drawNoPressure(cairo_t* cr, const std::vector<Point>& pts, const double strokeWidth, const LineStyle& lineStyle,
+void drawNoPressure(cairo_t* cr, PointView pts, const double strokeWidth, const LineStyle& lineStyle,
                     double dashOffset = 0);
 
 /**
@@ -36,5 +36,10 @@ void drawNoPressure(cairo_t* cr, const std::vector<Point>& pts, const double str
  * @return New dash offset, if one wants to keep on drawing the same stroke.
  *      Effectively, the return value equals dashOffset + length of the path.
  */
-double drawWithPressure(cairo_t* cr, const std::vector<Point>& pts, const LineStyle& lineStyle, double dashOffset = 0);
+double drawWithPressure(cairo_t* cr, PointView pts, const LineStyle& lineStyle, double dashOffset = 0);
+
+/**
+ * @brief Draw a stroke with pressure, reusing its cached contour (see StrokeContourCache) when possible.
+ */
+void drawWithPressure(cairo_t* cr, const Stroke& s);
 };  // namespace xoj::view::StrokeViewHelper
@@ -0,0 +1,142 @@
+#include "TileCache.h"
+
+#include <functional>  // for hash
+#include <utility>     // for move
+
+#include "util/Rectangle.h"   // for Rectangle
+#include "util/safe_casts.h"  // for floor_cast, ceil_cast
+
+using namespace xoj::view;
+
+Tile::Tile(int DPIScaling, int x, int y, double zoom):
+        mask(DPIScaling,
+             xoj::util::Rectangle<int>(x * TileCache::TILE_SIZE, y * TileCache::TILE_SIZE, TileCache::TILE_SIZE,
+                                       TileCache::TILE_SIZE),
+             zoom, CAIRO_CONTENT_COLOR_ALPHA),
+        x(x),
+        y(y) {}
+
+auto Tile::get() -> cairo_t* { return mask.get(); }
+
+void Tile::paintTo(cairo_t* targetCr) const {
+    xoj::util::CairoSaveGuard saveGuard(targetCr);
+    Range extent = getExtent();
+    cairo_rectangle(targetCr, extent.minX, extent.minY, extent.getWidth(), extent.getHeight());
+    cairo_clip(targetCr);
+    mask.paintTo(targetCr);
+}
+
+auto Tile::getExtent() const -> Range { return TileCache::getTileExtent(x, y, mask.getZoom()); }
+
+auto Tile::getSize() const -> size_t {
+    cairo_surface_t* surface = cairo_get_target(const_cast<Mask&>(mask).get());
+    return static_cast<size_t>(cairo_image_surface_get_stride(surface)) *
+           static_cast<size_t>(cairo_image_surface_get_height(surface));
+}
+
+auto Tile::getZoom() const -> double { return mask.getZoom(); }
+
+auto TileCache::getTileRange(const Range& area, double zoom) -> TileRange {
+    if (!area.isValid()) {
+        return {};
+    }
+    return {floor_cast<int>(area.minX * zoom / TILE_SIZE), floor_cast<int>(area.minY * zoom / TILE_SIZE),
+            (ceil_cast<int>(area.maxX * zoom) - 1) / TILE_SIZE, (ceil_cast<int>(area.maxY * zoom) - 1) / TILE_SIZE};
+}
+
+auto TileCache::getTileExtent(int x, int y, double zoom) -> Range {
+    return Range(x * TILE_SIZE / zoom, y * TILE_SIZE / zoom, (x + 1) * TILE_SIZE / zoom, (y + 1) * TILE_SIZE / zoom);
+}
+
+auto TileCache::instance() -> TileCache& {
+    static TileCache cache;
+    return cache;
+}
+
+auto TileCache::lookup(const Key& key) -> std::shared_ptr<Tile> {
+    std::lock_guard lock(this->mutex);
+    auto it = this->index.find(key);
+    if (it == this->index.end()) {
+        return nullptr;
+    }
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return it->second->second;
+}
+
+void TileCache::cache(const Key& key, std::shared_ptr<Tile> tile) {
+    std::lock_guard lock(this->mutex);
+    if (auto it = this->index.find(key); it != this->index.end()) {
+        this->size -= it->second->second->getSize();
+        this->entries.erase(it->second);
+        this->index.erase(it);
+    }
+
+    size_t tileSize = tile->getSize();
+    shrinkTo(this->maxSize > tileSize ? this->maxSize - tileSize : 0);
+
+    this->entries.emplace_front(key, std::move(tile));
+    this->index.emplace(key, this->entries.begin());
+    this->size += tileSize;
+}
+
+auto TileCache::getTiles(const void* owner) const -> std::vector<std::pair<Key, std::shared_ptr<Tile>>> {
+    std::lock_guard lock(this->mutex);
+    std::vector<std::pair<Key, std::shared_ptr<Tile>>> tiles;
+    for (const auto& entry: this->entries) {
+        if (entry.first.owner == owner) {
+            tiles.push_back(entry);
+        }
+    }
+    return tiles;
+}
+
+auto TileCache::hasTiles(const void* owner) const -> bool {
+    std::lock_guard lock(this->mutex);
+    for (const auto& entry: this->entries) {
+        if (entry.first.owner == owner) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TileCache::evict(const void* owner) {
+    std::lock_guard lock(this->mutex);
+    for (auto it = this->entries.begin(); it != this->entries.end();) {
+        if (it->first.owner == owner) {
+            this->size -= it->second->getSize();
+            this->index.erase(it->first);
+            it = this->entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void TileCache::setMaxSize(size_t maxSize) {
+    std::lock_guard lock(this->mutex);
+    this->maxSize = maxSize;
+    shrinkTo(maxSize);
+}
+
+auto TileCache::getSize() const -> size_t {
+    std::lock_guard lock(this->mutex);
+    return this->size;
+}
+
+void TileCache::shrinkTo(size_t size) {
+    while (this->size > size && !this->entries.empty()) {
+        auto& [key, tile] = this->entries.back();
+        this->size -= tile->getSize();
+        this->index.erase(key);
+        this->entries.pop_back();
+    }
+}
+
+auto TileCache::KeyHash::operator()(const Key& key) const -> size_t {
+    size_t h = std::hash<const void*>{}(key.owner);
+    h = h * 31 + std::hash<double>{}(key.zoom);
+    h = h * 31 + std::hash<int>{}(key.dpiScaling);
+    h = h * 31 + std::hash<int>{}(key.x);
+    return h * 31 + std::hash<int>{}(key.y);
+}
@@ -0,0 +1,173 @@
+/*
+ * Xournal++
+ *
+ * Caches the rendered tiles of the pages
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <list>           // for list
+#include <memory>         // for shared_ptr
+#include <mutex>          // for mutex
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+#include <vector>         // for vector
+
+#include <cairo.h>  // for cairo_t
+
+#include "util/Range.h"  // for Range
+
+#include "Mask.h"  // for Mask
+
+namespace xoj::view {
+
+/**
+ * Square part of a rendered page, at a given zoom level.
+ *
+ * The tiles of a page are only drawn on or painted with the page's drawing mutex held.
+ */
+class Tile final {
+public:
+    Tile(int DPIScaling, int x, int y, double zoom);
+
+    cairo_t* get();
+
+    /**
+     * @brief Paint the tile to the target cairo context, in page coordinates
+     */
+    void paintTo(cairo_t* targetCr) const;
+
+    /**
+     * @return The part of the page covered by the tile
+     */
+    Range getExtent() const;
+
+    /**
+     * @return The memory used by the tile, in bytes
+     */
+    size_t getSize() const;
+
+    double getZoom() const;
+
+    /// The content of the page changed since the tile was rendered
+    bool stale = false;
+
+    /// The tile is a quick approximation of the page (see DocumentView::setDraftQuality), to be rendered again
+    bool draft = false;
+
+private:
+    Mask mask;
+    int x;
+    int y;
+};
+
+/**
+ * The rendered tiles of all the pages, kept as long as their total size fits in the budget. The least recently used
+ * tiles are evicted first.
+ *
+ * The tiles are identified by their page, zoom level, DPI scale factor and position: tile (x, y) covers the pixels
+ * [x * TILE_SIZE, (x + 1) * TILE_SIZE) x [y * TILE_SIZE, (y + 1) * TILE_SIZE) of the page at the zoom level, and is
+ * rendered with TILE_SIZE x TILE_SIZE logical pixels, i.e. TILE_SIZE * dpiScaling device pixels on each side.
+ */
+class TileCache final {
+public:
+    static constexpr int TILE_SIZE = 256;
+
+    struct Key {
+        /// The view of the page
+        const void* owner = nullptr;
+        double zoom = 1.0;
+        /// The DPI scale factor of the display the tile is rendered for
+        int dpiScaling = 1;
+        int x = 0;
+        int y = 0;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    /**
+     * Tiles covering a part of a page, both bounds included
+     */
+    struct TileRange {
+        int minX = 0;
+        int minY = 0;
+        int maxX = -1;
+        int maxY = -1;
+    };
+
+    /**
+     * @return The tiles covering the area (in page coordinates) at the given zoom level
+     */
+    static TileRange getTileRange(const Range& area, double zoom);
+
+    /**
+     * @return The part of the page covered by the tile
+     */
+    static Range getTileExtent(int x, int y, double zoom);
+
+    /**
+     * The cache shared by all the pages
+     */
+    static TileCache& instance();
+
+public:
+    /**
+     * @return The tile, or nullptr if it is not cached
+     */
+    std::shared_ptr<Tile> lookup(const Key& key);
+
+    /**
+     * Adds a tile, replacing the one with the same key if any
+     */
+    void cache(const Key& key, std::shared_ptr<Tile> tile);
+
+    /**
+     * @return All the cached tiles of the page, at any zoom level
+     */
+    std::vector<std::pair<Key, std::shared_ptr<Tile>>> getTiles(const void* owner) const;
+
+    bool hasTiles(const void* owner) const;
+
+    /**
+     * Drops all the tiles of the page
+     */
+    void evict(const void* owner);
+
+    /**
+     * @param maxSize The budget in bytes
+     */
+    void setMaxSize(size_t maxSize);
+
+    /**
+     * @return The size of the cached tiles in bytes
+     */
+    size_t getSize() const;
+
+private:
+    TileCache() = default;
+
+    void shrinkTo(size_t size);
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    using Entry = std::pair<Key, std::shared_ptr<Tile>>;
+
+    mutable std::mutex mutex;
+
+    /// Most recently used first
+    std::list<Entry> entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+    size_t size = 0;
+    size_t maxSize = 256 * 1024 * 1024;
+};
+};  // namespace xoj::view
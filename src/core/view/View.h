@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <atomic>   // for atomic
+#include <cstdint>  // for uint32_t
 #include <memory>
 
 #include <gtk/gtk.h>
@@ -23,6 +25,18 @@ namespace view {
 enum NonAudioTreatment : bool { FADE_OUT_NON_AUDIO_ = true, NORMAL_NON_AUDIO = false };
 enum EditionTreatment : bool { SHOW_CURRENT_EDITING = true, HIDE_CURRENT_EDITING = false };
 enum ColorTreatment : bool { COLORBLIND = true, NORMAL_COLOR = false };
+enum QualityTreatment : bool { DRAFT_QUALITY = true, FULL_QUALITY = false };
+
+/**
+ * Lets a rendering stop early once its result is no longer needed: the rendering is cancelled as soon as the counter
+ * differs from the generation the rendering started at.
+ */
+struct RenderGeneration {
+    const std::atomic<uint32_t>* counter = nullptr;
+    uint32_t generation = 0;
+
+    bool isCancelled() const { return counter && counter->load(std::memory_order_relaxed) != generation; }
+};
 
 class Context {
 public:
@@ -30,6 +44,9 @@ public:
     NonAudioTreatment fadeOutNonAudio;
     EditionTreatment showCurrentEdition;
     ColorTreatment noColor;
+    /// Draft rendering trades accuracy for speed, e.g. strokes with pressure are drawn with a constant width
+    QualityTreatment quality = FULL_QUALITY;
+    RenderGeneration renderGeneration = {};
 
     static Context createDefault(cairo_t* cr) { return {cr, NORMAL_NON_AUDIO, HIDE_CURRENT_EDITING, NORMAL_COLOR}; }
     static Context createColorBlind(cairo_t* cr) { return {cr, NORMAL_NON_AUDIO, HIDE_CURRENT_EDITING, COLORBLIND}; }
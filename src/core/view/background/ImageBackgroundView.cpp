@@ -1,7 +1,10 @@
 #include "ImageBackgroundView.h"
 
+#include <algorithm>  // for min
+#include <cmath>      // for hypot
+
+#include <cairo.h>                  // for cairo_set_source_surface, cairo_surface_get_type
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for gdk_pixbuf_get_height
-#include <gdk/gdk.h>                // for gdk_cairo_set_source_pixbuf
 
 #include "model/BackgroundImage.h"           // for BackgroundImage
 #include "view/background/BackgroundView.h"  // for BackgroundView, view
@@ -20,12 +23,25 @@ void ImageBackgroundView::draw(cairo_t* cr) const {
         int width = gdk_pixbuf_get_width(pixbuff);
         int height = gdk_pixbuf_get_height(pixbuff);
 
-        double sx = this->pageWidth / width;
-        double sy = this->pageHeight / height;
+        // The number of device pixels per pixel of the image, to pick the size of the surface painted. The image is
+        // embedded at full size in the vector outputs (PDF export, printing), whatever their transformation.
+        double scale = 1.0;
+        cairo_surface_t* target = cairo_get_target(cr);
+        if (cairo_surface_get_type(target) == CAIRO_SURFACE_TYPE_IMAGE) {
+            double deviceScaleX = 1.0;
+            double deviceScaleY = 1.0;
+            cairo_surface_get_device_scale(target, &deviceScaleX, &deviceScaleY);
+            scale = std::hypot(matrix.xx, matrix.yx) * deviceScaleX *
+                    std::min(this->pageWidth / width, this->pageHeight / height);
+        }
+
+        auto surface = this->image.getSurface(scale);
+        double sx = this->pageWidth / cairo_image_surface_get_width(surface.get());
+        double sy = this->pageHeight / cairo_image_surface_get_height(surface.get());
 
         cairo_scale(cr, sx, sy);
 
-        gdk_cairo_set_source_pixbuf(cr, pixbuff, 0, 0);
+        cairo_set_source_surface(cr, surface.get(), 0, 0);
         cairo_paint(cr);
 
         cairo_set_matrix(cr, &matrix);
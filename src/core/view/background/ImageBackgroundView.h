@@ -13,9 +13,9 @@
 
 #include <cairo.h>  // for cairo_t
 
-#include "BackgroundView.h"  // for BackgroundView
+#include "model/BackgroundImage.h"  // for BackgroundImage
 
-struct BackgroundImage;
+#include "BackgroundView.h"  // for BackgroundView
 
 namespace xoj::view {
 class ImageBackgroundView: public BackgroundView {
@@ -28,6 +28,7 @@ public:
     virtual void draw(cairo_t* cr) const override;
 
 private:
-    const BackgroundImage& image;
+    /// A copy sharing the image data, so that the page may change while the view is drawn
+    BackgroundImage image;
 };
 };  // namespace xoj::view
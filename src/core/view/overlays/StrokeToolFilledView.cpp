@@ -11,8 +11,8 @@
 
 using namespace xoj::view;
 
-static const Point& setupFirstPoint(const Stroke& s) {
-    const auto& pts = s.getPointVector();
+static Point setupFirstPoint(const Stroke& s) {
+    auto pts = s.getPoints();
     xoj_assert(!pts.empty());
     return pts.front();
 }
@@ -21,8 +21,8 @@ void OutputStream::write(const char* str) { write(str, std::strlen(str)); }
 /// GzOutputStream /////////////////////////////////////
 ////////////////////////////////////////////////////////
 
-GzOutputStream::GzOutputStream(fs::path file): file(std::move(file)) {
-    this->fp = GzUtil::openPath(this->file, "w");
+GzOutputStream::GzOutputStream(fs::path file, bool append): file(std::move(file)) {
+    this->fp = GzUtil::openPath(this->file, append ? "a" : "w");
     if (this->fp == nullptr) {
         this->error = FS(_F("Error opening file: \"{1}\"") % this->file.u8string());
         this->error = this->error + "\n" + std::strerror(errno);
@@ -74,3 +74,19 @@ void GzOutputStream::close() {
         }
     }
 }
+
+////////////////////////////////////////////////////////
+/// StringOutputStream /////////////////////////////////
+////////////////////////////////////////////////////////
+
+StringOutputStream::StringOutputStream() = default;
+
+StringOutputStream::~StringOutputStream() = default;
+
+void StringOutputStream::write(const char* data, size_t len) { this->str.append(data, len); }
+
+void StringOutputStream::close() {}
+
+auto StringOutputStream::getString() const -> const std::string& { return this->str; }
+
+void StringOutputStream::clear() { this->str.clear(); }
@@ -1,13 +1,19 @@
 #include "util/Util.h"
 
-#include <array>    // for array
-#include <cstdlib>  // for system
-#include <string>   // for allocator, string
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <algorithm>     // for find_if
+#include <array>         // for array
+#include <charconv>      // for to_chars, from_chars, chars_format
+#include <cstdint>       // for uint64_t
+#include <cstdlib>       // for system
+#include <cstring>       // for memcpy
+#include <string>        // for allocator, string
+#include <system_error>  // for errc
+#include <utility>       // for move
+#include <vector>        // for vector
 
 #include <gdk/gdk.h>  // for gdk_cairo_set_source_rgba, gdk_t...
 
+#include "util/Assert.h"             // for xoj_assert
 #include "util/Color.h"              // for argb_to_GdkRGBA, rgb_to_GdkRGBA
 #include "util/OutputStream.h"       // for OutputStream
 #include "util/PlaceholderString.h"  // for PlaceholderString
@@ -62,13 +68,117 @@ void Util::cairo_set_dash_from_vector(cairo_t* cr, const std::vector<double>& da
     cairo_set_dash(cr, dashes.data(), static_cast<int>(dashes.size()), offset);
 }
 
+void Util::appendDoubleString(std::string& buffer, double value) {
+    std::array<char, G_ASCII_DTOSTR_BUF_SIZE> str{};
+#ifdef __cpp_lib_to_chars
+    // std::to_chars with an explicit precision behaves like printf("%.<precision>g") in the C locale
+    [[maybe_unused]] auto [end, ec] = std::to_chars(str.data(), str.data() + str.size(), value,
+                                                    std::chars_format::general, Util::PRECISION_DIGITS);
+    xoj_assert(ec == std::errc());
+    buffer.append(str.data(), end);
+#else
+    // No floating point std::to_chars
+    g_ascii_formatd(str.data(), G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, value);
+    buffer.append(str.data());
+#endif
+}
+
 void Util::writeCoordinateString(OutputStream* out, double xVal, double yVal) {
-    std::array<char, G_ASCII_DTOSTR_BUF_SIZE> coordString{};
-    g_ascii_formatd(coordString.data(), G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, xVal);
-    out->write(coordString.data());
-    out->write(" ");
-    g_ascii_formatd(coordString.data(), G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, yVal);
-    out->write(coordString.data());
+    std::string coordString;
+    appendDoubleString(coordString, xVal);
+    coordString += ' ';
+    appendDoubleString(coordString, yVal);
+    out->write(coordString);
+}
+
+auto Util::parseDouble(const char* first, const char* last, double& value) -> const char* {
+    auto isSpace = [](char c) { return g_ascii_isspace(c) != 0; };
+    first = std::find_if_not(first, last, isSpace);
+    if (first == last) {
+        return nullptr;
+    }
+
+#ifdef __cpp_lib_to_chars
+    // std::from_chars does not accept an explicit '+' sign
+    const char* start = (*first == '+' && first + 1 != last && first[1] != '-') ? first + 1 : first;
+    auto [end, ec] = std::from_chars(start, last, value);
+    if (ec == std::errc()) {
+        return end;
+    }
+    if (ec != std::errc::result_out_of_range) {
+        return nullptr;
+    }
+#endif
+
+    // Slow path (out of range values or no floating point std::from_chars): g_ascii_strtod needs a null-terminated
+    // string, so copy the token.
+    std::string token(first, std::find_if(first, last, isSpace));
+    char* endPtr = nullptr;
+    value = g_ascii_strtod(token.c_str(), &endPtr);
+    if (endPtr == token.c_str()) {
+        return nullptr;
+    }
+    return first + (endPtr - token.c_str());
+}
+
+auto Util::countTokens(const char* first, const char* last) -> size_t {
+    size_t count = 0;
+    bool inToken = false;
+    for (; first != last; ++first) {
+        bool space = g_ascii_isspace(*first);
+        count += !space && !inToken;
+        inToken = !space;
+    }
+    return count;
+}
+
+void Util::writeDoubleArrayString(OutputStream* out, const std::vector<double>& values) {
+    if (values.empty()) {
+        return;
+    }
+    std::string str;
+    // Most values fit in 8 digits, a sign, a dot and a separator
+    str.reserve(values.size() * 12);
+    for (double v: values) {
+        appendDoubleString(str, v);
+        str += ' ';
+    }
+    str.pop_back();
+    out->write(str);
+}
+
+void Util::appendLittleEndianDoubles(std::string& buffer, const std::vector<double>& values) {
+    static_assert(sizeof(double) == sizeof(uint64_t));
+    size_t offset = buffer.size();
+    buffer.resize(offset + values.size() * sizeof(double));
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+    if (!values.empty()) {
+        std::memcpy(buffer.data() + offset, values.data(), values.size() * sizeof(double));
+    }
+#else
+    for (double v: values) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(bits));
+        bits = GUINT64_TO_LE(bits);
+        std::memcpy(buffer.data() + offset, &bits, sizeof(bits));
+        offset += sizeof(bits);
+    }
+#endif
+}
+
+void Util::readLittleEndianDoubles(const char* data, size_t count, double* values) {
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+    if (count != 0) {
+        std::memcpy(values, data, count * sizeof(double));
+    }
+#else
+    for (size_t i = 0; i < count; i++) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, data + i * sizeof(bits), sizeof(bits));
+        bits = GUINT64_FROM_LE(bits);
+        std::memcpy(&values[i], &bits, sizeof(bits));
+    }
+#endif
 }
 
 void Util::systemWithMessage(const char* command) {
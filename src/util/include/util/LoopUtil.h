@@ -22,6 +22,8 @@
  */
 template <typename Container, typename Fun1, typename Fun2>
 void for_first_then_each(Container&& c, Fun1 f1, Fun2&& f2) {
+    using std::begin;
+    using std::end;
     auto begi = begin(c);
     auto endi = end(c);
     if (begi == endi)
@@ -32,7 +32,10 @@ public:
 
 class GzOutputStream: public OutputStream {
 public:
-    GzOutputStream(fs::path file);
+    /**
+     * @param append Whether to add a new gzip member at the end of the file instead of replacing it
+     */
+    GzOutputStream(fs::path file, bool append = false);
     ~GzOutputStream() override;
 
 public:
@@ -48,3 +51,27 @@ private:
     std::string error;
     fs::path file;
 };
+
+/**
+ * Writes to a string in memory
+ */
+class StringOutputStream: public OutputStream {
+public:
+    StringOutputStream();
+    ~StringOutputStream() override;
+
+public:
+    void write(const char* data, size_t len) override;
+
+    void close() override;
+
+    const std::string& getString() const;
+
+    /**
+     * Drops the written data
+     */
+    void clear();
+
+private:
+    std::string str;
+};
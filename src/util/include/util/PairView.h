@@ -13,6 +13,7 @@
 #include <array>
 #include <iterator>
 #include <type_traits>
+#include <utility>
 
 #include "TypeIfThenElse.h"
 
@@ -40,14 +41,15 @@ private:
     public:
         using iterator_category = std::random_access_iterator_tag;
         using value_type = typename PairView::value_type;
-        using qualified_value_type = typename const_if<value_type, is_const>::type;
-        using qualified_sub_value_type = typename const_if<sub_value_type, is_const>::type;
+        // Not using contiguous_container_type::const_iterator, which std::span lacks
+        using container_iterator_type =
+                decltype(std::declval<typename const_if<contiguous_container_type, is_const>::type&>().begin());
+        // Views on read-only elements (like std::span<const T>) give read-only pairs, whatever is_const
+        using qualified_sub_value_type = std::remove_reference_t<decltype(*std::declval<container_iterator_type>())>;
+        using qualified_value_type = typename const_if<value_type, std::is_const_v<qualified_sub_value_type>>::type;
         using pointer = qualified_value_type*;
         using reference = qualified_value_type&;
         using difference_type = std::ptrdiff_t;
-        using container_iterator_type =
-                typename type_or_type<typename contiguous_container_type::const_iterator,
-                                      typename contiguous_container_type::iterator, is_const>::type;
 
         BaseIterator() = default;
         ~BaseIterator() = default;
@@ -14,7 +14,9 @@
 #include <cstdlib>     // size_t
 #include <functional>  // for function
 #include <limits>      // for numeric_limits
+#include <string>      // for string
 #include <utility>
+#include <vector>      // for vector
 
 #include <cairo.h>    // for cairo_t
 #include <glib.h>     // for G_PRIORITY_DEFAULT_IDLE, gboolean, gchar, gint
@@ -81,7 +83,42 @@ xoj::util::Point<double> toWidgetCoords(GtkWidget* widget, xoj::util::Point<doub
  */
 extern void writeCoordinateString(OutputStream* out, double xVal, double yVal);
 
+/**
+ * Append the value to the buffer, formatted as PRECISION_FORMAT_STRING in the C locale.
+ * Much cheaper than g_ascii_formatd(), and produces the same output.
+ */
+extern void appendDoubleString(std::string& buffer, double value);
+
+/**
+ * Write the values separated by spaces, with a single call to OutputStream::write()
+ */
+extern void writeDoubleArrayString(OutputStream* out, const std::vector<double>& values);
+
+/**
+ * Parse a number (in the C locale) at the beginning of [first, last), skipping leading whitespace.
+ * Unlike g_ascii_strtod(), the input does not need to be null-terminated.
+ * @return A pointer past the parsed number, or nullptr if no number could be read.
+ */
+extern const char* parseDouble(const char* first, const char* last, double& value);
+
+/**
+ * Count the whitespace separated tokens in [first, last). Used to reserve space before parsing number lists.
+ */
+extern size_t countTokens(const char* first, const char* last);
+
+/**
+ * Append the values to the buffer as little-endian IEEE 754 doubles, whatever the byte order of the machine
+ */
+extern void appendLittleEndianDoubles(std::string& buffer, const std::vector<double>& values);
+
+/**
+ * Read `count` little-endian IEEE 754 doubles starting at `data`, which needs not be aligned
+ */
+extern void readLittleEndianDoubles(const char* data, size_t count, double* values);
+
 constexpr const gchar* PRECISION_FORMAT_STRING = "%.8g";
+/// Number of significant digits in PRECISION_FORMAT_STRING
+constexpr const int PRECISION_DIGITS = 8;
 
 constexpr const auto DPI_NORMALIZATION_FACTOR = 72.0;
 
@@ -12,20 +12,26 @@
 #include <cmath>
 #include <filesystem>
 #include <iostream>
+#include <memory>
 #include <string_view>
 
 #include <config-test.h>
 #include <gtest/gtest.h>
 
+#include "control/jobs/AutosaveJournal.h"
+#include "control/jobs/Scheduler.h"
 #include "control/xojfile/LoadHandler.h"
 #include "control/xojfile/SaveHandler.h"
+#include "model/DocumentHandler.h"
 #include "model/Element.h"
 #include "model/Image.h"
+#include "model/Layer.h"
 #include "model/PageRef.h"
 #include "model/Stroke.h"
 #include "model/TexImage.h"
 #include "model/Text.h"
 #include "model/XojPage.h"
+#include "util/OutputStream.h"
 #include "util/PathUtil.h"
 #include "util/StringUtils.h"
 
@@ -39,8 +45,9 @@ using std::string;
  * Unit test implementation for the "suite.xopp" file and its derivatives.
  * \param filepath The path to the actual file to load.
  * \param tol The absolute tolerance used when checking stroke coordinate data.
+ * \param binaryStrokes Whether to store the strokes in binary form.
  */
-void testLoadStoreLoadHelper(const fs::path& filepath, double tol = 1e-8) {
+void testLoadStoreLoadHelper(const fs::path& filepath, double tol = 1e-8, bool binaryStrokes = false) {
     auto getElements = [](Document* doc) {
         EXPECT_EQ((size_t)1, doc->getPageCount());
         ConstPageRef page = doc->getPage(0);
@@ -82,6 +89,7 @@ void testLoadStoreLoadHelper(const fs::path& filepath, double tol = 1e-8) {
     auto elements1 = getElements(doc1.get());
 
     SaveHandler h;
+    h.setBinaryStrokes(binaryStrokes);
     auto tmp = Util::getTmpDirSubfolder() / "save.xopp";
     h.prepareSave(doc1.get(), tmp);
     h.saveTo(tmp);
@@ -263,6 +271,94 @@ TEST(ControlLoadHandler, testPageTypeZipped) {
     checkPageType(doc.get(), 5, "p6", PageType(PageTypeFormat::Image));
 }
 
+TEST(ControlLoadHandler, testPageTypeSequential) {
+    // Multi-page documents are parsed in parallel by default: check the sequential parser gives the same result
+    Scheduler scheduler;
+    scheduler.start(2);
+    for (bool parallel: {false, true}) {
+        LoadHandler handler;
+        handler.setParallelParsing(parallel);
+        handler.setScheduler(&scheduler);
+        auto doc = handler.loadDocument(GET_TESTFILE(u8"packaged_xopp/pages.xopp"));
+
+        ASSERT_EQ((size_t)6, doc->getPageCount());
+        checkPageType(doc.get(), 0, "p1", PageType(PageTypeFormat::Plain));
+        checkPageType(doc.get(), 1, "p2", PageType(PageTypeFormat::Ruled));
+        checkPageType(doc.get(), 2, "p3", PageType(PageTypeFormat::Lined));
+        checkPageType(doc.get(), 3, "p4", PageType(PageTypeFormat::Staves));
+        checkPageType(doc.get(), 4, "p5", PageType(PageTypeFormat::Graph));
+        checkPageType(doc.get(), 5, "p6", PageType(PageTypeFormat::Image));
+    }
+}
+
+TEST(ControlLoadHandler, testLazyLoading) {
+    LoadHandler handler;
+    handler.setLazyLoading(true);
+    auto doc = handler.loadDocument(GET_TESTFILE(u8"packaged_xopp/pages.xopp"));
+
+    ASSERT_EQ((size_t)6, doc->getPageCount());
+    PageRef page = doc->getPage(0);
+    EXPECT_FALSE(page->isLoaded());
+    EXPECT_TRUE(page->getBackgroundType() == PageType(PageTypeFormat::Plain));
+
+    checkPageType(doc.get(), 0, "p1", PageType(PageTypeFormat::Plain));
+    checkPageType(doc.get(), 1, "p2", PageType(PageTypeFormat::Ruled));
+    checkPageType(doc.get(), 2, "p3", PageType(PageTypeFormat::Lined));
+    checkPageType(doc.get(), 3, "p4", PageType(PageTypeFormat::Staves));
+    checkPageType(doc.get(), 4, "p5", PageType(PageTypeFormat::Graph));
+    checkPageType(doc.get(), 5, "p6", PageType(PageTypeFormat::Image));
+    EXPECT_TRUE(page->isLoaded());
+
+    // Unmodified pages can be unloaded and loaded again
+    EXPECT_TRUE(page->unloadLayers());
+    EXPECT_FALSE(page->isLoaded());
+    checkPageType(doc.get(), 0, "p1", PageType(PageTypeFormat::Plain));
+
+    // The layers may be modified through getSelectedLayer(): they must be kept
+    page->getSelectedLayer();
+    EXPECT_FALSE(page->unloadLayers());
+    EXPECT_TRUE(page->isLoaded());
+}
+
+TEST(ControlLoadHandler, testDocumentSnapshot) {
+    LoadHandler handler;
+    handler.setLazyLoading(true);
+    auto doc = handler.loadDocument(GET_TESTFILE(u8"packaged_xopp/pages.xopp"));
+    ASSERT_EQ((size_t)6, doc->getPageCount());
+    doc->getPage(0)->getSelectedLayer()->addElement(std::make_unique<Text>());
+
+    DocumentHandler snapshotHandler;
+    doc->lock();
+    auto snapshot = doc->createSnapshot(&snapshotHandler);
+    doc->unlock();
+    ASSERT_EQ((size_t)6, snapshot->getPageCount());
+
+    // Modified pages are copied, the others share the layer loader
+    EXPECT_NE(doc->getPage(0), snapshot->getPage(0));
+    EXPECT_TRUE(snapshot->getPage(0)->isLoaded());
+    EXPECT_FALSE(snapshot->getPage(1)->isLoaded());
+    checkPageType(snapshot.get(), 1, "p2", PageType(PageTypeFormat::Ruled));
+
+    // Later changes do not affect the snapshot
+    size_t elementCount = snapshot->getPage(0)->getLayersView()[0]->getElementsView().size();
+    doc->getPage(0)->getSelectedLayer()->addElement(std::make_unique<Text>());
+    EXPECT_EQ(elementCount, snapshot->getPage(0)->getLayersView()[0]->getElementsView().size());
+
+    // Only the pages changed since the last snapshot are copied again
+    doc->lock();
+    auto nextSnapshot = doc->createSnapshot(&snapshotHandler);
+    doc->unlock();
+    EXPECT_NE(snapshot->getPage(0), nextSnapshot->getPage(0));
+    EXPECT_EQ(elementCount + 1, nextSnapshot->getPage(0)->getLayersView()[0]->getElementsView().size());
+    EXPECT_EQ(snapshot->getPage(1), nextSnapshot->getPage(1));
+
+    // The copies are released with the snapshots
+    std::weak_ptr<XojPage> copy = nextSnapshot->getPage(0);
+    snapshot.reset();
+    nextSnapshot.reset();
+    EXPECT_TRUE(copy.expired());
+}
+
 TEST(ControlLoadHandler, testPageTypeFormatCopyFix) {
     LoadHandler handler;
     auto doc = handler.loadDocument(GET_TESTFILE(u8"pageTypeFormatCopy.xopp"));
@@ -481,6 +577,11 @@ TEST(ControlLoadHandler, testLoadStoreLoadDefault) {
     testLoadStoreLoadHelper(GET_TESTFILE(u8"packaged_xopp/suite.xopp"), /*tol=*/1e-8);
 }
 
+TEST(ControlLoadHandler, testLoadStoreLoadBinaryStrokes) {
+    // The binary form stores the exact values
+    testLoadStoreLoadHelper(GET_TESTFILE(u8"packaged_xopp/suite.xopp"), /*tol=*/0, /*binaryStrokes=*/true);
+}
+
 // Backwards compatibility test that checks that full-precision float strings can be loaded.
 // See https://github.com/xournalpp/xournalpp/pull/4065
 TEST(ControlLoadHandler, testLoadStoreLoadFloatBwCompat) {
@@ -542,6 +643,90 @@ TEST(ControlLoadHandler, testStrokeWidthRecovery) {
     testPressureValues(8, {0.25, 0.30, 0.40, Point::NO_PRESSURE});
 }
 
+TEST(ControlLoadHandler, testLazyLoadingError) {
+    auto tmp = Util::getTmpDirSubfolder() / "lazyLoadingError.xopp";
+    {
+        GzOutputStream out(tmp);
+        out.write("<?xml version=\"1.0\" standalone=\"no\"?>\n"
+                  "<xournal creator=\"Xournal++ 1.2.0\" fileversion=\"4\">\n"
+                  "<title>Xournal++ document</title>\n"
+                  "<page width=\"612.00\" height=\"792.00\">\n"
+                  "<background type=\"solid\" color=\"#ffffffff\" style=\"plain\"/>\n"
+                  "<layer><stroke tool=\"pen\" color=\"#000000ff\" width=\"1.41\">10 10 20 20</stroke></layer>\n"
+                  "<layer><stroke tool=\"pen\" color=\"#000000ff\" width=\"1.41\">10 10 20 20</strok></layer>\n"
+                  "</page>\n"
+                  "</xournal>\n");
+        out.close();
+        ASSERT_TRUE(out.getLastError().empty());
+    }
+
+    LoadHandler handler;
+    handler.setLazyLoading(true);
+    int reports = 0;
+    handler.setLazyLoadingErrorHandler([&reports](const std::string&) { reports++; });
+    auto doc = handler.loadDocument(tmp);
+    ASSERT_NE(doc.get(), nullptr);
+    ASSERT_EQ((size_t)1, doc->getPageCount());
+
+    PageRef page = doc->getPage(0);
+    XojPage copy(*page);
+    EXPECT_TRUE(page->getLoadError().empty());
+
+    // The page keeps what could be parsed, and is not parsed again
+    EXPECT_EQ((size_t)1, page->getLayersView()[0]->getElementsView().size());
+    EXPECT_FALSE(page->getLoadError().empty());
+    EXPECT_FALSE(page->unloadLayers());
+
+    // The copy made before loading parses the page too, but the user is told once
+    EXPECT_EQ((size_t)1, copy.getLayersView()[0]->getElementsView().size());
+    EXPECT_FALSE(copy.getLoadError().empty());
+    EXPECT_EQ(1, reports);
+
+    fs::remove(tmp);
+}
+
+TEST(ControlLoadHandler, testReplayAutosaveJournal) {
+    LoadHandler handler;
+    auto doc = handler.loadDocument(GET_TESTFILE(u8"packaged_xopp/suite.xopp"));
+    ASSERT_NE(doc.get(), nullptr);
+
+    auto tmp = Util::getTmpDirSubfolder() / "journal.autosave.xopp";
+    auto journal = AutosaveJournal::getJournalPath(tmp);
+    fs::remove(journal);
+
+    SaveHandler saver;
+    saver.prepareSave(doc.get(), tmp);
+    saver.saveTo(tmp);
+    ASSERT_TRUE(saver.getErrorMessage().empty());
+
+    auto appendRecord = [&](const std::string& baseId) {
+        StringOutputStream record;
+        SaveHandler().writeJournalRecord(&record, doc.get(), {0}, baseId);
+        GzOutputStream out(journal, true);
+        out.write(record.getString());
+        out.close();
+        ASSERT_TRUE(out.getLastError().empty());
+    };
+
+    Layer* layer = doc->getPage(0)->getLayers()[0];
+    ASSERT_EQ((size_t)8, layer->getElementsView().size());
+
+    layer->removeElement(layer->getElements().back().get());
+    appendRecord(AutosaveJournal::getBaseId(tmp));
+
+    // Records written for another version of the autosave file are ignored
+    layer->removeElement(layer->getElements().back().get());
+    appendRecord("0-0");
+
+    auto doc2 = LoadHandler().loadDocument(tmp);
+    ASSERT_NE(doc2.get(), nullptr);
+    EXPECT_EQ((size_t)1, doc2->getPageCount());
+    EXPECT_EQ((size_t)7, doc2->getPage(0)->getLayersView()[0]->getElementsView().size());
+
+    fs::remove(journal);
+    fs::remove(tmp);
+}
+
 TEST(ControlLoadHandler, testLoadStoreCJK) {
     LoadHandler handler;
     auto filepath = std::u8string(GET_TESTFILE(u8"cjk/测试.xopp"));
@@ -0,0 +1,110 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+
+#include <cairo-pdf.h>
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "control/PdfCache.h"
+#include "pdf/base/XojPdfDocument.h"
+#include "util/raii/CairoWrappers.h"
+
+namespace {
+constexpr double PAGE_SIZE = 100.0;
+
+auto createPdf(int pageCount) -> std::unique_ptr<std::string> {
+    auto data = std::make_unique<std::string>();
+    auto write = [](void* closure, const unsigned char* d, unsigned int length) {
+        static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(d), length);
+        return CAIRO_STATUS_SUCCESS;
+    };
+    {
+        xoj::util::CairoSurfaceSPtr surface(cairo_pdf_surface_create_for_stream(write, data.get(), PAGE_SIZE, PAGE_SIZE),
+                                            xoj::util::adopt);
+        xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+        for (int i = 0; i < pageCount; i++) {
+            cairo_rectangle(cr.get(), 10, 10, 50, 50);
+            cairo_fill(cr.get());
+            cairo_show_page(cr.get());
+        }
+    }
+    return data;
+}
+
+void renderPage(PdfCache& cache, size_t pageNo, double zoom) {
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1), xoj::util::adopt);
+    xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+    cairo_scale(cr.get(), zoom, zoom);
+    cache.render(cr.get(), pageNo, zoom, PAGE_SIZE, PAGE_SIZE);
+}
+}  // namespace
+
+TEST(PdfCache, testZoomBucketsAndBudget) {
+    XojPdfDocument doc;
+    ASSERT_TRUE(doc.load(createPdf(2), "", nullptr));
+
+    PdfCache cache(doc, nullptr);
+    cache.setRefreshThreshold(5.0);
+    cache.setMaxSize(16 * 1024 * 1024);
+
+    renderPage(cache, 0, 1.0);
+    renderPage(cache, 0, 1.0);
+    const size_t smallSize = cache.getSize();
+    EXPECT_GT(smallSize, 0U);
+
+    // A rendering at a very different zoom level does not replace the small one
+    renderPage(cache, 0, 4.0);
+    const size_t largeSize = cache.getSize() - smallSize;
+    EXPECT_GT(largeSize, smallSize);
+    renderPage(cache, 0, 1.0);
+    renderPage(cache, 0, 4.0);
+
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.misses, 2U);
+    EXPECT_EQ(stats.hits, 3U);
+    EXPECT_EQ(stats.evictions, 0U);
+
+    // The least recently used rendering is evicted first
+    renderPage(cache, 1, 1.0);
+    EXPECT_EQ(cache.getSize(), 2 * smallSize + largeSize);
+    cache.setMaxSize(smallSize + largeSize);
+    EXPECT_EQ(cache.getStatistics().evictions, 1U);
+    EXPECT_EQ(cache.getSize(), smallSize + largeSize);
+
+    renderPage(cache, 0, 4.0);
+    renderPage(cache, 1, 1.0);
+    EXPECT_EQ(cache.getStatistics().misses, 3U);
+}
+
+TEST(PdfCache, testPrefetch) {
+    XojPdfDocument doc;
+    ASSERT_TRUE(doc.load(createPdf(3), "", nullptr));
+
+    PdfCache cache(doc, nullptr);
+    cache.setMaxSize(16 * 1024 * 1024);
+
+    EXPECT_TRUE(cache.prefetch(0, 1.0, 1));
+    EXPECT_TRUE(cache.prefetch(0, 1.0, 1));
+    const size_t pageSize = cache.getSize();
+    EXPECT_EQ(cache.getStatistics().misses, 1U);
+
+    renderPage(cache, 0, 1.0);
+    EXPECT_EQ(cache.getStatistics().misses, 1U);
+
+    // Prefetching does not evict anything
+    cache.setMaxSize(pageSize + pageSize / 2);
+    EXPECT_FALSE(cache.prefetch(1, 1.0, 1));
+    EXPECT_EQ(cache.getSize(), pageSize);
+    EXPECT_EQ(cache.getStatistics().evictions, 0U);
+}
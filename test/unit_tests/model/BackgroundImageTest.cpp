@@ -0,0 +1,54 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "model/BackgroundImage.h"
+
+#include "filesystem.h"
+
+TEST(BackgroundImage, testSharedSurface) {
+    BackgroundImage image;
+    EXPECT_EQ(image.getSurface().get(), nullptr);
+
+    // 500 x 130 pixels
+    image.loadFile(fs::path(GET_TESTFILE(u8"images/r90.jpg")), nullptr);
+    ASSERT_NE(image.getPixbuf(), nullptr);
+
+    auto surface = image.getSurface();
+    ASSERT_NE(surface.get(), nullptr);
+    EXPECT_EQ(cairo_image_surface_get_width(surface.get()), 500);
+    EXPECT_EQ(cairo_image_surface_get_height(surface.get()), 130);
+
+    // Converted only once, and shared by the clones
+    BackgroundImage clone = image;
+    EXPECT_EQ(image.getSurface().get(), surface.get());
+    EXPECT_EQ(clone.getSurface(2.0).get(), surface.get());
+
+    // Downscaled versions, at least as large as painted
+    auto half = image.getSurface(0.3);
+    EXPECT_EQ(cairo_image_surface_get_width(half.get()), 250);
+    EXPECT_EQ(cairo_image_surface_get_height(half.get()), 65);
+    EXPECT_EQ(clone.getSurface(0.5).get(), half.get());
+
+    auto quarter = image.getSurface(0.2);
+    EXPECT_EQ(cairo_image_surface_get_width(quarter.get()), 125);
+    EXPECT_EQ(cairo_image_surface_get_height(quarter.get()), 32);
+
+    // Only the last downscaled versions used are kept
+    auto eighth = image.getSurface(0.1);
+    EXPECT_EQ(image.getSurface(0.2).get(), quarter.get());
+    EXPECT_NE(image.getSurface(0.3).get(), half.get());
+    EXPECT_EQ(image.getSurface(0.2).get(), quarter.get());
+    EXPECT_NE(image.getSurface(0.1).get(), eighth.get());
+    EXPECT_EQ(image.getSurface().get(), surface.get());
+}
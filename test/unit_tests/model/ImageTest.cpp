@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include "model/Image.h"
+#include "model/ImageCache.h"
 
 #include "filesystem.h"
 
@@ -49,6 +50,45 @@ TEST(Image, testGetImageApplyOrientation) {
     // Test image now have the correct size - which is the image has been rotated.
     EXPECT_EQ(image.getImageSize(), rotatedImageSize);
     EXPECT_EQ(image.getImageSize(), std::make_pair(130, 500));
-    EXPECT_EQ(std::make_pair(cairo_image_surface_get_width(surface), cairo_image_surface_get_height(surface)),
+    EXPECT_EQ(std::make_pair(cairo_image_surface_get_width(surface.get()), cairo_image_surface_get_height(surface.get())),
               rotatedImageSize);
 }
+
+TEST(Image, testDecodedImageCache) {
+    std::ifstream imageFile{fs::path(GET_TESTFILE(u8"images/r90.jpg")), std::ios::binary};
+    auto imageData = std::string(std::istreambuf_iterator<char>(imageFile), {});
+
+    Image first;
+    first.setImage(imageData);
+    Image second;
+    second.setImage(imageData);
+
+    // Images with the same data are decoded once
+    auto surface = first.getImage();
+    ASSERT_TRUE(surface);
+    EXPECT_EQ(second.getImage().get(), surface.get());
+    EXPECT_EQ(second.getImageSize(), std::make_pair(130, 500));
+
+    // The surface is kept while another image still shows it
+    second.releaseImage();
+    EXPECT_EQ(first.getImage().get(), surface.get());
+
+    // Released images are decoded again, while the surface in use stays valid
+    first.releaseImage();
+    auto decodedAgain = first.getImage();
+    EXPECT_NE(decodedAgain.get(), surface.get());
+    EXPECT_EQ(cairo_image_surface_get_width(surface.get()), 130);
+
+    auto& cache = ImageCache::instance();
+    cache.setMaxSize(0);
+    EXPECT_EQ(cache.getSize(), 0U);
+    // The last decoded image is kept even if it exceeds the budget
+    auto unused = first.getImage();
+    EXPECT_GT(cache.getSize(), 0U);
+
+    cache.setMaxSize(256 * 1024 * 1024);
+    unused.reset();
+    decodedAgain.reset();
+    cache.evictUnused();
+    EXPECT_EQ(cache.getSize(), 0U);
+}
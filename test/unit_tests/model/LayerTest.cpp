@@ -0,0 +1,140 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "util/Rectangle.h"
+
+using xoj::util::Rectangle;
+
+namespace {
+auto makeStroke(double x, double y, double length) -> std::unique_ptr<Stroke> {
+    auto stroke = std::make_unique<Stroke>();
+    stroke->setWidth(1);
+    stroke->addPoint(Point(x, y));
+    stroke->addPoint(Point(x + length, y + length));
+    return stroke;
+}
+
+/// The elements of the layer overlapping the area, found without the spatial index
+auto findLinearly(const Layer& layer, const Rectangle<double>& area) -> std::vector<Element*> {
+    std::vector<Element*> res;
+    for (const auto& e: layer.getElements()) {
+        auto b = e->boundingRect();
+        if (b.x <= area.x + area.width && area.x <= b.x + b.width && b.y <= area.y + area.height &&
+            area.y <= b.y + b.height) {
+            res.push_back(e.get());
+        }
+    }
+    return res;
+}
+}  // namespace
+
+TEST(Layer, testElementsInArea) {
+    Layer layer;
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> coords(-100.0, 1000.0);
+    std::uniform_real_distribution<double> lengths(0.0, 50.0);
+    for (int i = 0; i < 500; i++) {
+        layer.addElement(makeStroke(coords(gen), coords(gen), lengths(gen)));
+    }
+    // Elements spanning many cells of the index
+    layer.addElement(makeStroke(-500, -500, 3000));
+
+    auto checkAreas = [&]() {
+        std::mt19937 areaGen(5);
+        for (int i = 0; i < 50; i++) {
+            Rectangle<double> area(coords(areaGen), coords(areaGen), lengths(areaGen) * 4, lengths(areaGen) * 4);
+            ASSERT_EQ(findLinearly(layer, area), layer.getElementsInArea(area));
+        }
+        Rectangle<double> everything(-1e6, -1e6, 2e6, 2e6);
+        ASSERT_EQ(findLinearly(layer, everything), layer.getElementsInArea(everything));
+    };
+    checkAreas();
+
+    // Insertions keep the layer order, even when inserting repeatedly at the same position
+    for (int i = 0; i < 50; i++) {
+        layer.insertElement(makeStroke(coords(gen), coords(gen), lengths(gen)), 10);
+        layer.insertElement(makeStroke(coords(gen), coords(gen), lengths(gen)), 0);
+    }
+    checkAreas();
+
+    // Changes of the elements are taken into account
+    Element* moved = layer.getElements()[20].get();
+    moved->move(2000, 2000);
+    auto found = layer.getElementsInArea(Rectangle<double>(2000, 2000, 1000, 1000));
+    EXPECT_NE(std::find(found.begin(), found.end(), moved), found.end());
+
+    Stroke* widened = dynamic_cast<Stroke*>(layer.getElements()[30].get());
+    widened->setWidth(400);
+    checkAreas();
+
+    // Removed elements are not found anymore
+    auto removed = layer.removeElement(moved);
+    found = layer.getElementsInArea(Rectangle<double>(2000, 2000, 1000, 1000));
+    EXPECT_EQ(std::find(found.begin(), found.end(), moved), found.end());
+    // and do not notify the layer anymore
+    removed.e->move(-2000, -2000);
+    checkAreas();
+}
+
+TEST(Layer, testIndexOf) {
+    Layer layer;
+    for (int i = 0; i < 100; i++) {
+        layer.addElement(makeStroke(i, i, 1));
+    }
+
+    auto checkPositions = [&]() {
+        const auto& elements = layer.getElements();
+        for (size_t i = 0; i < elements.size(); i++) {
+            ASSERT_EQ(layer.indexOf(elements[i].get()), static_cast<Element::Index>(i));
+        }
+    };
+    checkPositions();
+
+    std::mt19937 gen(11);
+    std::vector<ElementPtr> removed;
+    for (int i = 0; i < 50; i++) {
+        auto pos = static_cast<Element::Index>(gen() % layer.getElements().size());
+        if (i % 3 == 0) {
+            layer.insertElement(makeStroke(0, 0, 1), pos);
+        } else {
+            auto res = layer.removeElement(layer.getElements()[static_cast<size_t>(pos)].get());
+            EXPECT_EQ(res.pos, pos);
+            removed.push_back(std::move(res.e));
+        }
+        // Lookups in any order
+        auto elt = layer.getElements()[gen() % layer.getElements().size()].get();
+        EXPECT_EQ(layer.getElements()[static_cast<size_t>(layer.indexOf(elt))].get(), elt);
+    }
+    checkPositions();
+    for (const auto& e: removed) {
+        EXPECT_EQ(layer.indexOf(e.get()), Element::InvalidIndex);
+    }
+
+    // Several elements at once, one of them with an outdated position
+    InsertionOrderRef elts;
+    elts.emplace_back(layer.getElements()[5].get(), 5);
+    elts.emplace_back(layer.getElements()[40].get(), 2);
+    elts.emplace_back(layer.getElements()[60].get(), 60);
+    auto res = layer.removeElementsAt(elts);
+    ASSERT_EQ(res.size(), 3U);
+    EXPECT_EQ(res[1].pos, 40);
+    checkPositions();
+}
@@ -0,0 +1,93 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/StrokeContour.h"
+#include "model/StrokeContourCache.h"
+#include "util/raii/CairoWrappers.h"
+
+using xoj::view::StrokeContourCache;
+
+namespace {
+struct Extents {
+    double x1, y1, x2, y2;
+};
+
+template <class AddPath>
+auto fillExtents(AddPath addPath) -> Extents {
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1), xoj::util::adopt);
+    xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+    cairo_scale(cr.get(), 4.0, 4.0);
+    addPath(cr.get());
+    Extents e{};
+    cairo_fill_extents(cr.get(), &e.x1, &e.y1, &e.x2, &e.y2);
+    return e;
+}
+}  // namespace
+
+TEST(StrokeContourCache, testCachedContour) {
+    auto& cache = StrokeContourCache::instance();
+    ASSERT_EQ(cache.getSize(), 0U);
+    const auto initial = cache.getStatistics();
+
+    Stroke stroke;
+    stroke.setWidth(2);
+    for (int i = 0; i < 20; i++) {
+        stroke.addPoint(Point(10.0 * i, (i % 2) * 15.0, 1.0 + 0.2 * i));
+    }
+
+    auto contour = cache.get(stroke);
+    ASSERT_NE(contour, nullptr);
+    EXPECT_EQ(contour, cache.get(stroke));
+    EXPECT_EQ(cache.getSize(), contour->getSize());
+    EXPECT_EQ(cache.getStatistics().hits, initial.hits + 1);
+    EXPECT_EQ(cache.getStatistics().misses, initial.misses + 1);
+
+    auto expected = fillExtents([&](cairo_t* cr) { xoj::view::StrokeContour(stroke.getPointVector()).addToCairo(cr); });
+    auto actual = fillExtents([&](cairo_t* cr) { contour->addToCairo(cr); });
+    EXPECT_NEAR(expected.x1, actual.x1, 0.05);
+    EXPECT_NEAR(expected.y1, actual.y1, 0.05);
+    EXPECT_NEAR(expected.x2, actual.x2, 0.05);
+    EXPECT_NEAR(expected.y2, actual.y2, 0.05);
+
+    // Changing the stroke drops its contour
+    stroke.move(5, 5);
+    auto moved = cache.get(stroke);
+    ASSERT_NE(moved, nullptr);
+    EXPECT_NE(moved, contour);
+    EXPECT_EQ(cache.getSize(), moved->getSize());
+
+    // The least recently used contours are evicted to fit the budget, the new one is kept
+    auto other = stroke.cloneStroke();
+    other->setLastPressure(3.0);
+    cache.setMaxSize(moved->getSize());
+    auto otherContour = cache.get(*other);
+    ASSERT_NE(otherContour, nullptr);
+    EXPECT_EQ(cache.get(*other), otherContour);
+    EXPECT_EQ(cache.getSize(), otherContour->getSize());
+    EXPECT_EQ(cache.getStatistics().evictions, initial.evictions + 1);
+
+    // Evicted contours are built again, and stay valid while they are used
+    auto rebuilt = cache.get(stroke);
+    ASSERT_NE(rebuilt, nullptr);
+    EXPECT_NE(rebuilt, moved);
+    EXPECT_EQ(cache.getSize(), rebuilt->getSize());
+    EXPECT_GT(moved->getSize(), 0U);
+    cache.setMaxSize(64 * 1024 * 1024);
+
+    // The memory is given back when the strokes change or are destroyed
+    stroke.deletePointsFrom(10);
+    other.reset();
+    EXPECT_EQ(cache.getSize(), 0U);
+}
@@ -0,0 +1,165 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/StrokeKernels.h"
+#include "util/Rectangle.h"
+
+using xoj::util::Rectangle;
+
+namespace {
+/// Random polyline, with some repeated points (i.e. degenerate segments)
+auto randomPoints(std::mt19937& gen, size_t count, bool pressure) -> std::vector<Point> {
+    std::uniform_real_distribution<double> coord(-50.0, 50.0);
+    std::uniform_real_distribution<double> width(0.1, 5.0);
+    std::vector<Point> pts;
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0 && gen() % 5 == 0) {
+            pts.push_back(pts.back());
+        } else {
+            pts.emplace_back(coord(gen), coord(gen), pressure ? width(gen) : Point::NO_PRESSURE);
+        }
+    }
+    return pts;
+}
+}  // namespace
+
+TEST(StrokeKernels, testImplementationsAgree) {
+    auto implementations = StrokeKernels::getImplementations();
+    ASSERT_FALSE(implementations.empty());
+    const auto& reference = implementations.front();
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> coord(-60.0, 60.0);
+    for (int n = 0; n < 2000; n++) {
+        auto pts = randomPoints(gen, 1 + gen() % 40, n % 2 == 0);
+        double x = coord(gen);
+        double y = coord(gen);
+        double halfSize = 0.5 + 0.1 * static_cast<double>(gen() % 100);
+        Rectangle<double> rect(x - halfSize, y - halfSize, 2 * halfSize, 2 * halfSize);
+
+        auto bounds = reference.computeBounds(pts);
+        double distance = reference.distanceTo(pts, x, y, 1.5);
+        bool inside = reference.anyPointInside(pts, rect);
+
+        for (const auto& impl: implementations) {
+            SCOPED_TRACE(impl.name);
+            auto b = impl.computeBounds(pts);
+            EXPECT_EQ(b.minX, bounds.minX);
+            EXPECT_EQ(b.minY, bounds.minY);
+            EXPECT_EQ(b.maxX, bounds.maxX);
+            EXPECT_EQ(b.maxY, bounds.maxY);
+            EXPECT_EQ(b.maxPressure, bounds.maxPressure);
+            EXPECT_NEAR(impl.distanceTo(pts, x, y, 1.5), distance, 1e-9);
+            EXPECT_EQ(impl.anyPointInside(pts, rect), inside);
+            if (pts.size() >= 2) {
+                for (size_t first = 0; first + 1 < pts.size(); first += 3) {
+                    EXPECT_EQ(impl.findSegmentTouchingRectangle(pts, first, pts.size() - 2, rect),
+                              reference.findSegmentTouchingRectangle(pts, first, pts.size() - 2, rect));
+                }
+            }
+        }
+    }
+}
+
+TEST(StrokeKernels, testReferenceValues) {
+    std::vector<Point> pts{Point(0, 0, 2.0), Point(10, 0, 4.0), Point(10, 0, 4.0), Point(10, -10, 1.0),
+                           Point(-3, 5, 1.0)};
+    for (const auto& impl: StrokeKernels::getImplementations()) {
+        SCOPED_TRACE(impl.name);
+        auto b = impl.computeBounds(pts);
+        EXPECT_EQ(b.minX, -3.0);
+        EXPECT_EQ(b.minY, -10.0);
+        EXPECT_EQ(b.maxX, 10.0);
+        EXPECT_EQ(b.maxY, 5.0);
+        EXPECT_EQ(b.maxPressure, 4.0);
+
+        // Closest to the first segment, whose width is 2
+        EXPECT_DOUBLE_EQ(impl.distanceTo(pts, 5, 3, 1.0), 2.0);
+        // On the repeated point
+        EXPECT_DOUBLE_EQ(impl.distanceTo(pts, 13, 0, 1.0), 1.0);
+        EXPECT_EQ(impl.distanceTo(pts, 5, 0, 1.0), 0.0);
+        EXPECT_EQ(impl.distanceTo(std::span(pts).first(1), 5, 0, 1.0), std::numeric_limits<double>::max());
+
+        EXPECT_TRUE(impl.anyPointInside(pts, Rectangle<double>(9, -11, 2, 2)));
+        EXPECT_FALSE(impl.anyPointInside(pts, Rectangle<double>(4, -6, 2, 2)));
+
+        // Segment [(10, -10), (-3, 5)] only
+        EXPECT_EQ(impl.findSegmentTouchingRectangle(pts, 0, 3, Rectangle<double>(-2, -2, 1, 1)), 3U);
+        EXPECT_EQ(impl.findSegmentTouchingRectangle(pts, 0, 2, Rectangle<double>(-2, -2, 1, 1)), 3U);
+        // The border is included
+        EXPECT_EQ(impl.findSegmentTouchingRectangle(pts, 0, 3, Rectangle<double>(10, 1, 1, 1)), 3U);
+        EXPECT_EQ(impl.findSegmentTouchingRectangle(pts, 0, 3, Rectangle<double>(11, 0, 1, 1)), 4U);
+    }
+}
+
+TEST(StrokeKernels, testStrokeBounds) {
+    Stroke empty;
+    EXPECT_EQ(empty.getElementWidth(), 0.0);
+    EXPECT_EQ(empty.distanceTo(0, 0), std::numeric_limits<double>::max());
+
+    // Only negative coordinates
+    Stroke stroke;
+    stroke.setWidth(2);
+    stroke.setPointVector({Point(-20, -30), Point(-10, -5)});
+    EXPECT_DOUBLE_EQ(stroke.getX(), -21.0);
+    EXPECT_DOUBLE_EQ(stroke.getY(), -31.0);
+    EXPECT_DOUBLE_EQ(stroke.getElementWidth(), 12.0);
+    EXPECT_DOUBLE_EQ(stroke.getElementHeight(), 27.0);
+    EXPECT_DOUBLE_EQ(stroke.getSnappedBounds().width, 10.0);
+    EXPECT_DOUBLE_EQ(stroke.getSnappedBounds().height, 25.0);
+
+    stroke.setPointVector({Point(-20, -30, 4.0), Point(-10, -5, 6.0)});
+    EXPECT_DOUBLE_EQ(stroke.getX(), -23.0);
+    EXPECT_DOUBLE_EQ(stroke.getElementWidth(), 16.0);
+    EXPECT_DOUBLE_EQ(stroke.getSnappedBounds().x, -20.0);
+}
+
+/**
+ * Microbenchmark of the implementations. Run with --gtest_also_run_disabled_tests --gtest_filter='*Benchmark*'
+ */
+TEST(StrokeKernels, DISABLED_Benchmark) {
+    std::mt19937 gen(0);
+    auto pts = randomPoints(gen, 1'000'000, true);
+    Rectangle<double> rect(1000, 1000, 10, 10);
+    constexpr int ROUNDS = 20;
+
+    for (const auto& impl: StrokeKernels::getImplementations()) {
+        auto time = [&](auto&& fun) {
+            auto start = std::chrono::steady_clock::now();
+            double sink = 0.0;
+            for (int n = 0; n < ROUNDS; n++) {
+                sink += static_cast<double>(fun());
+            }
+            EXPECT_FALSE(std::isnan(sink));
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / ROUNDS;
+        };
+        std::cout << impl.name << ":\n";
+        std::cout << "  computeBounds                " << time([&] { return impl.computeBounds(pts).minX; }) << " ms\n";
+        std::cout << "  distanceTo                   " << time([&] { return impl.distanceTo(pts, 1, 2, 1); })
+                  << " ms\n";
+        std::cout << "  anyPointInside               " << time([&] { return impl.anyPointInside(pts, rect); })
+                  << " ms\n";
+        std::cout << "  findSegmentTouchingRectangle "
+                  << time([&] { return impl.findSegmentTouchingRectangle(pts, 0, pts.size() - 2, rect); }) << " ms\n";
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/StrokeKernels.h"
+#include "model/StrokeSegmentTree.h"
+#include "util/Rectangle.h"
+
+using xoj::util::Rectangle;
+
+namespace {
+/// Random walk, so that the blocks of segments are localised as in a drawn stroke
+auto randomWalk(std::mt19937& gen, size_t count) -> std::vector<Point> {
+    std::uniform_real_distribution<double> step(-3.0, 3.0);
+    std::uniform_real_distribution<double> width(0.1, 5.0);
+    std::vector<Point> pts{Point(0, 0, width(gen))};
+    for (size_t i = 1; i < count; i++) {
+        pts.emplace_back(pts.back().x + step(gen), pts.back().y + step(gen), width(gen));
+    }
+    return pts;
+}
+}  // namespace
+
+TEST(StrokeSegmentTree, testQueriesMatchLinearScan) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> coord(-60.0, 60.0);
+    for (size_t count: std::vector<size_t>{2, 3, 33, 64, 65, 1000, 5000}) {
+        SCOPED_TRACE(count);
+        auto pts = randomWalk(gen, count);
+        StrokeSegmentTree tree(pts);
+
+        for (int n = 0; n < 200; n++) {
+            double x = coord(gen);
+            double y = coord(gen);
+            Rectangle<double> rect(x, y, 0.5 + 0.05 * static_cast<double>(gen() % 100), 2.0);
+
+            EXPECT_DOUBLE_EQ(tree.distanceTo(pts, x, y, 1.5), StrokeKernels::distanceTo(pts, x, y, 1.5));
+
+            size_t first = gen() % (count - 1);
+            size_t last = first + gen() % (count - 1 - first);
+            EXPECT_EQ(tree.findSegmentTouchingRectangle(pts, first, last, rect),
+                      StrokeKernels::findSegmentTouchingRectangle(pts, first, last, rect));
+
+            auto b = tree.getBounds(pts, first, last + 1);
+            auto expected = StrokeKernels::computeBounds(std::span(pts).subspan(first, last + 2 - first));
+            EXPECT_EQ(b.minX, expected.minX);
+            EXPECT_EQ(b.minY, expected.minY);
+            EXPECT_EQ(b.maxX, expected.maxX);
+            EXPECT_EQ(b.maxY, expected.maxY);
+            EXPECT_EQ(b.maxPressure, expected.maxPressure);
+        }
+    }
+}
+
+TEST(StrokeSegmentTree, testStrokeInvalidation) {
+    std::mt19937 gen(3);
+    Stroke stroke;
+    stroke.setWidth(1);
+    stroke.setPointVector(randomWalk(gen, StrokeSegmentTree::MIN_POINT_COUNT - 1));
+    EXPECT_FALSE(stroke.getIndexedBounds(0, 1));
+
+    stroke.addPoint(Point(500, 500, 1.0));
+    stroke.addPoint(Point(500, 400, 1.0));
+    ASSERT_TRUE(stroke.getIndexedBounds(0, 1));
+    EXPECT_DOUBLE_EQ(stroke.distanceTo(510, 450), 9.5);
+
+    // The tree follows the points
+    stroke.move(10, 0);
+    EXPECT_DOUBLE_EQ(stroke.distanceTo(520, 450), 9.5);
+    size_t last = stroke.getPointCount() - 1;
+    EXPECT_DOUBLE_EQ(stroke.getIndexedBounds(last - 1, last)->maxX, 510.0);
+    stroke.deletePointsFrom(10);
+    EXPECT_FALSE(stroke.getIndexedBounds(0, 1));
+    EXPECT_GT(stroke.distanceTo(520, 450), 100.0);
+}
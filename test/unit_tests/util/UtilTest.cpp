@@ -0,0 +1,156 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "util/OutputStream.h"
+#include "util/Util.h"
+
+namespace {
+class CountingOutputStream: public OutputStream {
+public:
+    void write(const char* data, size_t len) override {
+        str.append(data, len);
+        writeCount++;
+    }
+    void close() override {}
+
+    std::string str;
+    size_t writeCount = 0;
+};
+
+std::string formatWithGlib(double value) {
+    char str[G_ASCII_DTOSTR_BUF_SIZE];
+    g_ascii_formatd(str, G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, value);
+    return str;
+}
+};  // namespace
+
+TEST(UtilFormat, testAppendDoubleStringMatchesGlib) {
+    std::vector<double> values = {0.0,
+                                  -0.0,
+                                  1.0,
+                                  -1.0,
+                                  0.5,
+                                  1e-5,
+                                  1e-4,
+                                  123.456,
+                                  12345678.5,
+                                  123456785.0,
+                                  99999999.5,
+                                  1e16,
+                                  1e-300,
+                                  std::numeric_limits<double>::min(),
+                                  std::numeric_limits<double>::max(),
+                                  std::numeric_limits<double>::denorm_min()};
+
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> coords(-5000.0, 5000.0);
+    std::uniform_real_distribution<double> pressures(0.0, 10.0);
+    for (int i = 0; i < 10000; i++) {
+        values.emplace_back(coords(gen));
+        values.emplace_back(pressures(gen));
+    }
+
+    for (double v: values) {
+        std::string str;
+        Util::appendDoubleString(str, v);
+        EXPECT_EQ(formatWithGlib(v), str) << "for value " << v;
+    }
+}
+
+TEST(UtilFormat, testWriteDoubleArrayString) {
+    std::vector<double> values = {1.5, -2.25, 3.0, 1.0 / 3.0, 987654.321};
+
+    std::string expected;
+    for (double v: values) {
+        if (!expected.empty()) {
+            expected += " ";
+        }
+        expected += formatWithGlib(v);
+    }
+
+    CountingOutputStream out;
+    Util::writeDoubleArrayString(&out, values);
+    EXPECT_EQ(expected, out.str);
+    EXPECT_EQ(1U, out.writeCount);
+
+    CountingOutputStream empty;
+    Util::writeDoubleArrayString(&empty, {});
+    EXPECT_EQ("", empty.str);
+    EXPECT_EQ(0U, empty.writeCount);
+}
+
+TEST(UtilFormat, testWriteCoordinateString) {
+    CountingOutputStream out;
+    Util::writeCoordinateString(&out, 12.345678912, -0.000123456789);
+    EXPECT_EQ(formatWithGlib(12.345678912) + " " + formatWithGlib(-0.000123456789), out.str);
+}
+
+TEST(UtilFormat, testParseDouble) {
+    // Deliberately not null-terminated after "8"
+    const std::string input = " 1.5 2.5\n\t-3e2 +4 0.000123456789 7 x 8";
+    const char* end = input.data() + input.size();
+
+    EXPECT_EQ(8U, Util::countTokens(input.data(), end));
+
+    std::vector<double> values;
+    double v = 0;
+    for (const char* ptr = input.data(); (ptr = Util::parseDouble(ptr, end, v)) != nullptr;) {
+        values.emplace_back(v);
+    }
+    // Parsing stops at the first token that is not a number
+    ASSERT_EQ(6U, values.size());
+    EXPECT_EQ(1.5, values[0]);
+    EXPECT_EQ(2.5, values[1]);
+    EXPECT_EQ(-300.0, values[2]);
+    EXPECT_EQ(4.0, values[3]);
+    EXPECT_EQ(g_ascii_strtod("0.000123456789", nullptr), values[4]);
+    EXPECT_EQ(7.0, values[5]);
+
+    EXPECT_EQ(nullptr, Util::parseDouble(end, end, v));
+    EXPECT_EQ(0U, Util::countTokens(end, end));
+
+    // Formatting and parsing round-trips to the same values as the glib functions
+    std::mt19937_64 gen(7);
+    std::uniform_real_distribution<double> coords(-5000.0, 5000.0);
+    for (int i = 0; i < 1000; i++) {
+        std::string str;
+        Util::appendDoubleString(str, coords(gen));
+        double parsed = 0;
+        ASSERT_EQ(str.data() + str.size(), Util::parseDouble(str.data(), str.data() + str.size(), parsed));
+        EXPECT_EQ(g_ascii_strtod(str.c_str(), nullptr), parsed);
+    }
+}
+
+TEST(UtilFormat, testLittleEndianDoubles) {
+    const std::vector<double> values = {1.0, -0.5, 1.0 / 3.0, 1e300, std::numeric_limits<double>::denorm_min()};
+
+    std::string buffer = "x";
+    Util::appendLittleEndianDoubles(buffer, values);
+    ASSERT_EQ(1 + values.size() * sizeof(double), buffer.size());
+    // 1.0 is 0x3FF0000000000000: the most significant byte comes last
+    EXPECT_EQ('\x00', buffer[1]);
+    EXPECT_EQ('\xF0', buffer[7]);
+    EXPECT_EQ('\x3F', buffer[8]);
+
+    // Read from an unaligned address
+    std::vector<double> read(values.size());
+    Util::readLittleEndianDoubles(buffer.data() + 1, values.size(), read.data());
+    EXPECT_EQ(values, read);
+}
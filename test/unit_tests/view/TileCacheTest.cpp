@@ -0,0 +1,124 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "util/Range.h"
+#include "view/TileCache.h"
+
+using xoj::view::Tile;
+using xoj::view::TileCache;
+
+TEST(TileCache, testTileRange) {
+    const double zoom = 1.5;
+    Range extent = TileCache::getTileExtent(2, 3, zoom);
+    EXPECT_DOUBLE_EQ(extent.getWidth(), TileCache::TILE_SIZE / zoom);
+
+    auto range = TileCache::getTileRange(extent, zoom);
+    EXPECT_EQ(range.minX, 2);
+    EXPECT_EQ(range.minY, 3);
+    EXPECT_EQ(range.maxX, 2);
+    EXPECT_EQ(range.maxY, 3);
+
+    Tile tile(1, 2, 3, zoom);
+    EXPECT_DOUBLE_EQ(tile.getExtent().minX, extent.minX);
+    EXPECT_DOUBLE_EQ(tile.getExtent().maxY, extent.maxY);
+}
+
+TEST(TileCache, testLookup) {
+    auto& cache = TileCache::instance();
+    int page = 0;
+    int otherPage = 0;
+
+    auto tile = std::make_shared<Tile>(1, 0, 0, 1.0);
+    cache.cache({&page, 1.0, 1, 0, 0}, tile);
+    EXPECT_EQ(cache.lookup({&page, 1.0, 1, 0, 0}), tile);
+
+    // The tiles differ by page, zoom level, DPI scale factor and position
+    EXPECT_EQ(cache.lookup({&otherPage, 1.0, 1, 0, 0}), nullptr);
+    EXPECT_EQ(cache.lookup({&page, 2.0, 1, 0, 0}), nullptr);
+    EXPECT_EQ(cache.lookup({&page, 1.0, 2, 0, 0}), nullptr);
+    EXPECT_EQ(cache.lookup({&page, 1.0, 1, 1, 0}), nullptr);
+
+    auto scaledTile = std::make_shared<Tile>(2, 0, 0, 1.0);
+    EXPECT_EQ(scaledTile->getSize(), 4 * tile->getSize());
+    cache.cache({&page, 1.0, 2, 0, 0}, scaledTile);
+    EXPECT_EQ(cache.lookup({&page, 1.0, 2, 0, 0}), scaledTile);
+    EXPECT_EQ(cache.getTiles(&page).size(), 2U);
+    EXPECT_TRUE(cache.hasTiles(&page));
+    EXPECT_FALSE(cache.hasTiles(&otherPage));
+
+    size_t size = cache.getSize();
+    cache.evict(&page);
+    EXPECT_FALSE(cache.hasTiles(&page));
+    EXPECT_EQ(cache.getSize(), size - tile->getSize() - scaledTile->getSize());
+}
+
+TEST(TileCache, testLeastRecentlyUsedEviction) {
+    auto& cache = TileCache::instance();
+    int page = 0;
+    const TileCache::Key first{&page, 1.0, 1, 0, 0};
+    const TileCache::Key second{&page, 1.0, 1, 1, 0};
+    const TileCache::Key third{&page, 1.0, 1, 2, 0};
+
+    auto tile = std::make_shared<Tile>(1, 0, 0, 1.0);
+    cache.setMaxSize(2 * tile->getSize());
+    cache.cache(first, tile);
+    cache.cache(second, std::make_shared<Tile>(1, 1, 0, 1.0));
+
+    // The second tile is now the least recently used one
+    EXPECT_EQ(cache.lookup(first), tile);
+    cache.cache(third, std::make_shared<Tile>(1, 2, 0, 1.0));
+    EXPECT_EQ(cache.lookup(first), tile);
+    EXPECT_EQ(cache.lookup(second), nullptr);
+    EXPECT_NE(cache.lookup(third), nullptr);
+    EXPECT_EQ(cache.getSize(), 2 * tile->getSize());
+
+    // A tile is kept even if it exceeds the budget on its own
+    cache.setMaxSize(0);
+    EXPECT_EQ(cache.getSize(), 0U);
+    cache.cache(first, tile);
+    EXPECT_EQ(cache.lookup(first), tile);
+
+    cache.setMaxSize(256 * 1024 * 1024);
+    cache.evict(&page);
+    EXPECT_EQ(cache.getSize(), 0U);
+}
+
+TEST(TileCache, testStaleAndDraftTiles) {
+    auto& cache = TileCache::instance();
+    int page = 0;
+    const TileCache::Key key{&page, 1.0, 1, 0, 0};
+
+    auto draft = std::make_shared<Tile>(1, 0, 0, 1.0);
+    EXPECT_FALSE(draft->stale);
+    EXPECT_FALSE(draft->draft);
+    draft->draft = true;
+    cache.cache(key, draft);
+
+    // The flags belong to the cached tile, until it is replaced by a rendered one
+    cache.lookup(key)->stale = true;
+    EXPECT_TRUE(draft->stale);
+    EXPECT_TRUE(cache.lookup(key)->draft);
+
+    auto rendered = std::make_shared<Tile>(1, 0, 0, 1.0);
+    cache.cache(key, rendered);
+    auto tile = cache.lookup(key);
+    EXPECT_EQ(tile, rendered);
+    EXPECT_FALSE(tile->stale);
+    EXPECT_FALSE(tile->draft);
+    EXPECT_EQ(cache.getTiles(&page).size(), 1U);
+    EXPECT_EQ(cache.getSize(), rendered->getSize());
+
+    cache.evict(&page);
+}